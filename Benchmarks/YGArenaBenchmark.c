@@ -0,0 +1,68 @@
+/**
+ * Builds, lays out and frees the same tree with heap allocated nodes and with a YGArena.
+ *
+ * usage: YGArenaBenchmark [cells] [iterations]
+ */
+
+#include "YGBenchmark.h"
+
+typedef struct YGArenaBenchmarkResult {
+  double build;
+  double layout;
+  double free;
+} YGArenaBenchmarkResult;
+
+static YGArenaBenchmarkResult YGRun(const YGConfigRef config, const int cells,
+                                    const int iterations, const bool useArena,
+                                    uint64_t *const hash) {
+  YGArenaBenchmarkResult result = {0, 0, 0};
+  for (int i = 0; i < iterations; i++) {
+    uint64_t start = YGBenchmarkNow();
+    gYGBenchmarkArena = useArena ? YGArenaNew((uint32_t)cells * 9 + 1) : NULL;
+    const YGNodeRef root = YGBenchmarkNewFeed(config, cells);
+    result.build += YGBenchmarkNow() - start;
+
+    start = YGBenchmarkNow();
+    YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+    result.layout += YGBenchmarkNow() - start;
+    *hash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+
+    start = YGBenchmarkNow();
+    if (useArena) {
+      YGArenaFree(gYGBenchmarkArena);
+      gYGBenchmarkArena = NULL;
+    } else {
+      YGNodeFreeRecursive(root);
+    }
+    result.free += YGBenchmarkNow() - start;
+  }
+  result.build /= iterations;
+  result.layout /= iterations;
+  result.free /= iterations;
+  return result;
+}
+
+static void YGPrint(const char *label, const YGArenaBenchmarkResult result, const int nodes) {
+  printf("%-6s build %8.1f ns/node   layout %8.1f ns/node   free %8.1f ns/node\n", label,
+         result.build / nodes, result.layout / nodes, result.free / nodes);
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 250;
+  const int iterations = argc > 2 ? atoi(argv[2]) : 200;
+  const int nodes = cells * 9 + 1;
+  const YGConfigRef config = YGConfigNew();
+  printf("%d nodes, %d iterations\n", nodes, iterations);
+
+  uint64_t heapHash;
+  uint64_t arenaHash;
+  YGPrint("heap", YGRun(config, cells, iterations, false, &heapHash), nodes);
+  YGPrint("arena", YGRun(config, cells, iterations, true, &arenaHash), nodes);
+
+  YGConfigFree(config);
+  if (heapHash != arenaHash || YGNodeGetInstanceCount() != 0) {
+    printf("arena layout differs from heap layout or leaks nodes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * Re-measures a feed, which nests rows in columns, and a wrapping tag cloud every pass, to compare
+ * the generic layout core with the copies specialised for rows and columns. Run it once as is and
+ * once with the specialised copies compiled in:
+ *
+ *   ./bench_yoga.sh YGAxisSpecializationBenchmark
+ *   CFLAGS="-O2 -DNDEBUG -DYG_SPECIALIZE_AXES" ./bench_yoga.sh YGAxisSpecializationBenchmark
+ *
+ * Both builds must print the same layout hashes.
+ *
+ * usage: YGAxisSpecializationBenchmark [cells] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static void YGRun(const char *label, const YGNodeRef root, const int passes) {
+  uint64_t time = 0;
+  for (int i = 0; i < passes; i++) {
+    YGBenchmarkDirtyMeasuredNodes(root);
+    time += YGNodeCalculateLayout(root, i % 2 ? 375 : 414, YGUndefined, YGDirectionLTR).time;
+  }
+  printf("%-10s %8d %10.1f  %016llx\n", label, YGBenchmarkCountNodes(root),
+         (double)time / passes / YGBenchmarkCountNodes(root),
+         (unsigned long long)YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED));
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 250;
+  const int passes = argc > 2 ? atoi(argv[2]) : 200;
+  if (cells < 1 || passes < 1) {
+    printf("usage: YGAxisSpecializationBenchmark [cells >= 1] [passes >= 1]\n");
+    return 1;
+  }
+#ifdef YG_SPECIALIZE_AXES
+  printf("specialised rows and columns, %d passes\n", passes);
+#else
+  printf("generic layout core, %d passes\n", passes);
+#endif
+  printf("%-10s %8s %10s  %s\n", "tree", "nodes", "ns/node", "layout hash");
+
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef feed = YGBenchmarkNewFeed(config, cells);
+  const YGNodeRef tagCloud = YGBenchmarkNewTagCloud(config, cells * 4);
+  YGRun("feed", feed, passes);
+  YGRun("tag cloud", tagCloud, passes);
+
+  YGNodeFreeRecursive(feed);
+  YGNodeFreeRecursive(tagCloud);
+  YGConfigFree(config);
+  if (YGNodeGetInstanceCount() != 0) {
+    printf("the benchmark leaked nodes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * Lays out wide wrapping rows of baseline aligned items, as in chat bubbles or form rows mixing
+ * font sizes, and edits the text of one item at a time.
+ *
+ * Every row mixes labels with a custom baseline function and cards whose baseline comes from a
+ * label at the end of a chain of first children. The benchmark reports the time and the baseline
+ * function calls of a cold pass, of a pass at a new width and of a pass after a single edit, and
+ * checks that the edited tree is laid out exactly like a fresh tree with the same text.
+ *
+ * Asking a label for its baseline means asking the text engine for font metrics, so every call
+ * of the baseline function also waits for a fixed time, 200 nanoseconds by default.
+ *
+ * usage: YGBaselineBenchmark [rows] [items per row] [edits] [baseline cost in ns]
+ */
+
+#include "YGBenchmark.h"
+
+#define YG_CARD_DEPTH 3
+
+static uint64_t gBaselineCost;
+static uint64_t gBaselineCalls;
+
+static float YGLabelBaseline(YGNodeRef node, const float width, const float height) {
+  (void)node;
+  (void)width;
+  const uint64_t start = YGBenchmarkNow();
+  while (YGBenchmarkNow() - start < gBaselineCost) {
+  }
+  gBaselineCalls++;
+  return fminf(height, YG_BENCHMARK_LINE_HEIGHT * 0.8f);
+}
+
+static YGNodeRef YGNewLabel(const YGConfigRef config, const int length) {
+  const YGNodeRef label = YGBenchmarkNewText(config, length);
+  YGNodeSetBaselineFunc(label, YGLabelBaseline);
+  return label;
+}
+
+/// A card nesting |YG_CARD_DEPTH| padded columns, each starting with the next one and followed
+/// by a label. The innermost column holds a single label.
+static YGNodeRef YGNewCard(const YGConfigRef config, const int length) {
+  const YGNodeRef card = YGBenchmarkNewNode(config);
+  YGNodeRef column = card;
+  for (int depth = 0; depth < YG_CARD_DEPTH; depth++) {
+    YGNodeStyleSetPadding(column, YGEdgeAll, 4);
+    const YGNodeRef inner = YGBenchmarkNewNode(config);
+    YGNodeInsertChild(column, inner, 0);
+    YGNodeInsertChild(column, YGNewLabel(config, 8 + depth * 5), 1);
+    column = inner;
+  }
+  YGNodeInsertChild(column, YGNewLabel(config, length), 0);
+  return card;
+}
+
+static YGNodeRef YGNewRows(const YGConfigRef config, const int rows, const int items) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  for (int i = 0; i < rows; i++) {
+    const YGNodeRef row = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetFlexWrap(row, YGWrapWrap);
+    YGNodeStyleSetAlignItems(row, YGAlignBaseline);
+    YGNodeStyleSetPadding(row, YGEdgeAll, 8);
+    for (int j = 0; j < items; j++) {
+      const int length = 4 + (i * 7 + j * 13) % 24;
+      YGNodeInsertChild(row, j % 2 ? YGNewCard(config, length) : YGNewLabel(config, length),
+                        (uint32_t)j);
+    }
+    YGNodeInsertChild(root, row, (uint32_t)i);
+  }
+  return root;
+}
+
+/// The label whose text the |index|th edit changes: the first label of an item of a row.
+static YGNodeRef YGEditedLabel(const YGNodeRef root, const int index, const int items) {
+  const YGNodeRef row = YGNodeGetChild(root, (uint32_t)index % YGNodeGetChildCount(root));
+  YGNodeRef node = YGNodeGetChild(row, (uint32_t)(index * 5) % (uint32_t)items);
+  while (YGNodeGetChildCount(node) > 0) {
+    node = YGNodeGetChild(node, 0);
+  }
+  return node;
+}
+
+static void YGSetLength(const YGNodeRef label, const int length) {
+  YGNodeSetContext(label, (void *)(intptr_t)length);
+  YGNodeMarkDirty(label);
+}
+
+typedef struct YGPassStats {
+  uint64_t time;
+  uint64_t baselineCalls;
+} YGPassStats;
+
+static YGPassStats YGPass(const YGNodeRef root, const float width) {
+  gBaselineCalls = 0;
+  const YGLayoutStats stats = YGNodeCalculateLayout(root, width, YGUndefined, YGDirectionLTR);
+  return (YGPassStats){stats.time, gBaselineCalls};
+}
+
+static void YGPrint(const char *label, const YGPassStats stats, const int passes,
+                    const int nodes) {
+  printf("%-8s %12.1f %16.1f\n", label, (double)stats.time / passes / nodes,
+         (double)stats.baselineCalls / passes);
+}
+
+int main(int argc, char *argv[]) {
+  const int rows = argc > 1 ? atoi(argv[1]) : 40;
+  const int items = argc > 2 ? atoi(argv[2]) : 40;
+  const int edits = argc > 3 ? atoi(argv[3]) : 200;
+  gBaselineCost = argc > 4 ? strtoull(argv[4], NULL, 10) : 200;
+  if (rows < 1 || items < 1 || edits < 1) {
+    printf("usage: YGBaselineBenchmark [rows >= 1] [items >= 1] [edits >= 1] [baseline cost]\n");
+    return 1;
+  }
+
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 0);
+  const YGNodeRef root = YGNewRows(config, rows, items);
+  const int nodes = YGBenchmarkCountNodes(root);
+  printf("%d rows of %d items, %d nodes, %llu ns per baseline call\n", rows, items, nodes,
+         (unsigned long long)gBaselineCost);
+  printf("%-8s %12s %16s\n", "pass", "ns/node", "baselines/pass");
+
+  YGPrint("cold", YGPass(root, 1024), 1, nodes);
+  YGPrint("resize", YGPass(root, 768), 1, nodes);
+
+  YGPassStats edited = {0, 0};
+  for (int i = 0; i < edits; i++) {
+    YGSetLength(YGEditedLabel(root, i, items), 4 + (i * 11) % 40);
+    const YGPassStats pass = YGPass(root, 768);
+    edited.time += pass.time;
+    edited.baselineCalls += pass.baselineCalls;
+  }
+  YGPrint("edit", edited, edits, nodes);
+
+  const YGNodeRef fresh = YGNewRows(config, rows, items);
+  for (int i = 0; i < edits; i++) {
+    YGSetLength(YGEditedLabel(fresh, i, items), 4 + (i * 11) % 40);
+  }
+  YGNodeCalculateLayout(fresh, 768, YGUndefined, YGDirectionLTR);
+  const uint64_t hash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+  const uint64_t freshHash = YGBenchmarkLayoutHash(fresh, YG_BENCHMARK_HASH_SEED);
+  printf("layout hash %016llx\n", (unsigned long long)hash);
+
+  YGNodeFreeRecursive(fresh);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+  if (hash != freshHash || YGNodeGetInstanceCount() != 0) {
+    printf("edited rows are laid out differently from fresh rows or leak nodes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * Precomputes the sizes of the cells of a long list: lays out many small independent roots one
+ * YGNodeCalculateLayout call at a time, then all at once with YGNodeCalculateLayoutBatch, which
+ * spreads them over the worker threads of the parallel layout pool. Every pass re-measures all
+ * the cells. Both ways must size and lay out every cell identically.
+ *
+ * usage: YGBatchLayoutBenchmark [cells] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static void YGDirtyRoots(const YGNodeRef *roots, const int count) {
+  for (int i = 0; i < count; i++) {
+    YGBenchmarkDirtyMeasuredNodes(roots[i]);
+  }
+}
+
+static uint64_t YGHashRoots(const YGNodeRef *roots, const int count) {
+  uint64_t hash = YG_BENCHMARK_HASH_SEED;
+  for (int i = 0; i < count; i++) {
+    hash = YGBenchmarkLayoutHash(roots[i], hash);
+  }
+  return hash;
+}
+
+int main(int argc, char *argv[]) {
+  const int count = argc > 1 ? atoi(argv[1]) : 10000;
+  const int passes = argc > 2 ? atoi(argv[2]) : 10;
+  if (count < 1 || passes < 1) {
+    printf("usage: YGBatchLayoutBenchmark [cells >= 1] [passes >= 1]\n");
+    return 1;
+  }
+
+  const YGConfigRef config = YGConfigNew();
+  YGNodeRef *const roots = malloc(sizeof(YGNodeRef) * count);
+  YGLayoutConstraints *const constraints = malloc(sizeof(YGLayoutConstraints) * count);
+  YGSize *const sizes = malloc(sizeof(YGSize) * count);
+  YGSize *const expectedSizes = malloc(sizeof(YGSize) * count);
+  for (int i = 0; i < count; i++) {
+    roots[i] = YGBenchmarkNewFeed(config, 1);
+    const YGNodeRef content = YGNodeGetChild(YGNodeGetChild(roots[i], 0), 1);
+    YGNodeSetContext(YGNodeGetChild(content, 1), (void *)(intptr_t)(20 + (i * 37) % 400));
+    constraints[i] = (YGLayoutConstraints){
+        .availableWidth = i % 2 ? 375 : 320,
+        .availableHeight = YGUndefined,
+        .direction = YGDirectionLTR,
+    };
+  }
+  printf("%d cells of %d nodes, %d passes, %d cores\n", count, YGBenchmarkCountNodes(roots[0]),
+         passes, YGBenchmarkCoreCount());
+
+  uint64_t serialTime = 0;
+  for (int pass = 0; pass < passes; pass++) {
+    YGDirtyRoots(roots, count);
+    const uint64_t start = YGBenchmarkNow();
+    for (int i = 0; i < count; i++) {
+      YGNodeCalculateLayout(roots[i], constraints[i].availableWidth,
+                            constraints[i].availableHeight, constraints[i].direction);
+      expectedSizes[i] = (YGSize){YGNodeLayoutGetWidth(roots[i]), YGNodeLayoutGetHeight(roots[i])};
+    }
+    serialTime += YGBenchmarkNow() - start;
+  }
+  const uint64_t expectedHash = YGHashRoots(roots, count);
+
+  uint64_t batchTime = 0;
+  for (int pass = 0; pass < passes; pass++) {
+    YGDirtyRoots(roots, count);
+    batchTime += YGNodeCalculateLayoutBatch(roots, constraints, sizes, (uint32_t)count).time;
+  }
+  const uint64_t hash = YGHashRoots(roots, count);
+
+  printf("%-8s %10.1f us/pass\n", "serial", serialTime / 1000.0 / passes);
+  printf("%-8s %10.1f us/pass   %.2fx\n", "batch", batchTime / 1000.0 / passes,
+         (double)serialTime / batchTime);
+
+  const bool sizesMatch = memcmp(sizes, expectedSizes, sizeof(YGSize) * count) == 0;
+  for (int i = 0; i < count; i++) {
+    YGNodeFreeRecursive(roots[i]);
+  }
+  free(roots);
+  free(constraints);
+  free(sizes);
+  free(expectedSizes);
+  YGConfigFree(config);
+  if (!sizesMatch || hash != expectedHash || YGNodeGetInstanceCount() != 0) {
+    printf("batch layout differs from serial layout or leaks nodes\n");
+    return 1;
+  }
+  return 0;
+}
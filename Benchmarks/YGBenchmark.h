@@ -0,0 +1,334 @@
+/**
+ * Helpers shared by the Yoga benchmarks.
+ *
+ * The benchmarks only depend on Yoga.c and libc/pthreads, so they build and run on Linux and
+ * macOS without UIKit. See bench_yoga.sh in the repository root.
+ */
+
+#ifndef YGBenchmark_h
+#define YGBenchmark_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Yoga.h"
+
+// Timing
+
+/// Monotonic clock in nanoseconds.
+static inline uint64_t YGBenchmarkNow(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/// Number of online cores, used as the default upper bound for thread sweeps.
+static inline int YGBenchmarkCoreCount(void) {
+  const long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (int)count : 1;
+}
+
+// Node allocation
+
+/// When set, the tree builders below allocate their nodes from this arena.
+static YGArenaRef gYGBenchmarkArena = NULL;
+
+static inline YGNodeRef YGBenchmarkNewNode(const YGConfigRef config) {
+  return gYGBenchmarkArena != NULL ? YGNodeNewInArena(gYGBenchmarkArena, config)
+                                   : YGNodeNewWithConfig(config);
+}
+
+// Allocation accounting
+
+/// Totals of every allocation Yoga made through the functions installed by
+/// YGBenchmarkTrackAllocations. Not thread safe: only track single-threaded runs.
+typedef struct YGBenchmarkAllocations {
+  uint64_t count;
+  int64_t liveBytes;
+  int64_t peakBytes;
+} YGBenchmarkAllocations;
+
+static YGBenchmarkAllocations gYGBenchmarkAllocations;
+
+// Every block starts with a header holding its size, so frees can be accounted.
+#define YG_BENCHMARK_ALLOCATION_HEADER 16
+
+static void *YGBenchmarkTrackBlock(char *const block, const size_t size) {
+  if (block == NULL) {
+    return NULL;
+  }
+  memcpy(block, &size, sizeof(size));
+  gYGBenchmarkAllocations.count++;
+  gYGBenchmarkAllocations.liveBytes += (int64_t)size;
+  if (gYGBenchmarkAllocations.liveBytes > gYGBenchmarkAllocations.peakBytes) {
+    gYGBenchmarkAllocations.peakBytes = gYGBenchmarkAllocations.liveBytes;
+  }
+  return block + YG_BENCHMARK_ALLOCATION_HEADER;
+}
+
+static size_t YGBenchmarkUntrackBlock(void *const pointer) {
+  size_t size;
+  memcpy(&size, (char *)pointer - YG_BENCHMARK_ALLOCATION_HEADER, sizeof(size));
+  gYGBenchmarkAllocations.liveBytes -= (int64_t)size;
+  return size;
+}
+
+static void *YGBenchmarkMalloc(size_t size) {
+  return YGBenchmarkTrackBlock(malloc(YG_BENCHMARK_ALLOCATION_HEADER + size), size);
+}
+
+static void *YGBenchmarkCalloc(size_t count, size_t size) {
+  void *const pointer = YGBenchmarkMalloc(count * size);
+  if (pointer != NULL) {
+    memset(pointer, 0, count * size);
+  }
+  return pointer;
+}
+
+static void *YGBenchmarkRealloc(void *pointer, size_t size) {
+  if (pointer == NULL) {
+    return YGBenchmarkMalloc(size);
+  }
+  const size_t oldSize = YGBenchmarkUntrackBlock(pointer);
+  char *const block = realloc((char *)pointer - YG_BENCHMARK_ALLOCATION_HEADER,
+                              YG_BENCHMARK_ALLOCATION_HEADER + size);
+  if (block == NULL) {
+    gYGBenchmarkAllocations.liveBytes += (int64_t)oldSize;
+    return NULL;
+  }
+  return YGBenchmarkTrackBlock(block, size);
+}
+
+static void YGBenchmarkFree(void *pointer) {
+  if (pointer != NULL) {
+    YGBenchmarkUntrackBlock(pointer);
+    free((char *)pointer - YG_BENCHMARK_ALLOCATION_HEADER);
+  }
+}
+
+/// Routes Yoga's allocations through the counters above. Must be called before any config or
+/// node is created.
+static inline void YGBenchmarkTrackAllocations(void) {
+  YGSetMemoryFuncs(YGBenchmarkMalloc, YGBenchmarkCalloc, YGBenchmarkRealloc, YGBenchmarkFree);
+}
+
+// Text-like measurement
+
+// Leaves built by the helpers below store the number of characters of their "text" in the node
+// context. The measure function wraps the text at the available width like a label would.
+#define YG_BENCHMARK_CHAR_WIDTH 7.5f
+#define YG_BENCHMARK_LINE_HEIGHT 17.0f
+
+static YGSize YGBenchmarkMeasureText(YGNodeRef node, float width, YGMeasureMode widthMode,
+                                     float height, YGMeasureMode heightMode) {
+  const float length = (float)(intptr_t)YGNodeGetContext(node);
+  float measuredWidth = length * YG_BENCHMARK_CHAR_WIDTH;
+  float lines = 1;
+  if (widthMode != YGMeasureModeUndefined && measuredWidth > width && width > 0) {
+    lines = (float)(int)(measuredWidth / width) + 1;
+    measuredWidth = width;
+  }
+  float measuredHeight = lines * YG_BENCHMARK_LINE_HEIGHT;
+  if (widthMode == YGMeasureModeExactly) {
+    measuredWidth = width;
+  }
+  if (heightMode == YGMeasureModeExactly ||
+      (heightMode == YGMeasureModeAtMost && measuredHeight > height)) {
+    measuredHeight = height;
+  }
+  return (YGSize){.width = measuredWidth, .height = measuredHeight};
+}
+
+static inline YGNodeRef YGBenchmarkNewText(const YGConfigRef config, const int length) {
+  const YGNodeRef node = YGBenchmarkNewNode(config);
+  YGNodeSetContext(node, (void *)(intptr_t)length);
+  YGNodeSetMeasureFunc(node, YGBenchmarkMeasureText);
+  return node;
+}
+
+// Trees
+
+/// A feed of cells: avatar, title, wrapping body and a row of action buttons.
+/// Every cell adds 9 nodes to the tree.
+static inline YGNodeRef YGBenchmarkNewFeed(const YGConfigRef config, const int cellCount) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionColumn);
+  for (int i = 0; i < cellCount; i++) {
+    const YGNodeRef cell = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexDirection(cell, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(cell, YGEdgeAll, 12);
+    YGNodeStyleSetAlignItems(cell, YGAlignFlexStart);
+
+    const YGNodeRef avatar = YGBenchmarkNewNode(config);
+    YGNodeStyleSetWidth(avatar, 40);
+    YGNodeStyleSetHeight(avatar, 40);
+    YGNodeStyleSetMargin(avatar, YGEdgeRight, 8);
+    YGNodeInsertChild(cell, avatar, 0);
+
+    const YGNodeRef content = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexGrow(content, 1);
+    YGNodeStyleSetFlexShrink(content, 1);
+    YGNodeInsertChild(content, YGBenchmarkNewText(config, 8 + i % 24), 0);
+    YGNodeInsertChild(content, YGBenchmarkNewText(config, 40 + (i * 37) % 200), 1);
+
+    const YGNodeRef actions = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexDirection(actions, YGFlexDirectionRow);
+    YGNodeStyleSetJustifyContent(actions, YGJustifySpaceBetween);
+    YGNodeStyleSetMargin(actions, YGEdgeTop, 6);
+    for (int j = 0; j < 3; j++) {
+      YGNodeInsertChild(actions, YGBenchmarkNewText(config, 4 + j), j);
+    }
+    YGNodeInsertChild(content, actions, 2);
+    YGNodeInsertChild(cell, content, 1);
+    YGNodeInsertChild(root, cell, i);
+  }
+  return root;
+}
+
+/// A single chain of |depth| containers alternating between rows and columns, ending in a text
+/// leaf.
+static inline YGNodeRef YGBenchmarkNewChain(const YGConfigRef config, const int depth) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  YGNodeRef parent = root;
+  for (int i = 1; i < depth - 1; i++) {
+    const YGNodeRef node = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexDirection(node, i % 2 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+    YGNodeStyleSetPadding(node, YGEdgeLeft, 1);
+    YGNodeInsertChild(parent, node, 0);
+    parent = node;
+  }
+  YGNodeInsertChild(parent, YGBenchmarkNewText(config, 20), 0);
+  return root;
+}
+
+/// One row of |count| fixed-size items that shrink to fit.
+static inline YGNodeRef YGBenchmarkNewRow(const YGConfigRef config, const int count) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  for (int i = 0; i < count; i++) {
+    const YGNodeRef item = YGBenchmarkNewNode(config);
+    YGNodeStyleSetWidth(item, 40 + i % 7);
+    YGNodeStyleSetHeight(item, 40);
+    YGNodeStyleSetFlexShrink(item, 1);
+    YGNodeStyleSetMargin(item, YGEdgeHorizontal, 2);
+    YGNodeInsertChild(root, item, (uint32_t)i);
+  }
+  return root;
+}
+
+/// A wrapping row of |count| text tags of varying length, as in a tag cloud.
+static inline YGNodeRef YGBenchmarkNewTagCloud(const YGConfigRef config, const int count) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(root, YGWrapWrap);
+  YGNodeStyleSetAlignContent(root, YGAlignFlexStart);
+  for (int i = 0; i < count; i++) {
+    const YGNodeRef tag = YGBenchmarkNewText(config, 3 + (i * 5) % 11);
+    YGNodeStyleSetPadding(tag, YGEdgeHorizontal, 6);
+    YGNodeStyleSetMargin(tag, YGEdgeAll, 3);
+    YGNodeInsertChild(root, tag, (uint32_t)i);
+  }
+  return root;
+}
+
+/// Stacks nested |depth| levels deep, alternating columns and rows of |fanout| children, with
+/// a title and a wrapping text at every level. Text leaves stop the recursion.
+static inline YGNodeRef YGBenchmarkNewNestedStack(const YGConfigRef config, const int depth,
+                                                  const int fanout) {
+  const YGNodeRef stack = YGBenchmarkNewNode(config);
+  YGNodeStyleSetFlexDirection(stack, depth % 2 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+  YGNodeStyleSetPadding(stack, YGEdgeAll, 4);
+  YGNodeInsertChild(stack, YGBenchmarkNewText(config, 6 + depth), 0);
+  const YGNodeRef body = YGBenchmarkNewText(config, 30 + depth * 11);
+  YGNodeStyleSetFlexShrink(body, 1);
+  YGNodeInsertChild(stack, body, 1);
+  if (depth > 1) {
+    for (int i = 0; i < fanout; i++) {
+      const YGNodeRef child = YGBenchmarkNewNestedStack(config, depth - 1, fanout);
+      YGNodeStyleSetFlexShrink(child, 1);
+      YGNodeInsertChild(stack, child, (uint32_t)i + 2);
+    }
+  }
+  return stack;
+}
+
+/// A column of |count| cards, each covered by absolutely positioned badges and a dimming overlay.
+/// Every card adds 5 nodes to the tree.
+static inline YGNodeRef YGBenchmarkNewOverlays(const YGConfigRef config, const int count) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  for (int i = 0; i < count; i++) {
+    const YGNodeRef card = YGBenchmarkNewNode(config);
+    YGNodeStyleSetPadding(card, YGEdgeAll, 8);
+    YGNodeInsertChild(card, YGBenchmarkNewText(config, 20 + i % 40), 0);
+
+    const YGNodeRef overlay = YGBenchmarkNewNode(config);
+    YGNodeStyleSetPositionType(overlay, YGPositionTypeAbsolute);
+    YGNodeStyleSetPosition(overlay, YGEdgeAll, 0);
+    YGNodeInsertChild(card, overlay, 1);
+
+    for (int j = 0; j < 2; j++) {
+      const YGNodeRef badge = YGBenchmarkNewText(config, 2 + j);
+      YGNodeStyleSetPositionType(badge, YGPositionTypeAbsolute);
+      YGNodeStyleSetPosition(badge, YGEdgeTop, 4);
+      YGNodeStyleSetPosition(badge, j ? YGEdgeRight : YGEdgeLeft, 4);
+      YGNodeStyleSetWidthPercent(badge, 25);
+      YGNodeInsertChild(card, badge, (uint32_t)j + 2);
+    }
+    YGNodeInsertChild(root, card, (uint32_t)i);
+  }
+  return root;
+}
+
+static inline int YGBenchmarkCountNodes(const YGNodeRef node) {
+  int count = 1;
+  const uint32_t childCount = YGNodeGetChildCount(node);
+  for (uint32_t i = 0; i < childCount; i++) {
+    count += YGBenchmarkCountNodes(YGNodeGetChild(node, i));
+  }
+  return count;
+}
+
+/// Marks every node with a measure function dirty, so the next pass re-measures the whole tree.
+static inline void YGBenchmarkDirtyMeasuredNodes(const YGNodeRef node) {
+  if (YGNodeGetMeasureFunc(node) != NULL) {
+    YGNodeMarkDirty(node);
+  }
+  const uint32_t childCount = YGNodeGetChildCount(node);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGBenchmarkDirtyMeasuredNodes(YGNodeGetChild(node, i));
+  }
+}
+
+// Verification
+
+static inline uint64_t YGBenchmarkHashFloat(uint64_t hash, const float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 4; i++) {
+    hash ^= (bits >> (i * 8)) & 0xff;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+/// FNV-1a hash of the computed layout of the whole subtree. Two trees hash equal only if every
+/// frame is bit-for-bit identical.
+static inline uint64_t YGBenchmarkLayoutHash(const YGNodeRef node, uint64_t hash) {
+  hash = YGBenchmarkHashFloat(hash, YGNodeLayoutGetLeft(node));
+  hash = YGBenchmarkHashFloat(hash, YGNodeLayoutGetTop(node));
+  hash = YGBenchmarkHashFloat(hash, YGNodeLayoutGetWidth(node));
+  hash = YGBenchmarkHashFloat(hash, YGNodeLayoutGetHeight(node));
+  const uint32_t childCount = YGNodeGetChildCount(node);
+  for (uint32_t i = 0; i < childCount; i++) {
+    hash = YGBenchmarkLayoutHash(YGNodeGetChild(node, i), hash);
+  }
+  return hash;
+}
+
+#define YG_BENCHMARK_HASH_SEED 0xcbf29ce484222325ull
+
+#endif /* YGBenchmark_h */
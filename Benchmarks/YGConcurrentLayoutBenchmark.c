@@ -0,0 +1,132 @@
+/**
+ * Lays out independent trees on several threads at once.
+ *
+ * 1. Stress: every thread replays the same sequence of relayouts on its own tree and checks each
+ *    result against a single-threaded reference run. Any cross-talk between concurrent passes
+ *    shows up as a hash mismatch.
+ * 2. Scaling: runs the same amount of work per thread with 1...N threads and reports throughput
+ *    and speedup over the single-threaded run.
+ *
+ * usage: YGConcurrentLayoutBenchmark [max threads] [cells per tree] [passes per thread]
+ */
+
+#include <pthread.h>
+
+#include "YGBenchmark.h"
+
+static const float kWidths[] = {320, 375, 414, 768};
+#define YG_WIDTH_COUNT (sizeof(kWidths) / sizeof(kWidths[0]))
+
+typedef struct YGWorker {
+  YGNodeRef root;
+  int passes;
+  const uint64_t *expectedHashes;
+  int mismatches;
+} YGWorker;
+
+// Pass |i| of the replayed sequence. Every third pass re-measures all text, the others only
+// change the available width.
+static uint64_t YGRunPass(const YGNodeRef root, const YGLayoutContextRef context, const int i) {
+  if (i % 3 == 0) {
+    YGBenchmarkDirtyMeasuredNodes(root);
+  }
+  YGNodeCalculateLayoutWithContext(root, kWidths[i % YG_WIDTH_COUNT], YGUndefined,
+                                   YGDirectionLTR, context);
+  return YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+}
+
+static void *YGStressWorker(void *arg) {
+  YGWorker *const worker = arg;
+  const YGLayoutContextRef context = YGLayoutContextNew();
+  for (int i = 0; i < worker->passes; i++) {
+    if (YGRunPass(worker->root, context, i) != worker->expectedHashes[i]) {
+      worker->mismatches++;
+    }
+  }
+  YGLayoutContextFree(context);
+  return NULL;
+}
+
+static void *YGScalingWorker(void *arg) {
+  YGWorker *const worker = arg;
+  const YGLayoutContextRef context = YGLayoutContextNew();
+  for (int i = 0; i < worker->passes; i++) {
+    YGBenchmarkDirtyMeasuredNodes(worker->root);
+    YGNodeCalculateLayoutWithContext(worker->root, kWidths[i % YG_WIDTH_COUNT], YGUndefined,
+                                     YGDirectionLTR, context);
+  }
+  YGLayoutContextFree(context);
+  return NULL;
+}
+
+// Runs |body| on |count| threads, each with its own freshly built tree. Returns the wall time in
+// nanoseconds, excluding tree construction.
+static uint64_t YGRunThreads(const YGConfigRef config, const int count, const int cells,
+                             const int passes, const uint64_t *expectedHashes,
+                             void *(*body)(void *), int *mismatches) {
+  YGWorker *const workers = calloc((size_t)count, sizeof(YGWorker));
+  pthread_t *const threads = calloc((size_t)count, sizeof(pthread_t));
+  for (int t = 0; t < count; t++) {
+    workers[t].root = YGBenchmarkNewFeed(config, cells);
+    workers[t].passes = passes;
+    workers[t].expectedHashes = expectedHashes;
+  }
+  const uint64_t start = YGBenchmarkNow();
+  for (int t = 0; t < count; t++) {
+    pthread_create(&threads[t], NULL, body, &workers[t]);
+  }
+  for (int t = 0; t < count; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  const uint64_t elapsed = YGBenchmarkNow() - start;
+  for (int t = 0; t < count; t++) {
+    *mismatches += workers[t].mismatches;
+    YGNodeFreeRecursive(workers[t].root);
+  }
+  free(threads);
+  free(workers);
+  return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+  const int maxThreads = argc > 1 ? atoi(argv[1]) : YGBenchmarkCoreCount();
+  const int cells = argc > 2 ? atoi(argv[2]) : 200;
+  const int passes = argc > 3 ? atoi(argv[3]) : 200;
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 2);
+
+  // Reference hashes from a single-threaded replay.
+  uint64_t *const expectedHashes = calloc((size_t)passes, sizeof(uint64_t));
+  const YGNodeRef reference = YGBenchmarkNewFeed(config, cells);
+  for (int i = 0; i < passes; i++) {
+    expectedHashes[i] = YGRunPass(reference, NULL, i);
+  }
+  YGNodeFreeRecursive(reference);
+
+  const int stressThreads = maxThreads < 4 ? 4 : maxThreads * 2;
+  int mismatches = 0;
+  YGRunThreads(config, stressThreads, cells, passes, expectedHashes, YGStressWorker,
+               &mismatches);
+  printf("stress: %d threads x %d passes, %d mismatching layouts\n", stressThreads, passes,
+         mismatches);
+  if (mismatches > 0) {
+    return 1;
+  }
+
+  printf("%8s %14s %10s %11s\n", "threads", "passes/s", "speedup", "efficiency");
+  double baseline = 0;
+  for (int count = 1; count <= maxThreads; count++) {
+    const uint64_t elapsed =
+        YGRunThreads(config, count, cells, passes, NULL, YGScalingWorker, &mismatches);
+    const double throughput = (double)count * passes * 1e9 / (double)elapsed;
+    if (count == 1) {
+      baseline = throughput;
+    }
+    printf("%8d %14.1f %9.2fx %10.0f%%\n", count, throughput, throughput / baseline,
+           100.0 * throughput / baseline / count);
+  }
+
+  free(expectedHashes);
+  YGConfigFree(config);
+  return YGNodeGetInstanceCount() == 0 ? 0 : 1;
+}
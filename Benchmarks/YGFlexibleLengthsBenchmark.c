@@ -0,0 +1,101 @@
+/**
+ * Lays out rows of flex items where every other item is clamped by a min and a max width, at a
+ * width where the items grow and at one where they shrink, so that resolving the flexible lengths
+ * freezes many items of every line. The rows are laid out with the default two-pass resolution and
+ * with YGExperimentalFeatureSpecFlexibleLengths, which follows the loop of the flexbox spec.
+ *
+ * Half of the items are not clamped, so the spec resolution must fill every row exactly. The
+ * default resolution may leave some space unfilled, which the benchmark prints per pass.
+ *
+ * usage: YGFlexibleLengthsBenchmark [items per row] [rows] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static YGNodeRef YGNewRows(const YGConfigRef config, const int items, const int rows) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  for (int i = 0; i < rows; i++) {
+    const YGNodeRef row = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetHeight(row, 20);
+    for (int j = 0; j < items; j++) {
+      const YGNodeRef item = YGBenchmarkNewNode(config);
+      YGNodeStyleSetFlexBasis(item, 20 + (i * 7 + j * 13) % 40);
+      YGNodeStyleSetFlexGrow(item, 1 + j % 3);
+      YGNodeStyleSetFlexShrink(item, 1 + j % 2);
+      if (j % 2 == 0) {
+        YGNodeStyleSetMinWidth(item, 15 + (j * 5) % 20);
+        YGNodeStyleSetMaxWidth(item, 45 + (j * 11) % 30);
+      }
+      YGNodeInsertChild(row, item, (uint32_t)j);
+    }
+    YGNodeInsertChild(root, row, (uint32_t)i);
+  }
+  return root;
+}
+
+// Space left unfilled, or overflowed, by the items of every row.
+static float YGUnfilledSpace(const YGNodeRef root) {
+  float unfilled = 0;
+  for (uint32_t i = 0; i < YGNodeGetChildCount(root); i++) {
+    const YGNodeRef row = YGNodeGetChild(root, i);
+    float width = 0;
+    for (uint32_t j = 0; j < YGNodeGetChildCount(row); j++) {
+      width += YGNodeLayoutGetWidth(YGNodeGetChild(row, j));
+    }
+    unfilled += fabsf(YGNodeLayoutGetWidth(row) - width);
+  }
+  return unfilled;
+}
+
+static void YGRun(const char *variant, const char *sizing, const YGNodeRef root, const float width,
+                  const int passes, float *const unfilled) {
+  uint64_t time = 0;
+  for (int i = 0; i < passes; i++) {
+    // Alternate between two close widths so that every pass lays out every row.
+    time += YGNodeCalculateLayout(root, width + i % 2, YGUndefined, YGDirectionLTR).time;
+  }
+  *unfilled = YGUnfilledSpace(root);
+  printf("%-8s %-6s %10.1f us/pass %10.1f unfilled  %016llx\n", variant, sizing,
+         time / 1000.0 / passes, *unfilled,
+         (unsigned long long)YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED));
+}
+
+int main(int argc, char *argv[]) {
+  const int items = argc > 1 ? atoi(argv[1]) : 1000;
+  const int rows = argc > 2 ? atoi(argv[2]) : 8;
+  const int passes = argc > 3 ? atoi(argv[3]) : 100;
+  if (items < 1 || rows < 1 || passes < 1) {
+    printf("usage: YGFlexibleLengthsBenchmark [items >= 1] [rows >= 1] [passes >= 1]\n");
+    return 1;
+  }
+  printf("%d rows of %d items, %d passes\n", rows, items, passes);
+
+  const YGConfigRef legacyConfig = YGConfigNew();
+  const YGConfigRef specConfig = YGConfigNew();
+  YGConfigSetExperimentalFeatureEnabled(specConfig, YGExperimentalFeatureSpecFlexibleLengths,
+                                        true);
+  const YGNodeRef legacyRows = YGNewRows(legacyConfig, items, rows);
+  const YGNodeRef specRows = YGNewRows(specConfig, items, rows);
+
+  bool isSpecFilled = true;
+  const char *const sizings[] = {"grow", "shrink"};
+  const float widths[] = {items * 60.0f, items * 20.0f};
+  for (int i = 0; i < 2; i++) {
+    float unfilled;
+    YGRun("two-pass", sizings[i], legacyRows, widths[i], passes, &unfilled);
+    YGRun("spec", sizings[i], specRows, widths[i], passes, &unfilled);
+    // Positions are floats, so the items of long rows drift by a fraction of a point each.
+    isSpecFilled &= unfilled < rows * (1 + items / 100.0f);
+  }
+
+  YGNodeFreeRecursive(legacyRows);
+  YGNodeFreeRecursive(specRows);
+  YGConfigFree(legacyConfig);
+  YGConfigFree(specConfig);
+  if (!isSpecFilled || YGNodeGetInstanceCount() != 0) {
+    printf("the spec resolution left rows unfilled or the benchmark leaked nodes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * Layout performance on synthetic trees: deep chains, a wide row, a wrapping tag cloud, nested
+ * stacks of text and cards covered by absolute overlays.
+ *
+ * Cold passes lay out a freshly built tree. Warm passes relayout the same tree at widths it was
+ * already laid out at, so measurements come from the caches. For both, the benchmark reports the
+ * time and the number of allocations per pass. Peak is the most memory Yoga held at once while a
+ * tree was built and laid out cold. The last column hashes the warm layout at a width of 375, so a
+ * layout change shows up as a different hash between two builds. The benchmark fails if the warm
+ * and cold layouts differ.
+ *
+ * Layouts are not rounded to the pixel grid: rounding is applied in place to the frames cached
+ * nodes keep, so warm and cold results may differ by a pixel. See YGPixelGridBenchmark for the cost
+ * of rounding.
+ *
+ * usage: YGLayoutBenchmark [nodes per tree] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static const float kWidths[] = {320, 375, 414, 768};
+#define YG_WIDTH_COUNT (sizeof(kWidths) / sizeof(kWidths[0]))
+static const float kHashWidth = 375;
+
+#define YG_CHAIN_DEPTH 32
+
+static YGNodeRef YGNewDeepChains(const YGConfigRef config, const int nodes) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  for (int i = 0; i < (nodes - 1) / YG_CHAIN_DEPTH; i++) {
+    YGNodeInsertChild(root, YGBenchmarkNewChain(config, YG_CHAIN_DEPTH), (uint32_t)i);
+  }
+  return root;
+}
+
+static YGNodeRef YGNewWideRow(const YGConfigRef config, const int nodes) {
+  return YGBenchmarkNewRow(config, nodes - 1);
+}
+
+static YGNodeRef YGNewTagCloud(const YGConfigRef config, const int nodes) {
+  return YGBenchmarkNewTagCloud(config, nodes - 1);
+}
+
+static YGNodeRef YGNewNestedStacks(const YGConfigRef config, const int nodes) {
+  // A stack of depth d has 3 * (3^d - 1) / 2 nodes with a fanout of 3.
+  int depth = 1;
+  for (int count = 3; count < nodes; count = count * 3 + 3) {
+    depth++;
+  }
+  return YGBenchmarkNewNestedStack(config, depth, 3);
+}
+
+static YGNodeRef YGNewOverlays(const YGConfigRef config, const int nodes) {
+  return YGBenchmarkNewOverlays(config, (nodes - 1) / 5);
+}
+
+typedef struct YGTree {
+  const char *name;
+  YGNodeRef (*build)(YGConfigRef config, int nodes);
+} YGTree;
+
+static const YGTree kTrees[] = {
+    {"deep chains", YGNewDeepChains},     {"wide row", YGNewWideRow},
+    {"tag cloud", YGNewTagCloud},         {"nested stacks", YGNewNestedStacks},
+    {"absolute overlays", YGNewOverlays},
+};
+#define YG_TREE_COUNT (sizeof(kTrees) / sizeof(kTrees[0]))
+
+typedef struct YGPassStats {
+  uint64_t time;
+  uint64_t allocations;
+} YGPassStats;
+
+static void YGLayoutPass(const YGNodeRef root, const float width, YGPassStats *const stats) {
+  const uint64_t allocations = gYGBenchmarkAllocations.count;
+  const uint64_t start = YGBenchmarkNow();
+  YGNodeCalculateLayout(root, width, YGUndefined, YGDirectionLTR);
+  stats->time += YGBenchmarkNow() - start;
+  stats->allocations += gYGBenchmarkAllocations.count - allocations;
+}
+
+static int YGRun(const YGTree *const tree, const YGConfigRef config, const int size,
+                 const int passes) {
+  YGPassStats cold = {0, 0};
+  int64_t peakBytes = 0;
+  int nodes = 0;
+  for (int i = 0; i < passes; i++) {
+    const int64_t liveBytes = gYGBenchmarkAllocations.liveBytes;
+    gYGBenchmarkAllocations.peakBytes = liveBytes;
+    const YGNodeRef root = tree->build(config, size);
+    YGLayoutPass(root, kWidths[i % YG_WIDTH_COUNT], &cold);
+    if (gYGBenchmarkAllocations.peakBytes - liveBytes > peakBytes) {
+      peakBytes = gYGBenchmarkAllocations.peakBytes - liveBytes;
+    }
+    nodes = YGBenchmarkCountNodes(root);
+    YGNodeFreeRecursive(root);
+  }
+
+  const YGNodeRef root = tree->build(config, size);
+  for (size_t i = 0; i < YG_WIDTH_COUNT; i++) {
+    YGNodeCalculateLayout(root, kWidths[i], YGUndefined, YGDirectionLTR);
+  }
+  YGPassStats warm = {0, 0};
+  for (int i = 0; i < passes; i++) {
+    YGLayoutPass(root, kWidths[i % YG_WIDTH_COUNT], &warm);
+  }
+  YGNodeCalculateLayout(root, kHashWidth, YGUndefined, YGDirectionLTR);
+  const uint64_t warmHash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+  YGNodeFreeRecursive(root);
+
+  const YGNodeRef reference = tree->build(config, size);
+  YGNodeCalculateLayout(reference, kHashWidth, YGUndefined, YGDirectionLTR);
+  const bool identical = YGBenchmarkLayoutHash(reference, YG_BENCHMARK_HASH_SEED) == warmHash;
+  YGNodeFreeRecursive(reference);
+
+  const double count = (double)nodes * passes;
+  printf("%-18s %6d %10.1f %8.2f %10.1f %8.2f %9.1f  %016llx%s\n", tree->name, nodes,
+         cold.time / count, (double)cold.allocations / passes, warm.time / count,
+         (double)warm.allocations / passes, peakBytes / 1024.0, (unsigned long long)warmHash,
+         identical ? "" : "  MISMATCH");
+  return identical ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+  const int nodes = argc > 1 ? atoi(argv[1]) : 1000;
+  const int passes = argc > 2 ? atoi(argv[2]) : 100;
+  if (nodes < 2 || passes < 1) {
+    printf("usage: YGLayoutBenchmark [nodes per tree >= 2] [passes >= 1]\n");
+    return 1;
+  }
+  YGBenchmarkTrackAllocations();
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 0);
+
+  printf("%-18s %6s %10s %8s %10s %8s %9s  %s\n", "tree", "nodes", "cold ns/n", "allocs",
+         "warm ns/n", "allocs", "peak KB", "layout hash");
+  int failures = 0;
+  for (size_t i = 0; i < YG_TREE_COUNT; i++) {
+    failures += YGRun(&kTrees[i], config, nodes, passes);
+  }
+
+  YGConfigFree(config);
+  return failures == 0 && YGNodeGetInstanceCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+/**
+ * Edits the text of one cell of a feed per pass and reports how many nodes the layout journal
+ * lists, i.e. how many frames a view hierarchy has to update, against the size of the tree, and
+ * what filling the journal adds to the pass.
+ *
+ * usage: YGLayoutJournalBenchmark [cells] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+typedef struct YGEditStats {
+  uint64_t time;
+  uint64_t journaled;
+} YGEditStats;
+
+// The body text of cell |i|, the second text of its content column.
+static YGNodeRef YGCellBody(const YGNodeRef root, const int i) {
+  const YGNodeRef cell = YGNodeGetChild(root, (uint32_t)i % YGNodeGetChildCount(root));
+  return YGNodeGetChild(YGNodeGetChild(cell, 1), 1);
+}
+
+static YGEditStats YGRunEdits(const YGNodeRef root, const YGLayoutContextRef context,
+                              const YGLayoutJournalRef journal, const int passes,
+                              uint64_t *const hash) {
+  YGEditStats stats = {0, 0};
+  for (int i = 0; i < passes; i++) {
+    const YGNodeRef body = YGCellBody(root, i * 7);
+    YGNodeSetContext(body, (void *)(intptr_t)(40 + (i * 53) % 200));
+    YGNodeMarkDirty(body);
+    stats.time +=
+        YGNodeCalculateLayoutWithContext(root, 375, YGUndefined, YGDirectionLTR, context).time;
+    stats.journaled += journal != NULL ? YGLayoutJournalGetCount(journal) : 0;
+  }
+  *hash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+  return stats;
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 250;
+  const int passes = argc > 2 ? atoi(argv[2]) : 500;
+  if (cells < 1 || passes < 1) {
+    printf("usage: YGLayoutJournalBenchmark [cells >= 1] [passes >= 1]\n");
+    return 1;
+  }
+  const YGConfigRef config = YGConfigNew();
+  const YGLayoutContextRef context = YGLayoutContextNew();
+  const YGLayoutJournalRef journal = YGLayoutJournalNew();
+  uint64_t hashes[2];
+
+  const YGNodeRef plainRoot = YGBenchmarkNewFeed(config, cells);
+  const int nodes = YGBenchmarkCountNodes(plainRoot);
+  YGNodeCalculateLayoutWithContext(plainRoot, 375, YGUndefined, YGDirectionLTR, context);
+  const YGEditStats plain = YGRunEdits(plainRoot, context, NULL, passes, &hashes[0]);
+
+  const YGNodeRef journaledRoot = YGBenchmarkNewFeed(config, cells);
+  YGLayoutContextSetJournal(context, journal);
+  YGNodeCalculateLayoutWithContext(journaledRoot, 375, YGUndefined, YGDirectionLTR, context);
+  const YGEditStats journaled = YGRunEdits(journaledRoot, context, journal, passes, &hashes[1]);
+
+  printf("%d nodes, %d passes editing one cell each\n", nodes, passes);
+  printf("%-10s %10.1f us/pass\n", "plain", plain.time / 1000.0 / passes);
+  printf("%-10s %10.1f us/pass   %.1f nodes journaled per pass (%.2f%% of the tree)\n",
+         "journaled", journaled.time / 1000.0 / passes, (double)journaled.journaled / passes,
+         100.0 * journaled.journaled / passes / nodes);
+
+  YGNodeFreeRecursive(plainRoot);
+  YGNodeFreeRecursive(journaledRoot);
+  YGLayoutJournalFree(journal);
+  YGLayoutContextFree(context);
+  YGConfigFree(config);
+  if (hashes[0] != hashes[1] || YGNodeGetInstanceCount() != 0) {
+    printf("journaling changed the layout or leaked nodes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * Replays a window resize sweep over a feed under several measurement cache policies.
+ *
+ * The window is dragged from 320 to 1024 points wide and back, 16 points at a time, as many times
+ * as there are sweeps. Every width is seen again on the way back and on the next sweep, so a
+ * cache that keeps enough entries answers those passes without calling the measure functions.
+ * For every policy the benchmark reports the time and the measure calls of a pass, the share of
+ * requests answered by the measurement caches and the memory held by the tree and its caches once
+ * the sweep is over. The layout after the sweep must be the same under every policy.
+ *
+ * Measuring text is what makes a measurement worth caching, so every measure call also waits
+ * for a fixed time, 1 microsecond by default, about what sizing a label takes.
+ *
+ * usage: YGMeasurementCacheBenchmark [cells] [sweeps] [measure cost in ns]
+ */
+
+#include "YGBenchmark.h"
+
+#define YG_SWEEP_MIN_WIDTH 320
+#define YG_SWEEP_MAX_WIDTH 1024
+#define YG_SWEEP_STEP 16
+
+static uint64_t gMeasureCost;
+
+static YGSize YGMeasureTextSlowly(YGNodeRef node, float width, YGMeasureMode widthMode,
+                                  float height, YGMeasureMode heightMode) {
+  const uint64_t start = YGBenchmarkNow();
+  while (YGBenchmarkNow() - start < gMeasureCost) {
+  }
+  return YGBenchmarkMeasureText(node, width, widthMode, height, heightMode);
+}
+
+static void YGSetMeasureFuncRecursive(const YGNodeRef node, const YGMeasureFunc measure) {
+  if (YGNodeGetMeasureFunc(node) != NULL) {
+    YGNodeSetMeasureFunc(node, measure);
+  }
+  for (uint32_t i = 0; i < YGNodeGetChildCount(node); i++) {
+    YGSetMeasureFuncRecursive(YGNodeGetChild(node, i), measure);
+  }
+}
+
+typedef struct YGCachePolicy {
+  const char *name;
+  YGCacheEviction eviction;
+  uint32_t leafCapacity;
+  uint32_t containerCapacity;
+} YGCachePolicy;
+
+static const YGCachePolicy kPolicies[] = {
+    {"round robin 16/16", YGCacheEvictionRoundRobin, 16, 16},
+    {"lru 16/16", YGCacheEvictionLeastRecentlyUsed, 16, 16},
+    {"lru 32/8", YGCacheEvictionLeastRecentlyUsed, 32, 8},
+    {"lru 64/4", YGCacheEvictionLeastRecentlyUsed, 64, 4},
+    {"lru 256/16", YGCacheEvictionLeastRecentlyUsed, 256, 16},
+};
+#define YG_POLICY_COUNT (sizeof(kPolicies) / sizeof(kPolicies[0]))
+
+typedef struct YGSweepStats {
+  uint64_t passes;
+  uint64_t time;
+  uint64_t measureCalls;
+  uint64_t requests;
+  uint64_t hits;
+} YGSweepStats;
+
+static void YGSweepPass(const YGNodeRef root, const float width, YGSweepStats *const stats) {
+  const YGLayoutStats pass = YGNodeCalculateLayout(root, width, YGUndefined, YGDirectionLTR);
+  stats->passes++;
+  stats->time += pass.time;
+  stats->measureCalls += pass.measureCalls;
+  stats->requests += pass.nodesVisited;
+  stats->hits += pass.layoutCacheHits + pass.measurementCacheHits;
+}
+
+static uint64_t YGRun(const YGCachePolicy *const policy, const int cells, const int sweeps) {
+  const YGConfigRef config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 0);
+  YGConfigSetMeasurementCacheEviction(config, policy->eviction);
+  YGConfigSetMeasurementCacheCapacity(config, policy->leafCapacity, policy->containerCapacity);
+
+  const int64_t liveBytes = gYGBenchmarkAllocations.liveBytes;
+  const YGNodeRef root = YGBenchmarkNewFeed(config, cells);
+  YGSetMeasureFuncRecursive(root, YGMeasureTextSlowly);
+  YGSweepStats stats = {0, 0, 0, 0, 0};
+  for (int i = 0; i < sweeps; i++) {
+    for (int width = YG_SWEEP_MIN_WIDTH; width < YG_SWEEP_MAX_WIDTH; width += YG_SWEEP_STEP) {
+      YGSweepPass(root, width, &stats);
+    }
+    for (int width = YG_SWEEP_MAX_WIDTH; width > YG_SWEEP_MIN_WIDTH; width -= YG_SWEEP_STEP) {
+      YGSweepPass(root, width, &stats);
+    }
+  }
+  YGNodeCalculateLayout(root, YG_SWEEP_MIN_WIDTH, YGUndefined, YGDirectionLTR);
+  const uint64_t hash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+  const int64_t treeBytes = gYGBenchmarkAllocations.liveBytes - liveBytes;
+
+  const double nodes = cells * 9 + 1;
+  printf("%-18s %10.1f %12.1f %8.1f%% %10.1f  %016llx\n", policy->name,
+         stats.time / (nodes * stats.passes), (double)stats.measureCalls / stats.passes,
+         100.0 * stats.hits / stats.requests, treeBytes / 1024.0, (unsigned long long)hash);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+  return hash;
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 300;
+  const int sweeps = argc > 2 ? atoi(argv[2]) : 3;
+  gMeasureCost = argc > 3 ? strtoull(argv[3], NULL, 10) : 1000;
+  if (cells < 1 || sweeps < 1) {
+    printf("usage: YGMeasurementCacheBenchmark [cells >= 1] [sweeps >= 1] [measure cost]\n");
+    return 1;
+  }
+  YGBenchmarkTrackAllocations();
+
+  printf("%d nodes, %d sweeps of %d widths, %llu ns per measure call\n", cells * 9 + 1, sweeps,
+         2 * (YG_SWEEP_MAX_WIDTH - YG_SWEEP_MIN_WIDTH) / YG_SWEEP_STEP,
+         (unsigned long long)gMeasureCost);
+  printf("%-18s %10s %12s %9s %10s  %s\n", "policy", "ns/node", "measures/pass", "hits",
+         "tree KB", "layout hash");
+  int failures = 0;
+  const uint64_t expected = YGRun(&kPolicies[0], cells, sweeps);
+  for (size_t i = 1; i < YG_POLICY_COUNT; i++) {
+    if (YGRun(&kPolicies[i], cells, sweeps) != expected) {
+      printf("MISMATCH: %s and %s lay the feed out differently\n", kPolicies[i].name,
+             kPolicies[0].name);
+      failures++;
+    }
+  }
+  return failures == 0 && YGNodeGetInstanceCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+/**
+ * Reports the memory footprint of nodes and the layout throughput on deep and wide trees.
+ *
+ * bytes/node counts everything Yoga allocated for the tree (nodes, child lists, measurement
+ * caches and out of line style), once right after building it and once after it has been laid
+ * out under a few different widths. Cold passes lay out a freshly built tree, warm passes
+ * relayout the same tree after the measured leaves were dirtied.
+ *
+ * usage: YGNodeFootprintBenchmark [nodes] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static const float kWidths[] = {320, 375, 414, 768};
+#define YG_WIDTH_COUNT (sizeof(kWidths) / sizeof(kWidths[0]))
+
+// Depth of the chains of the deep tree. Alternating row and column containers are measured
+// several times per level, so much deeper chains only benchmark that blowup.
+#define YG_CHAIN_DEPTH 32
+
+/// Chains of |YG_CHAIN_DEPTH| nested containers, each ending in a text leaf: |count| nodes in
+/// total.
+static YGNodeRef YGNewDeepTree(const YGConfigRef config, const int count) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  for (int chain = 0; chain < (count - 1) / YG_CHAIN_DEPTH; chain++) {
+    YGNodeRef parent = root;
+    for (int i = 0; i < YG_CHAIN_DEPTH - 1; i++) {
+      const YGNodeRef node = YGBenchmarkNewNode(config);
+      YGNodeStyleSetFlexDirection(node, i % 2 ? YGFlexDirectionRow : YGFlexDirectionColumn);
+      YGNodeStyleSetPadding(node, YGEdgeLeft, 1);
+      YGNodeInsertChild(parent, node, parent == root ? (uint32_t)chain : 0);
+      parent = node;
+    }
+    YGNodeInsertChild(parent, YGBenchmarkNewText(config, 20 + chain % 100), 0);
+  }
+  return root;
+}
+
+/// A column of rows, each holding a text leaf: |count| nodes in total.
+static YGNodeRef YGNewWideTree(const YGConfigRef config, const int count) {
+  const YGNodeRef root = YGBenchmarkNewNode(config);
+  for (int i = 0; i < (count - 1) / 2; i++) {
+    const YGNodeRef row = YGBenchmarkNewNode(config);
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(row, YGEdgeAll, 8);
+    YGNodeInsertChild(row, YGBenchmarkNewText(config, 10 + (i * 7) % 90), 0);
+    YGNodeInsertChild(root, row, (uint32_t)i);
+  }
+  return root;
+}
+
+static void YGRun(const char *label, YGNodeRef (*build)(YGConfigRef, int), const YGConfigRef config,
+                  const int size, const int passes) {
+  const int64_t liveBytes = gYGBenchmarkAllocations.liveBytes;
+  const YGNodeRef root = build(config, size);
+  const int nodes = YGBenchmarkCountNodes(root);
+  const double builtBytes = (double)(gYGBenchmarkAllocations.liveBytes - liveBytes) / nodes;
+  YGNodeFreeRecursive(root);
+
+  uint64_t coldTime = 0;
+  for (int i = 0; i < passes; i++) {
+    const YGNodeRef tree = build(config, size);
+    const uint64_t start = YGBenchmarkNow();
+    YGNodeCalculateLayout(tree, kWidths[i % YG_WIDTH_COUNT], YGUndefined, YGDirectionLTR);
+    coldTime += YGBenchmarkNow() - start;
+    YGNodeFreeRecursive(tree);
+  }
+
+  const YGNodeRef tree = build(config, size);
+  uint64_t warmTime = 0;
+  for (int i = 0; i < passes; i++) {
+    YGBenchmarkDirtyMeasuredNodes(tree);
+    const uint64_t start = YGBenchmarkNow();
+    YGNodeCalculateLayout(tree, kWidths[i % YG_WIDTH_COUNT], YGUndefined, YGDirectionLTR);
+    warmTime += YGBenchmarkNow() - start;
+  }
+  const double laidOutBytes = (double)(gYGBenchmarkAllocations.liveBytes - liveBytes) / nodes;
+  YGNodeFreeRecursive(tree);
+
+  printf("%-5s %6d nodes %8.0f B/node built %8.0f B/node laid out %10.0f nodes/s cold %10.0f "
+         "nodes/s warm\n",
+         label, nodes, builtBytes, laidOutBytes, (double)nodes * passes * 1e9 / coldTime,
+         (double)nodes * passes * 1e9 / warmTime);
+}
+
+int main(int argc, char *argv[]) {
+  const int nodes = argc > 1 ? atoi(argv[1]) : 1000;
+  const int passes = argc > 2 ? atoi(argv[2]) : 200;
+  YGBenchmarkTrackAllocations();
+  const YGConfigRef config = YGConfigNew();
+  YGRun("deep", YGNewDeepTree, config, nodes, passes);
+  YGRun("wide", YGNewWideTree, config, nodes, passes);
+  YGConfigFree(config);
+  return YGNodeGetInstanceCount() == 0 ? 0 : 1;
+}
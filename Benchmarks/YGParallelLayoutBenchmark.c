@@ -0,0 +1,59 @@
+/**
+ * Compares the serial layout of wide containers with YGConfigSetParallelLayoutEnabled.
+ *
+ * Every configuration must produce exactly the serial layout; the benchmark fails otherwise.
+ * The speedup depends on the number of cores: the pool has one worker per core besides the
+ * calling thread, so on a single core both columns are expected to match.
+ *
+ * usage: YGParallelLayoutBenchmark [cells] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static const uint32_t kGrainSizes[] = {4, 16, 64};
+#define YG_GRAIN_SIZE_COUNT (sizeof(kGrainSizes) / sizeof(kGrainSizes[0]))
+
+// Lays out |root| |passes| times from scratch and returns the average time per pass.
+static double YGMeasurePasses(const YGNodeRef root, const int passes, uint64_t *const hash) {
+  uint64_t elapsed = 0;
+  for (int i = 0; i < passes; i++) {
+    YGBenchmarkDirtyMeasuredNodes(root);
+    const uint64_t start = YGBenchmarkNow();
+    YGNodeCalculateLayout(root, i % 2 ? 375 : 414, YGUndefined, YGDirectionLTR);
+    elapsed += YGBenchmarkNow() - start;
+  }
+  *hash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+  return (double)elapsed / passes;
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 2000;
+  const int passes = argc > 2 ? atoi(argv[2]) : 50;
+  printf("%d cells (%d nodes), %d cores\n", cells, cells * 9 + 1, YGBenchmarkCoreCount());
+
+  const YGConfigRef serialConfig = YGConfigNew();
+  const YGNodeRef serialRoot = YGBenchmarkNewFeed(serialConfig, cells);
+  uint64_t serialHash;
+  const double serialTime = YGMeasurePasses(serialRoot, passes, &serialHash);
+  printf("%-18s %10.3f ms/pass\n", "serial", serialTime / 1e6);
+  YGNodeFreeRecursive(serialRoot);
+  YGConfigFree(serialConfig);
+
+  int failures = 0;
+  for (size_t i = 0; i < YG_GRAIN_SIZE_COUNT; i++) {
+    const YGConfigRef config = YGConfigNew();
+    YGConfigSetParallelLayoutEnabled(config, true);
+    YGConfigSetParallelLayoutGrainSize(config, kGrainSizes[i]);
+    const YGNodeRef root = YGBenchmarkNewFeed(config, cells);
+    uint64_t hash;
+    const double time = YGMeasurePasses(root, passes, &hash);
+    char label[32];
+    snprintf(label, sizeof(label), "parallel grain %u", kGrainSizes[i]);
+    printf("%-18s %10.3f ms/pass %6.2fx %s\n", label, time / 1e6, serialTime / time,
+           hash == serialHash ? "identical" : "MISMATCH");
+    failures += hash != serialHash;
+    YGNodeFreeRecursive(root);
+    YGConfigFree(config);
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+/**
+ * Measures the pixel grid rounding stage of a layout pass.
+ *
+ * The kernel section rounds the same values one by one with YGRoundValueToPixelGrid and all at
+ * once with YGRoundValuesToPixelGrid; both must agree bit for bit. The pass section relayouts a
+ * feed at alternating widths, with and without a point scale factor, to isolate the rounding stage.
+ * To compare against the scalar build, run:
+ *
+ *   CFLAGS="-O2 -DNDEBUG -DYG_NO_SIMD" ./bench_yoga.sh YGPixelGridBenchmark
+ *
+ * usage: YGPixelGridBenchmark [cells] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+#define YG_KERNEL_VALUE_COUNT 60000
+
+// Fills |values| with layout-like coordinates: whole, half and third points and arbitrary
+// fractions. Every 6th value belongs to a text node and is floored, as the rounding stage does.
+static void YGFillValues(float *const values, bool *const forceCeil, bool *const forceFloor,
+                         const uint32_t count) {
+  srand(42);
+  for (uint32_t i = 0; i < count; i++) {
+    const float whole = (float)(rand() % 2000) - 200;
+    const float fractions[] = {0, 0.5f, 1.0f / 3, 2.0f / 3, (float)rand() / RAND_MAX};
+    values[i] = whole + fractions[rand() % 5];
+    forceCeil[i] = i % 12 == 5;
+    forceFloor[i] = i % 6 == 0;
+  }
+}
+
+static int YGRunKernel(const int iterations) {
+  float *const input = malloc(YG_KERNEL_VALUE_COUNT * sizeof(float));
+  float *const scalar = malloc(YG_KERNEL_VALUE_COUNT * sizeof(float));
+  float *const batch = malloc(YG_KERNEL_VALUE_COUNT * sizeof(float));
+  bool *const forceCeil = malloc(YG_KERNEL_VALUE_COUNT * sizeof(bool));
+  bool *const forceFloor = malloc(YG_KERNEL_VALUE_COUNT * sizeof(bool));
+  YGFillValues(input, forceCeil, forceFloor, YG_KERNEL_VALUE_COUNT);
+
+  uint64_t scalarTime = 0;
+  uint64_t batchTime = 0;
+  for (int i = 0; i < iterations; i++) {
+    const float scale = i % 2 ? 2.0f : 3.0f;
+    memcpy(scalar, input, YG_KERNEL_VALUE_COUNT * sizeof(float));
+    memcpy(batch, input, YG_KERNEL_VALUE_COUNT * sizeof(float));
+
+    uint64_t start = YGBenchmarkNow();
+    for (uint32_t j = 0; j < YG_KERNEL_VALUE_COUNT; j++) {
+      scalar[j] = YGRoundValueToPixelGrid(scalar[j], scale, forceCeil[j], forceFloor[j]);
+    }
+    scalarTime += YGBenchmarkNow() - start;
+
+    start = YGBenchmarkNow();
+    YGRoundValuesToPixelGrid(batch, YG_KERNEL_VALUE_COUNT, scale, forceCeil, forceFloor);
+    batchTime += YGBenchmarkNow() - start;
+  }
+
+  const int identical = memcmp(scalar, batch, YG_KERNEL_VALUE_COUNT * sizeof(float)) == 0;
+  const double values = (double)YG_KERNEL_VALUE_COUNT * iterations;
+  printf("kernel  one by one %6.2f ns/value   batched %6.2f ns/value %6.2fx %s\n",
+         scalarTime / values, batchTime / values, (double)scalarTime / batchTime,
+         identical ? "identical" : "MISMATCH");
+
+  free(input);
+  free(scalar);
+  free(batch);
+  free(forceCeil);
+  free(forceFloor);
+  return identical ? 0 : 1;
+}
+
+// Average time of a pass over |root|, in nanoseconds. Measurements are cached after the first
+// two passes, so every pass repositions the whole tree but measures nothing.
+static double YGRunPasses(const YGNodeRef root, const int passes) {
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayout(root, 414, YGUndefined, YGDirectionLTR);
+  const uint64_t start = YGBenchmarkNow();
+  for (int i = 0; i < passes; i++) {
+    YGNodeCalculateLayout(root, i % 2 ? 375 : 414, YGUndefined, YGDirectionLTR);
+  }
+  return (double)(YGBenchmarkNow() - start) / passes;
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 1000;
+  const int passes = argc > 2 ? atoi(argv[2]) : 200;
+  const int nodes = cells * 9 + 1;
+  printf("%d nodes, %d passes\n", nodes, passes);
+
+  const int failures = YGRunKernel(passes);
+
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = YGBenchmarkNewFeed(config, cells);
+  YGConfigSetPointScaleFactor(config, 0);
+  const double unrounded = YGRunPasses(root, passes);
+  YGConfigSetPointScaleFactor(config, 3);
+  const double rounded = YGRunPasses(root, passes);
+  printf("pass    unrounded %7.1f ns/node   rounded %7.1f ns/node   rounding %7.1f ns/node\n",
+         unrounded / nodes, rounded / nodes, (rounded - unrounded) / nodes);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+  return failures;
+}
@@ -0,0 +1,76 @@
+/**
+ * Measures what tracing costs a layout pass: without a trace function, with one that does
+ * nothing and with the Chrome trace writer. Every pass re-measures the whole feed.
+ *
+ * When a path is given, one more pass is traced into it as Chrome trace JSON, ready to be opened
+ * in chrome://tracing or Perfetto.
+ *
+ * usage: YGTraceBenchmark [cells] [passes] [trace path]
+ */
+
+#include "YGBenchmark.h"
+
+static void YGIgnoreTraceEvent(const YGTraceEvent *event, void *context) {
+  (void)event;
+  (void)context;
+}
+
+static double YGRun(const YGNodeRef root, const int passes, uint64_t *const hash) {
+  uint64_t time = 0;
+  for (int i = 0; i < passes; i++) {
+    YGBenchmarkDirtyMeasuredNodes(root);
+    time += YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR).time;
+  }
+  *hash = YGBenchmarkLayoutHash(root, YG_BENCHMARK_HASH_SEED);
+  return (double)time / passes / YGBenchmarkCountNodes(root);
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 250;
+  const int passes = argc > 2 ? atoi(argv[2]) : 100;
+  if (cells < 1 || passes < 1) {
+    printf("usage: YGTraceBenchmark [cells >= 1] [passes >= 1] [trace path]\n");
+    return 1;
+  }
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef root = YGBenchmarkNewFeed(config, cells);
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  printf("%d nodes, %d passes\n", cells * 9 + 1, passes);
+
+  uint64_t hashes[3];
+  printf("%-14s %8.1f ns/node\n", "untraced", YGRun(root, passes, &hashes[0]));
+
+  YGConfigSetTraceFunc(config, YGIgnoreTraceEvent, NULL);
+  printf("%-14s %8.1f ns/node\n", "no-op trace", YGRun(root, passes, &hashes[1]));
+
+  FILE *const null = fopen("/dev/null", "w");
+  const YGChromeTraceWriterRef writer = YGChromeTraceWriterNew(null);
+  YGConfigSetTraceFunc(config, YGChromeTraceWriterTrace, writer);
+  printf("%-14s %8.1f ns/node\n", "chrome trace", YGRun(root, passes, &hashes[2]));
+  YGChromeTraceWriterFree(writer);
+  fclose(null);
+
+  if (argc > 3) {
+    FILE *const file = fopen(argv[3], "w");
+    if (file == NULL) {
+      printf("cannot open %s\n", argv[3]);
+      return 1;
+    }
+    const YGChromeTraceWriterRef fileWriter = YGChromeTraceWriterNew(file);
+    YGConfigSetTraceFunc(config, YGChromeTraceWriterTrace, fileWriter);
+    YGBenchmarkDirtyMeasuredNodes(root);
+    YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+    YGChromeTraceWriterFree(fileWriter);
+    fclose(file);
+    printf("trace written to %s\n", argv[3]);
+  }
+  YGConfigSetTraceFunc(config, NULL, NULL);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+  if (hashes[1] != hashes[0] || hashes[2] != hashes[0] || YGNodeGetInstanceCount() != 0) {
+    printf("tracing changed the layout or leaked nodes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * Lays out a photo grid: a wrapping row of identical square thumbnails with a small margin,
+ * resized every pass as when rotating the device, so that every pass lays out every cell.
+ *
+ * The same grid is laid out twice: once as is, which the uniform grid kernel places without
+ * recursing into the cells, and once with one cell whose alignSelf is set explicitly to the
+ * alignItems of the grid. That does not change the layout but tells the cell apart from its
+ * siblings, so the grid goes through the general flex steps. Both grids must be laid out
+ * identically.
+ *
+ * usage: YGUniformGridBenchmark [cells] [passes]
+ */
+
+#include "YGBenchmark.h"
+
+static YGNodeRef YGNewGrid(const YGConfigRef config, const int cells) {
+  const YGNodeRef grid = YGBenchmarkNewNode(config);
+  YGNodeStyleSetFlexDirection(grid, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(grid, YGWrapWrap);
+  YGNodeStyleSetAlignItems(grid, YGAlignFlexStart);
+  YGNodeStyleSetPadding(grid, YGEdgeAll, 2);
+  for (int i = 0; i < cells; i++) {
+    const YGNodeRef cell = YGBenchmarkNewNode(config);
+    YGNodeStyleSetWidth(cell, 90);
+    YGNodeStyleSetHeight(cell, 90);
+    YGNodeStyleSetMargin(cell, YGEdgeAll, 1);
+    YGNodeInsertChild(grid, cell, (uint32_t)i);
+  }
+  return grid;
+}
+
+static uint64_t YGRun(const YGNodeRef grid, const int passes, uint64_t *const hash,
+                      uint32_t *const nodesVisited) {
+  static const float widths[] = {375, 812, 320, 1024};
+  uint64_t time = 0;
+  for (int i = 0; i < passes; i++) {
+    const YGLayoutStats stats =
+        YGNodeCalculateLayout(grid, widths[i % 4], YGUndefined, YGDirectionLTR);
+    time += stats.time;
+    *nodesVisited = stats.nodesVisited;
+  }
+  *hash = YGBenchmarkLayoutHash(grid, YG_BENCHMARK_HASH_SEED);
+  return time;
+}
+
+int main(int argc, char *argv[]) {
+  const int cells = argc > 1 ? atoi(argv[1]) : 2000;
+  const int passes = argc > 2 ? atoi(argv[2]) : 200;
+  if (cells < 1 || passes < 1) {
+    printf("usage: YGUniformGridBenchmark [cells >= 1] [passes >= 1]\n");
+    return 1;
+  }
+  const YGConfigRef config = YGConfigNew();
+  const YGNodeRef uniformGrid = YGNewGrid(config, cells);
+  const YGNodeRef generalGrid = YGNewGrid(config, cells);
+  YGNodeStyleSetAlignSelf(YGNodeGetChild(generalGrid, (uint32_t)cells - 1), YGAlignFlexStart);
+  printf("%d cells, %d passes\n", cells, passes);
+
+  uint64_t hashes[2];
+  uint32_t nodesVisited[2];
+  const uint64_t generalTime = YGRun(generalGrid, passes, &hashes[0], &nodesVisited[0]);
+  const uint64_t uniformTime = YGRun(uniformGrid, passes, &hashes[1], &nodesVisited[1]);
+  printf("%-8s %10.1f us/pass %8u nodes visited\n", "general", generalTime / 1000.0 / passes,
+         nodesVisited[0]);
+  printf("%-8s %10.1f us/pass %8u nodes visited   %.2fx\n", "uniform",
+         uniformTime / 1000.0 / passes, nodesVisited[1], (double)generalTime / uniformTime);
+
+  YGNodeFreeRecursive(uniformGrid);
+  YGNodeFreeRecursive(generalGrid);
+  YGConfigFree(config);
+  if (hashes[0] != hashes[1] || YGNodeGetInstanceCount() != 0) {
+    printf("the uniform grid kernel changed the layout or leaked nodes\n");
+    return 1;
+  }
+  return 0;
+}
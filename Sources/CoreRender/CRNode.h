@@ -11,7 +11,10 @@ NS_SWIFT_NAME(NodeLayoutOptions)
 typedef NS_OPTIONS(NSUInteger, CRNodeLayoutOptions) {
   CRNodeLayoutOptionsNone = 1 << 0,
   CRNodeLayoutOptionsSizeContainerViewToFit = 1 << 1,
-  CRNodeLayoutOptionsUseSafeAreaInsets = 1 << 2
+  CRNodeLayoutOptionsUseSafeAreaInsets = 1 << 2,
+  /// The yoga nodes of the views created by the hierarchy are allocated from a per-hierarchy
+  /// arena (see @c YGNodeArena).
+  CRNodeLayoutOptionsAllocateNodesInArena = 1 << 3
 };
 
 @class CRNode;
@@ -201,11 +201,19 @@ void CRIllegalCoordinatorTypeException(NSString *reason) {
   }
 }
 
+/// Runs the layout spec as a single style update, so that the modifiers it applies mark the
+/// yoga node dirty at most once, and only if they leave its style changed.
+- (void)_applyLayoutSpec:(CRNodeLayoutSpec *)spec {
+  [_renderedView.yoga performStyleUpdates:^{
+    _layoutSpec(spec);
+  }];
+}
+
 - (void)_configureConstrainedToSize:(CGSize)size withOptions:(CRNodeLayoutOptions)options {
   [self _constructViewWithReusableView:nil];
   [_renderedView.cr_nodeBridge storeViewSubTreeOldGeometry];
   const auto spec = [[CRNodeLayoutSpec alloc] initWithNode:self constrainedToSize:size];
-  _layoutSpec(spec);
+  [self _applyLayoutSpec:spec];
 
   CR_FOREACH(child, _mutableChildren) {
     [child _configureConstrainedToSize:size withOptions:options];
@@ -366,7 +374,7 @@ void CRIllegalCoordinatorTypeException(NSString *reason) {
 
 - (void)setNeedsConfigure {
   const auto spec = [[CRNodeLayoutSpec alloc] initWithNode:self constrainedToSize:_size];
-  _layoutSpec(spec);
+  [self _applyLayoutSpec:spec];
 }
 
 @end
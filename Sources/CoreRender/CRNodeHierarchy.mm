@@ -3,6 +3,7 @@
 #import "CRContext.h"
 #import "CRMacros.h"
 #include "CRNodeBuilder.h"
+#import "YGLayout.h"
 
 @implementation CRNodeHierarchy {
   __weak CRContext *_context;
@@ -10,6 +11,7 @@
   CGSize _size;
   CRNodeLayoutOptions _options;
   CROpaqueNodeBuilder * (^_buildNodeHierarchy)(CRContext *);
+  YGNodeArena *_nodeArena;
 }
 
 - (instancetype)initWithContext:(CRContext *)context
@@ -33,7 +35,9 @@
   _root = [_buildNodeHierarchy(_context) build];
   [_root registerNodeHierarchyInContext:_context];
   [_root setNodeHierarchy:self];
-  [_root reconcileInView:view constrainedToSize:size withOptions:options];
+  // Every build starts a new arena; the previous one is released with the last view using it.
+  _nodeArena = nil;
+  [self _reconcileInView:view constrainedToSize:size withOptions:options];
 }
 
 - (void)reconcileInView:(nullable UIView *)view
@@ -43,7 +47,25 @@
   _containerView = view;
   _size = size;
   _options = options;
-  [_root reconcileInView:view constrainedToSize:size withOptions:options];
+  [self _reconcileInView:view constrainedToSize:size withOptions:options];
+}
+
+- (void)_reconcileInView:(nullable UIView *)view
+       constrainedToSize:(CGSize)size
+             withOptions:(CRNodeLayoutOptions)options {
+  if (!(options & CRNodeLayoutOptionsAllocateNodesInArena)) {
+    [_root reconcileInView:view constrainedToSize:size withOptions:options];
+    return;
+  }
+  if (_nodeArena == nil) {
+    _nodeArena = [[YGNodeArena alloc] init];
+  }
+  [YGLayout allocateNodesInArena:_nodeArena
+                      usingBlock:^{
+                        [self->_root reconcileInView:view
+                                   constrainedToSize:size
+                                         withOptions:options];
+                      }];
 }
 
 - (void)layoutConstrainedToSize:(CGSize)size withOptions:(CRNodeLayoutOptions)options {
@@ -21,6 +21,16 @@ typedef NS_OPTIONS(NSInteger, YGDimensionFlexibility) {
   YGDimensionFlexibilityFlexibleHeigth = 1 << 1,
 };
 
+/**
+ A region the yoga nodes of a view hierarchy can be allocated from (see YGArenaRef). Nodes are
+ contiguous in creation order and their memory is released all at once, after the arena and every
+ YGLayout allocated from it have been deallocated.
+ */
+@interface YGNodeArena : NSObject
+/** @param capacity The expected number of nodes. The arena grows past it if needed. */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+@end
+
 @interface YGLayout : NSObject
 
 /**
@@ -99,6 +109,13 @@ typedef NS_OPTIONS(NSInteger, YGDimensionFlexibility) {
  */
 @property(nonatomic, readonly, assign) YGDirection resolvedDirection;
 
+/**
+ Whether applying the layout from this view only updates its frame and the frames of the views
+ whose layout changed since it was last applied from this view, instead of every frame in the
+ hierarchy. Frames set outside of Yoga in between are then kept. Defaults to NO.
+ */
+@property(nonatomic, readwrite, assign) BOOL appliesOnlyChangedFrames;
+
 /**
  Perform a layout calculation and update the frames of the views in the hierarchy with the results.
  If the origin is not preserved, the root view's layout results will applied from {0,0}.
@@ -137,6 +154,34 @@ typedef NS_OPTIONS(NSInteger, YGDimensionFlexibility) {
  */
 @property(nonatomic, readonly, assign) BOOL isDirty;
 
+/**
+ Counters of the last layout pass run from this view: nodes visited, layout and measurement cache
+ hits, calls to -sizeThatFits:, the depth of the tree and the time spent, in nanoseconds.
+ */
+@property(nonatomic, readonly, assign) YGLayoutStats lastLayoutStats;
+
+/**
+ Hash of the content measured by this leaf view, e.g. its text, font and number of lines. Leaves
+ with the same non-zero key share their measurements through Yoga's process-wide cache (see
+ YGMeasureKeyFunc) instead of each calling -sizeThatFits:. The key must change whenever the content
+ does. Defaults to 0, which measures the view on its own.
+ */
+@property(nonatomic, readwrite, assign) uint64_t measureKey;
+
+/**
+ Whether Yoga rounds the layout of every hierarchy to the pixel grid of the main screen, once per
+ pass, and the frames are applied as they are. Otherwise each frame is rounded on its own when it is
+ applied, which keeps the frames views had before the option existed. Set it before the first
+ layout. Defaults to NO.
+ */
+@property(class, nonatomic, readwrite, assign) BOOL roundsLayoutToPixelGrid;
+
+/**
+ Applies the style changes made by the block at once: the node is marked dirty a single time, and
+ only if its style differs from the one before the block. See YGNodeStyleBeginUpdate.
+ */
+- (void)performStyleUpdates:(NS_NOESCAPE void (^)(void))block;
+
 /** Analogous to flexShrink = 1 and flexGrow = 1 */
 - (void)flex;
 
@@ -145,6 +190,12 @@ typedef NS_OPTIONS(NSInteger, YGDimensionFlexibility) {
  */
 - (void)markDirty;
 
+/**
+ The YGLayout objects created while the block runs allocate their node from the arena passed as
+ argument. Meant to wrap the construction of a whole hosting hierarchy. Main thread only.
+ */
++ (void)allocateNodesInArena:(YGNodeArena *)arena usingBlock:(NS_NOESCAPE void (^)(void))block;
+
 @end
 
 @interface YGLayout ()
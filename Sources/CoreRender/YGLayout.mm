@@ -75,28 +75,75 @@
   YG_VALUE_EDGE_PROPERTY(lowercased_name, capitalized_name, capitalized_name, YGEdgeAll)
 
 static YGConfigRef globalConfig;
+/// See +[YGLayout roundsLayoutToPixelGrid].
+static BOOL roundsLayoutToPixelGrid;
+
+@implementation YGNodeArena {
+ @package
+  YGArenaRef _arena;
+}
+
+- (instancetype)init {
+  return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+  if (self = [super init]) {
+    _arena = YGArenaNew((uint32_t)capacity);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  YGArenaFree(_arena);
+}
+
+@end
+
+/// The arena set by +[YGLayout allocateNodesInArena:usingBlock:]. Only accessed on main.
+static YGNodeArena *currentNodeArena;
 
 @interface YGLayout ()
 
 @property(nonatomic, weak, readonly) UIView *view;
+/// Keeps the arena alive for as long as the node allocated from it.
+@property(nonatomic, strong, readonly) YGNodeArena *nodeArena;
 
 @end
 
-@implementation YGLayout
+@implementation YGLayout {
+  /// Context and journal of the passes whose frames are applied, created on first use.
+  YGLayoutContextRef _layoutContext;
+  YGLayoutJournalRef _layoutJournal;
+}
 
 @synthesize isEnabled = _isEnabled;
 @synthesize isIncludedInLayout = _isIncludedInLayout;
 @synthesize node = _node;
+@synthesize measureKey = _measureKey;
+@synthesize appliesOnlyChangedFrames = _appliesOnlyChangedFrames;
 
 + (void)initialize {
   globalConfig = YGConfigNew();
   YGConfigSetExperimentalFeatureEnabled(globalConfig, YGExperimentalFeatureWebFlexBasis, true);
 }
 
++ (BOOL)roundsLayoutToPixelGrid {
+  return roundsLayoutToPixelGrid;
+}
+
++ (void)setRoundsLayoutToPixelGrid:(BOOL)roundsToPixelGrid {
+  roundsLayoutToPixelGrid = roundsToPixelGrid;
+  // Frames are rounded to the pixel grid by Yoga, once per pass, and applied as they are.
+  YGConfigSetPointScaleFactor(globalConfig, roundsToPixelGrid ? [UIScreen mainScreen].scale : 1);
+}
+
 - (instancetype)initWithView:(UIView *)view {
   if (self = [super init]) {
     _view = view;
-    _node = YGNodeNewWithConfig(globalConfig);
+    _nodeArena = [NSThread isMainThread] ? currentNodeArena : nil;
+    _node = _nodeArena != nil ? YGNodeNewInArena(_nodeArena->_arena, globalConfig)
+                              : YGNodeNewWithConfig(globalConfig);
     YGNodeSetContext(_node, (__bridge void *)view);
     _isEnabled = false;
     _isIncludedInLayout = true;
@@ -105,7 +152,27 @@ static YGConfigRef globalConfig;
 }
 
 - (void)dealloc {
+  // The arena, if any, is released after the node has been detached.
   YGNodeFree(self.node);
+  if (_layoutContext != NULL) {
+    YGLayoutContextFree(_layoutContext);
+    YGLayoutJournalFree(_layoutJournal);
+  }
+}
+
++ (void)allocateNodesInArena:(YGNodeArena *)arena usingBlock:(NS_NOESCAPE void (^)(void))block {
+  NSAssert([NSThread isMainThread], @"This method must be called on the main thread.");
+  YGNodeArena *const previousArena = currentNodeArena;
+  currentNodeArena = arena;
+  block();
+  currentNodeArena = previousArena;
+}
+
+- (void)performStyleUpdates:(NS_NOESCAPE void (^)(void))block {
+  const YGNodeRef node = self.node;
+  YGNodeStyleBeginUpdate(node);
+  block();
+  YGNodeStyleEndUpdate(node);
 }
 
 - (void)flex {
@@ -131,6 +198,15 @@ static YGConfigRef globalConfig;
   YGNodeMarkDirty(node);
 }
 
+- (void)setMeasureKey:(uint64_t)measureKey {
+  if (_measureKey == measureKey) {
+    return;
+  }
+  _measureKey = measureKey;
+  YGNodeSetMeasureKeyFunc(self.node, measureKey != 0 ? YGMeasureViewKey : nil);
+  [self markDirty];
+}
+
 - (NSUInteger)numberOfChildren {
   return YGNodeGetChildCount(self.node);
 }
@@ -204,13 +280,11 @@ YG_PROPERTY(CGFloat, aspectRatio, AspectRatio)
 }
 
 - (void)applyLayout {
-  [self calculateLayoutWithSize:self.view.bounds.size];
-  YGApplyLayoutToViewHierarchy(self.view, NO);
+  [self applyLayoutWithSize:self.view.bounds.size preservingOrigin:NO];
 }
 
 - (void)applyLayoutPreservingOrigin:(BOOL)preserveOrigin {
-  [self calculateLayoutWithSize:self.view.bounds.size];
-  YGApplyLayoutToViewHierarchy(self.view, preserveOrigin);
+  [self applyLayoutWithSize:self.view.bounds.size preservingOrigin:preserveOrigin];
 }
 
 - (void)applyLayoutPreservingOrigin:(BOOL)preserveOrigin
@@ -222,8 +296,7 @@ YG_PROPERTY(CGFloat, aspectRatio, AspectRatio)
   if (dimensionFlexibility & YGDimensionFlexibilityFlexibleHeigth) {
     size.height = YGUndefined;
   }
-  [self calculateLayoutWithSize:size];
-  YGApplyLayoutToViewHierarchy(self.view, preserveOrigin);
+  [self applyLayoutWithSize:size preservingOrigin:preserveOrigin];
 }
 
 - (CGSize)intrinsicSize {
@@ -231,16 +304,49 @@ YG_PROPERTY(CGFloat, aspectRatio, AspectRatio)
       .width = YGUndefined,
       .height = YGUndefined,
   };
-  return [self calculateLayoutWithSize:constrainedSize];
+  return [self calculateLayoutWithSize:constrainedSize context:NULL];
 }
 
 #pragma mark - Private
 
-- (CGSize)calculateLayoutWithSize:(CGSize)size {
+/// With appliesOnlyChangedFrames, lays the hierarchy out with a journal and only sets the frames of
+/// the views it lists, and the frame of the root view. The journal compares every node with its
+/// frame after the last journaled pass, so the passes of intrinsicSize, which are not applied, are
+/// not missed.
+- (void)applyLayoutWithSize:(CGSize)size preservingOrigin:(BOOL)preserveOrigin {
+  if (!self.appliesOnlyChangedFrames) {
+    [self calculateLayoutWithSize:size context:NULL];
+    YGApplyLayoutToViewHierarchy(self.view, preserveOrigin);
+    return;
+  }
+  if (_layoutContext == NULL) {
+    _layoutContext = YGLayoutContextNew();
+    _layoutJournal = YGLayoutJournalNew();
+    YGLayoutContextSetJournal(_layoutContext, _layoutJournal);
+  }
+  [self calculateLayoutWithSize:size context:_layoutContext];
+
+  if (!self.isIncludedInLayout) {
+    return;
+  }
+  UIView *const view = self.view;
+  const YGNodeRef root = self.node;
+  YGApplyLayoutToView(view, root, preserveOrigin ? view.frame.origin : CGPointZero);
+  const uint32_t count = YGLayoutJournalGetCount(_layoutJournal);
+  for (uint32_t i = 0; i < count; i++) {
+    const YGNodeRef node = YGLayoutJournalGetNode(_layoutJournal, i);
+    if (node != root) {
+      YGApplyLayoutToView((__bridge UIView *)YGNodeGetContext(node), node, CGPointZero);
+    }
+  }
+}
+
+- (CGSize)calculateLayoutWithSize:(CGSize)size context:(YGLayoutContextRef)context {
   NSAssert([NSThread isMainThread], @"Yoga calculation must be done on main.");
   YGAttachNodesFromViewHierachy(self.view);
   const YGNodeRef node = self.node;
-  YGNodeCalculateLayout(node, size.width, size.height, YGNodeStyleGetDirection(node));
+  _lastLayoutStats = YGNodeCalculateLayoutWithContext(node, size.width, size.height,
+                                                      YGNodeStyleGetDirection(node), context);
   return (CGSize){
       .width = YGNodeLayoutGetWidth(node),
       .height = YGNodeLayoutGetHeight(node),
@@ -264,6 +370,11 @@ static YGSize YGMeasureView(YGNodeRef node, float width, YGMeasureMode widthMode
   };
 }
 
+static uint64_t YGMeasureViewKey(YGNodeRef node) {
+  UIView *view = (__bridge UIView *)YGNodeGetContext(node);
+  return view.yoga.measureKey;
+}
+
 static CGFloat YGSanitizeMeasurement(CGFloat constrainedSize, CGFloat measuredSize,
                                      YGMeasureMode measureMode) {
   CGFloat result;
@@ -336,13 +447,23 @@ static CGFloat YGRoundPixelValue(CGFloat value) {
   return roundf(value * scale) / scale;
 }
 
-static void YGApplyLayoutToViewHierarchy(UIView *view, BOOL preserveOrigin) {
+static void YGApplyLayoutToView(UIView *view, const YGNodeRef node, CGPoint origin) {
   NSCAssert([NSThread isMainThread], @"Framesetting should only be done on the main thread.");
-  const YGLayout *yoga = view.yoga;
-  if (!yoga.isIncludedInLayout) {
+  if (roundsLayoutToPixelGrid) {
+    view.frame = (CGRect){
+        .origin =
+            {
+                .x = YGNodeLayoutGetLeft(node) + origin.x,
+                .y = YGNodeLayoutGetTop(node) + origin.y,
+            },
+        .size =
+            {
+                .width = YGNodeLayoutGetWidth(node),
+                .height = YGNodeLayoutGetHeight(node),
+            },
+    };
     return;
   }
-  YGNodeRef node = yoga.node;
   const CGPoint topLeft = {
       YGNodeLayoutGetLeft(node),
       YGNodeLayoutGetTop(node),
@@ -351,7 +472,6 @@ static void YGApplyLayoutToViewHierarchy(UIView *view, BOOL preserveOrigin) {
       topLeft.x + YGNodeLayoutGetWidth(node),
       topLeft.y + YGNodeLayoutGetHeight(node),
   };
-  const CGPoint origin = preserveOrigin ? view.frame.origin : CGPointZero;
   view.frame = (CGRect){
       .origin =
           {
@@ -364,6 +484,14 @@ static void YGApplyLayoutToViewHierarchy(UIView *view, BOOL preserveOrigin) {
               .height = YGRoundPixelValue(bottomRight.y) - YGRoundPixelValue(topLeft.y),
           },
   };
+}
+
+static void YGApplyLayoutToViewHierarchy(UIView *view, BOOL preserveOrigin) {
+  const YGLayout *yoga = view.yoga;
+  if (!yoga.isIncludedInLayout) {
+    return;
+  }
+  YGApplyLayoutToView(view, yoga.node, preserveOrigin ? view.frame.origin : CGPointZero);
   if (!yoga.isLeaf) {
     for (NSUInteger i = 0; i < view.subviews.count; i++) {
       YGApplyLayoutToViewHierarchy(view.subviews[i], NO);
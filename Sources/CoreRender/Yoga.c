@@ -9,7 +9,9 @@
 
 #include "Yoga.h"
 
+#include <stddef.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef _MSC_VER
 #include <float.h>
@@ -29,6 +31,70 @@ __forceinline const float fmaxf(const float a, const float b) {
 #endif
 #endif
 
+// Counters shared by every layout pass in the process. Passes on unrelated
+// trees may run concurrently, so these are only ever updated atomically.
+#ifdef _MSC_VER
+#include <intrin.h>
+#define YG_ATOMIC_INCREMENT(ptr) _InterlockedIncrement((volatile long *)(ptr))
+#define YG_ATOMIC_DECREMENT(ptr) _InterlockedDecrement((volatile long *)(ptr))
+#define YG_ATOMIC_SUBTRACT(ptr, value) \
+  _InterlockedExchangeAdd((volatile long *)(ptr), -(long)(value))
+#define YG_ATOMIC_EXCHANGE_ACQUIRE(ptr, value) \
+  _InterlockedExchange((volatile long *)(ptr), (long)(value))
+#define YG_ATOMIC_STORE_RELEASE(ptr, value) \
+  _InterlockedExchange((volatile long *)(ptr), (long)(value))
+#else
+#define YG_ATOMIC_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define YG_ATOMIC_DECREMENT(ptr) __atomic_sub_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define YG_ATOMIC_SUBTRACT(ptr, value) \
+  __atomic_sub_fetch((ptr), (value), __ATOMIC_RELAXED)
+#define YG_ATOMIC_EXCHANGE_ACQUIRE(ptr, value) \
+  __atomic_exchange_n((ptr), (value), __ATOMIC_ACQUIRE)
+#define YG_ATOMIC_STORE_RELEASE(ptr, value) \
+  __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#endif
+
+#ifdef _MSC_VER
+static inline uint32_t YGPopCount64(uint64_t value) {
+  value = value - ((value >> 1) & 0x5555555555555555ull);
+  value = (value & 0x3333333333333333ull) +
+          ((value >> 2) & 0x3333333333333333ull);
+  value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0full;
+  return (uint32_t)((value * 0x0101010101010101ull) >> 56);
+}
+#else
+#define YGPopCount64(value) ((uint32_t)__builtin_popcountll(value))
+#endif
+
+#ifdef _MSC_VER
+#define YG_ALWAYS_INLINE __forceinline
+#else
+#define YG_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+// Define YG_SPECIALIZE_AXES to compile a copy of the flexbox algorithm for rows
+// and one for columns, in which the axis helpers below are inlined with a
+// constant axis. It makes the layout core larger but every lookup of the axis
+// tables and most tests of the axis are folded at compile time.
+#ifdef YG_SPECIALIZE_AXES
+#define YG_AXIS_INLINE YG_ALWAYS_INLINE
+#else
+#define YG_AXIS_INLINE inline
+#endif
+
+// Vector instructions used to round layouts to the pixel grid. Define
+// YG_NO_SIMD to use the scalar code everywhere.
+#ifndef YG_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YG_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define YG_NEON 1
+#endif
+#endif
+
 typedef struct YGCachedMeasurement {
   float availableWidth;
   float availableHeight;
@@ -39,13 +105,37 @@ typedef struct YGCachedMeasurement {
   float computedHeight;
 } YGCachedMeasurement;
 
+// An entry of the measurement cache of a node. The key hashes the measure
+// modes and the available size rounded to a point, so a lookup compares one
+// integer per entry before it compares the constraints themselves.
+typedef struct YGMeasurementCacheEntry {
+  YGCachedMeasurement measurement;
+  uint32_t key;
+  // Generation of the last pass that used the entry.
+  uint32_t lastUsed;
+} YGMeasurementCacheEntry;
+
 // This value was chosen based on empiracle data. Even the most complicated
 // layouts should not require more than 16 entries to fit within the cache.
-#define YG_MAX_CACHED_RESULT_COUNT 16
+// It is the default capacity, see YGConfigSetMeasurementCacheCapacity.
+#define YG_DEFAULT_CACHED_RESULT_COUNT 16
+#define YG_MAX_CACHED_RESULT_COUNT 256
+
+// Most nodes are only ever measured under a couple of different constraints,
+// so the measurement cache starts small and grows to the maximum on demand.
+#define YG_INITIAL_CACHED_RESULT_COUNT 4
+
+// Containers with more children than this lay them out on the parallel layout
+// pool, if enabled in the config.
+#define YG_DEFAULT_PARALLEL_LAYOUT_GRAIN_SIZE 16
 
 typedef struct YGLayout {
   float position[4];
   float dimensions[2];
+  // Left and top of the node in the tree before the last rounding to the pixel
+  // grid. A relayout boundary is rounded from there, like in a pass from the
+  // root.
+  float absolutePosition[2];
   float margin[6];
   float border[6];
   float padding[6];
@@ -54,19 +144,62 @@ typedef struct YGLayout {
   uint32_t computedFlexBasisGeneration;
   float computedFlexBasis;
   bool hadOverflow;
+  // Whether an ancestor reads the baseline of the node as laid out, and
+  // whether the node was a relayout boundary when it was last laid out, see
+  // YGNodeIsRelayoutBoundary.
+  bool hasBaselineReader;
+  bool isRelayoutBoundary;
 
   // Instead of recomputing the entire layout every single time, we
   // cache some information to break early when nothing changed
   uint32_t generationCount;
   YGDirection lastParentDirection;
 
+  // Entries are stored out of line, see YGNode.cachedMeasurements.
   uint32_t nextCachedMeasurementsIndex;
-  YGCachedMeasurement cachedMeasurements[YG_MAX_CACHED_RESULT_COUNT];
   float measuredDimensions[2];
 
+  // Baseline of the node for the current measured dimensions and child
+  // positions, or NaN until YGBaseline computes it. Cleared whenever either
+  // of them changes.
+  float baseline;
+
   YGCachedMeasurement cachedLayout;
 } YGLayout;
 
+// Style properties that are set per edge.
+typedef enum YGEdgeProperty {
+  YGEdgePropertyMargin,
+  YGEdgePropertyPadding,
+  YGEdgePropertyPosition,
+  YGEdgePropertyBorder,
+  YGEdgePropertyCount,
+} YGEdgeProperty;
+
+// Entries at the start of every YGStyleEdges.values array.
+#define YG_EDGE_VALUE_UNDEFINED 0
+#define YG_EDGE_VALUE_ZERO 1
+#define YG_EDGE_VALUE_FIRST 2
+
+// Values of every YGEdgeProperty of a style, stored sparsely. Most nodes set
+// one or two edges, if any.
+//
+// Bit (property * YGEdgeCount + edge) of setEdges is set for every edge with a
+// value; values holds those values packed in bit order after the two reserved
+// entries. Nodes without any edge share a static values array.
+//
+// resolved maps the left, top, right, bottom, start and end edges of every
+// property to the entry that applies to them once the horizontal, vertical and
+// all shorthands and the defaults have been taken into account. It is rebuilt
+// whenever an edge is written, so layout reads an edge with two loads.
+typedef struct YGStyleEdges {
+  uint64_t setEdges;
+  YGValue *values;
+  uint8_t count;
+  uint8_t capacity;
+  uint8_t resolved[YGEdgePropertyCount][YGEdgeEnd + 1];
+} YGStyleEdges;
+
 typedef struct YGStyle {
   YGDirection direction;
   YGFlexDirection flexDirection;
@@ -82,16 +215,16 @@ typedef struct YGStyle {
   float flexGrow;
   float flexShrink;
   YGValue flexBasis;
-  YGValue margin[YGEdgeCount];
-  YGValue position[YGEdgeCount];
-  YGValue padding[YGEdgeCount];
-  YGValue border[YGEdgeCount];
   YGValue dimensions[2];
   YGValue minDimensions[2];
   YGValue maxDimensions[2];
 
   // Yoga specific properties, not compatible with flexbox specification
   float aspectRatio;
+
+  // Must stay the last member: the rest of the style is compared and copied
+  // as plain memory up to it.
+  YGStyleEdges edges;
 } YGStyle;
 
 typedef struct YGConfig {
@@ -102,44 +235,163 @@ typedef struct YGConfig {
   YGLogger logger;
   YGNodeClonedFunc cloneNodeCallback;
   void *context;
+  bool parallelLayout;
+  uint32_t parallelLayoutGrainSize;
+  uint32_t leafMeasurementCacheCapacity;
+  uint32_t containerMeasurementCacheCapacity;
+  YGCacheEviction measurementCacheEviction;
+  // Layout restored by the first pass over a root, see
+  // YGConfigSetPersistedLayout. Owned by the caller.
+  const void *persistedLayout;
+  size_t persistedLayoutSize;
+  YGTraceFunc traceFunc;
+  void *traceContext;
 } YGConfig;
 
+// Children of a node. Most nodes have at most a few, so they are stored in the
+// list itself; longer lists spill to the heap, or to the arena of the node.
+#define YG_NODE_LIST_INLINE_CAPACITY 3
+
+typedef struct YGNodeList {
+  // Size of the spilled array, 0 while the children are stored inline.
+  uint32_t capacity;
+  uint32_t count;
+  union {
+    YGNodeRef inlineItems[YG_NODE_LIST_INLINE_CAPACITY];
+    YGNodeRef *items;
+  };
+} YGNodeList;
+
 typedef struct YGNode {
   YGStyle style;
   YGLayout layout;
   uint32_t lineIndex;
 
   YGNodeRef parent;
-  YGNodeListRef children;
+  YGNodeList children;
 
   struct YGNode *nextChild;
 
   YGMeasureFunc measure;
+  YGMeasureKeyFunc measureKey;
   YGBaselineFunc baseline;
   YGPrintFunc print;
   YGConfigRef config;
   void *context;
+  // Arena the node was allocated from, NULL for heap allocated nodes.
+  YGArenaRef arena;
+  // Counterpart of the node in the latest capture of a YGSnapshot of its tree,
+  // NULL if it was not part of the tree then.
+  struct YGNode *snapshot;
 
   bool isDirty;
   bool hasNewLayout;
+  // A relayout boundary below the node was dirtied without dirtying the node,
+  // see YGNodeIsRelayoutBoundary.
+  bool hasDirtyBoundary;
+  // Left, top, width and height of the node after the last pass run with a
+  // YGLayoutJournal, compared with its frame after the next one.
+  float journaledFrame[4];
+  // Nesting depth of YGNodeStyleBeginUpdate calls.
+  uint8_t styleUpdateDepth;
   YGNodeType nodeType;
 
   YGValue const *resolvedDimensions[2];
+
+  // Measurement cache, only touched when the node is measured. It lives out
+  // of line so the part of the node read by every pass stays small. Heap
+  // nodes allocate it on first use and grow it up to the capacity set in
+  // their config; arena nodes get it with the node.
+  YGMeasurementCacheEntry *cachedMeasurements;
+  uint32_t cachedMeasurementsCapacity;
+
+  // Style as it was before the first change of the current update, if any.
+  struct YGStyleSnapshot *styleSnapshot;
 } YGNode;
 
+// Bump allocator for whole trees. Memory comes in blocks that are chained
+// together and only released by YGArenaFree.
+typedef struct YGArenaBlock {
+  struct YGArenaBlock *next;
+  size_t size;
+  size_t used;
+} YGArenaBlock;
+
+typedef struct YGArena {
+  YGArenaBlock *block;
+  size_t blockSize;
+  // Nodes allocated from the arena that have not been freed with YGNodeFree.
+  int32_t nodeCount;
+} YGArena;
+
+// State owned by a single layout pass. Every pass gets its own context, which
+// is what makes YGNodeCalculateLayout re-entrant: two passes over unrelated
+// trees never read or write each other's generation or depth.
+// Scratch space of the pixel grid rounding stage. The edges of every node of
+// the tree are gathered in depth-first order, YG_PIXEL_GRID_VALUE_COUNT per
+// node, so the whole tree can be rounded a vector at a time.
+#define YG_PIXEL_GRID_VALUE_COUNT 6
+
+typedef struct YGPixelGridBuffer {
+  uint32_t capacity;
+  uint32_t count;
+  YGNodeRef *nodes;
+  float *values;
+  bool *forceCeil;
+  bool *forceFloor;
+} YGPixelGridBuffer;
+
+// Stack of scratch memory for the containers a pass is laying out. A container
+// takes what it needs on entry and gives it back on exit, so its siblings reuse
+// the same memory. Blocks never move: the containers up the recursion still
+// point into them.
+typedef struct YGScratchStack {
+  // Block allocations are taken from; older blocks follow through next.
+  YGArenaBlock *block;
+  // Blocks given back, kept for the next containers.
+  YGArenaBlock *spare;
+  // Block on the stack of the caller, never freed.
+  YGArenaBlock *inlineBlock;
+} YGScratchStack;
+
+typedef struct YGScratchMark {
+  YGArenaBlock *block;
+  size_t used;
+} YGScratchMark;
+
+typedef struct YGLayoutJournal {
+  YGNodeRef *nodes;
+  uint32_t count;
+  uint32_t capacity;
+} YGLayoutJournal;
+
+typedef struct YGLayoutContext {
+  // Unique id of the pass; nodes visited by it are stamped with this value.
+  uint32_t generationCount;
+  // Current recursion depth, only used to indent debug output.
+  uint32_t depth;
+  // Reused by every pass run with this context.
+  YGPixelGridBuffer pixelGrid;
+  YGScratchStack scratch;
+  // Counters of the pass, returned by YGNodeCalculateLayoutWithContext.
+  YGLayoutStats stats;
+  // Filled at the end of every pass run with this context, if set.
+  YGLayoutJournalRef journal;
+} YGLayoutContext;
+
 #define YG_UNDEFINED_VALUES \
   { .value = YGUndefined, .unit = YGUnitUndefined }
 
 #define YG_AUTO_VALUES \
   { .value = YGUndefined, .unit = YGUnitAuto }
 
-#define YG_DEFAULT_EDGE_VALUES_UNIT                                            \
-  {                                                                            \
-    [YGEdgeLeft] = YG_UNDEFINED_VALUES, [YGEdgeTop] = YG_UNDEFINED_VALUES,     \
-    [YGEdgeRight] = YG_UNDEFINED_VALUES, [YGEdgeBottom] = YG_UNDEFINED_VALUES, \
-    [YGEdgeStart] = YG_UNDEFINED_VALUES, [YGEdgeEnd] = YG_UNDEFINED_VALUES,    \
-    [YGEdgeHorizontal] = YG_UNDEFINED_VALUES,                                  \
-    [YGEdgeVertical] = YG_UNDEFINED_VALUES, [YGEdgeAll] = YG_UNDEFINED_VALUES, \
+// Physical edges default to zero, start and end to undefined.
+#define YG_DEFAULT_RESOLVED_EDGES                                            \
+  {                                                                          \
+    [YGEdgeLeft] = YG_EDGE_VALUE_ZERO, [YGEdgeTop] = YG_EDGE_VALUE_ZERO,     \
+    [YGEdgeRight] = YG_EDGE_VALUE_ZERO, [YGEdgeBottom] = YG_EDGE_VALUE_ZERO, \
+    [YGEdgeStart] = YG_EDGE_VALUE_UNDEFINED,                                 \
+    [YGEdgeEnd] = YG_EDGE_VALUE_UNDEFINED,                                   \
   }
 
 #define YG_DEFAULT_DIMENSION_VALUES \
@@ -154,15 +406,25 @@ typedef struct YGNode {
 #define YG_DEFAULT_DIMENSION_VALUES_AUTO_UNIT \
   { [YGDimensionWidth] = YG_AUTO_VALUES, [YGDimensionHeight] = YG_AUTO_VALUES, }
 
+// Shared by every style without edges. Never written to.
+static YGValue gYGDefaultEdgeValues[YG_EDGE_VALUE_FIRST] = {
+    [YG_EDGE_VALUE_UNDEFINED] = YG_UNDEFINED_VALUES,
+    [YG_EDGE_VALUE_ZERO] = {.value = 0, .unit = YGUnitPoint},
+};
+
 static const float kDefaultFlexGrow = 0.0f;
 static const float kDefaultFlexShrink = 0.0f;
 static const float kWebDefaultFlexShrink = 1.0f;
 
 static const YGNode gYGNodeDefaults = {
     .parent = NULL,
-    .children = NULL,
+    .children = {.capacity = 0, .count = 0},
+    .arena = NULL,
+    .snapshot = NULL,
     .hasNewLayout = true,
     .isDirty = false,
+    .hasDirtyBoundary = false,
+    .journaledFrame = {YGUndefined, YGUndefined, YGUndefined, YGUndefined},
     .nodeType = YGNodeTypeDefault,
     .resolvedDimensions = {[YGDimensionWidth] = &YGValueUndefined,
                            [YGDimensionHeight] = &YGValueUndefined},
@@ -183,11 +445,22 @@ static const YGNode gYGNodeDefaults = {
             .dimensions = YG_DEFAULT_DIMENSION_VALUES_AUTO_UNIT,
             .minDimensions = YG_DEFAULT_DIMENSION_VALUES_UNIT,
             .maxDimensions = YG_DEFAULT_DIMENSION_VALUES_UNIT,
-            .position = YG_DEFAULT_EDGE_VALUES_UNIT,
-            .margin = YG_DEFAULT_EDGE_VALUES_UNIT,
-            .padding = YG_DEFAULT_EDGE_VALUES_UNIT,
-            .border = YG_DEFAULT_EDGE_VALUES_UNIT,
             .aspectRatio = YGUndefined,
+            .edges =
+                {
+                    .setEdges = 0,
+                    .values = gYGDefaultEdgeValues,
+                    .count = 0,
+                    .capacity = 0,
+                    .resolved =
+                        {
+                            [YGEdgePropertyMargin] = YG_DEFAULT_RESOLVED_EDGES,
+                            [YGEdgePropertyPadding] = YG_DEFAULT_RESOLVED_EDGES,
+                            // Positions default to undefined on every edge.
+                            [YGEdgePropertyPosition] = {0},
+                            [YGEdgePropertyBorder] = YG_DEFAULT_RESOLVED_EDGES,
+                        },
+                },
         },
 
     .layout =
@@ -198,6 +471,7 @@ static const YGNode gYGNodeDefaults = {
             .computedFlexBasis = YGUndefined,
             .hadOverflow = false,
             .measuredDimensions = YG_DEFAULT_DIMENSION_VALUES,
+            .baseline = YGUndefined,
 
             .cachedLayout =
                 {
@@ -207,6 +481,9 @@ static const YGNode gYGNodeDefaults = {
                     .computedHeight = -1,
                 },
         },
+
+    .cachedMeasurements = NULL,
+    .cachedMeasurementsCapacity = 0,
 };
 
 #ifdef ANDROID
@@ -221,6 +498,7 @@ static YGConfig gYGConfigDefaults = {
     .experimentalFeatures =
         {
             [YGExperimentalFeatureWebFlexBasis] = false,
+            [YGExperimentalFeatureSpecFlexibleLengths] = false,
         },
     .useWebDefaults = false,
     .pointScaleFactor = 1.0f,
@@ -230,9 +508,21 @@ static YGConfig gYGConfigDefaults = {
     .logger = &YGDefaultLog,
 #endif
     .context = NULL,
+    .parallelLayout = false,
+    .parallelLayoutGrainSize = YG_DEFAULT_PARALLEL_LAYOUT_GRAIN_SIZE,
+    .leafMeasurementCacheCapacity = YG_DEFAULT_CACHED_RESULT_COUNT,
+    .containerMeasurementCacheCapacity = YG_DEFAULT_CACHED_RESULT_COUNT,
+    .measurementCacheEviction = YGCacheEvictionRoundRobin,
+    .persistedLayout = NULL,
+    .persistedLayoutSize = 0,
+    .traceFunc = NULL,
+    .traceContext = NULL,
 };
 
 static void YGNodeMarkDirtyInternal(const YGNodeRef node);
+static void YGNodeUpdateBaselineReader(const YGNodeRef node);
+static void YGNodeStyleWillChange(const YGNodeRef node);
+static inline void YGResolveDimensions(YGNodeRef node);
 
 YGMalloc gYGMalloc = &malloc;
 YGCalloc gYGCalloc = &calloc;
@@ -286,35 +576,6 @@ static int YGDefaultLog(const YGConfigRef config, const YGNodeRef node,
 }
 #endif
 
-static inline const YGValue *YGComputedEdgeValue(
-    const YGValue edges[YGEdgeCount], const YGEdge edge,
-    const YGValue *const defaultValue) {
-  if (edges[edge].unit != YGUnitUndefined) {
-    return &edges[edge];
-  }
-
-  if ((edge == YGEdgeTop || edge == YGEdgeBottom) &&
-      edges[YGEdgeVertical].unit != YGUnitUndefined) {
-    return &edges[YGEdgeVertical];
-  }
-
-  if ((edge == YGEdgeLeft || edge == YGEdgeRight || edge == YGEdgeStart ||
-       edge == YGEdgeEnd) &&
-      edges[YGEdgeHorizontal].unit != YGUnitUndefined) {
-    return &edges[YGEdgeHorizontal];
-  }
-
-  if (edges[YGEdgeAll].unit != YGUnitUndefined) {
-    return &edges[YGEdgeAll];
-  }
-
-  if (edge == YGEdgeStart || edge == YGEdgeEnd) {
-    return &YGValueUndefined;
-  }
-
-  return defaultValue;
-}
-
 static inline float YGResolveValue(const YGValue *const value,
                                    const float parentSize) {
   switch (value->unit) {
@@ -337,11 +598,8 @@ static inline float YGResolveValueMargin(const YGValue *const value,
 int32_t gNodeInstanceCount = 0;
 int32_t gConfigInstanceCount = 0;
 
-WIN_EXPORT YGNodeRef YGNodeNewWithConfig(const YGConfigRef config) {
-  const YGNodeRef node = gYGMalloc(sizeof(YGNode));
-  YGAssertWithConfig(config, node != NULL,
-                     "Could not allocate memory for node");
-  gNodeInstanceCount++;
+static void YGNodeInit(const YGNodeRef node, const YGConfigRef config) {
+  YG_ATOMIC_INCREMENT(&gNodeInstanceCount);
 
   memcpy(node, &gYGNodeDefaults, sizeof(YGNode));
   if (config->useWebDefaults) {
@@ -349,6 +607,341 @@ WIN_EXPORT YGNodeRef YGNodeNewWithConfig(const YGConfigRef config) {
     node->style.alignContent = YGAlignStretch;
   }
   node->config = config;
+}
+
+WIN_EXPORT YGNodeRef YGNodeNewWithConfig(const YGConfigRef config) {
+  const YGNodeRef node = gYGMalloc(sizeof(YGNode));
+  YGAssertWithConfig(config, node != NULL,
+                     "Could not allocate memory for node");
+  YGNodeInit(node, config);
+  return node;
+}
+
+// Offset of the first allocation in a block; keeps allocations 16 byte
+// aligned.
+#define YG_ARENA_ALIGNMENT 16
+#define YG_ARENA_ALIGN(size) \
+  (((size) + YG_ARENA_ALIGNMENT - 1) & ~(size_t)(YG_ARENA_ALIGNMENT - 1))
+#define YG_ARENA_BLOCK_HEADER_SIZE YG_ARENA_ALIGN(sizeof(YGArenaBlock))
+
+YGArenaRef YGArenaNew(const uint32_t nodeCapacity) {
+  const YGArenaRef arena = gYGMalloc(sizeof(YGArena));
+  YGAssert(arena != NULL, "Could not allocate memory for arena");
+
+  arena->block = NULL;
+  // Room for the nodes and their measurement caches. Child lists are stored
+  // in the nodes unless they are long.
+  const size_t nodeSize = YG_ARENA_ALIGN(sizeof(YGNode)) +
+                          YG_ARENA_ALIGN(YG_DEFAULT_CACHED_RESULT_COUNT *
+                                         sizeof(YGMeasurementCacheEntry));
+  arena->blockSize = nodeSize * (nodeCapacity > 0 ? nodeCapacity : 64);
+  arena->nodeCount = 0;
+  return arena;
+}
+
+void YGArenaFree(const YGArenaRef arena) {
+  // Nodes that were never freed individually are released with their blocks.
+  YG_ATOMIC_SUBTRACT(&gNodeInstanceCount, arena->nodeCount);
+  YGArenaBlock *block = arena->block;
+  while (block != NULL) {
+    YGArenaBlock *const next = block->next;
+    gYGFree(block);
+    block = next;
+  }
+  gYGFree(arena);
+}
+
+static void *YGArenaAllocate(const YGArenaRef arena, const size_t size) {
+  const size_t alignedSize = YG_ARENA_ALIGN(size);
+  YGArenaBlock *block = arena->block;
+  if (block == NULL || block->used + alignedSize > block->size) {
+    const size_t blockSize =
+        alignedSize > arena->blockSize ? alignedSize : arena->blockSize;
+    block = gYGMalloc(YG_ARENA_BLOCK_HEADER_SIZE + blockSize);
+    YGAssert(block != NULL, "Could not allocate memory for arena block");
+    block->next = arena->block;
+    block->size = blockSize;
+    block->used = 0;
+    arena->block = block;
+  }
+  void *const pointer =
+      (char *)block + YG_ARENA_BLOCK_HEADER_SIZE + block->used;
+  block->used += alignedSize;
+  return pointer;
+}
+
+// Room for the flex items of a few hundred children.
+#define YG_SCRATCH_BLOCK_SIZE 16384
+
+// Short-lived contexts start with a block on the stack, large enough for most
+// trees, so that their passes don't allocate. It is aligned like a double,
+// which is all the buffers taken from scratch memory need.
+#define YG_SCRATCH_INLINE_SIZE 4096
+
+typedef union YGScratchInlineBlock {
+  YGArenaBlock block;
+  double storage[(YG_ARENA_BLOCK_HEADER_SIZE + YG_SCRATCH_INLINE_SIZE) /
+                 sizeof(double)];
+} YGScratchInlineBlock;
+
+static void YGScratchStackInit(YGScratchStack *const stack,
+                               YGScratchInlineBlock *const inlineBlock) {
+  inlineBlock->block.next = NULL;
+  inlineBlock->block.size = YG_SCRATCH_INLINE_SIZE;
+  inlineBlock->block.used = 0;
+  stack->block = NULL;
+  stack->spare = &inlineBlock->block;
+  stack->inlineBlock = &inlineBlock->block;
+}
+
+static inline YGScratchMark YGScratchStackMark(
+    const YGScratchStack *const stack) {
+  return (YGScratchMark){
+      .block = stack->block,
+      .used = stack->block != NULL ? stack->block->used : 0,
+  };
+}
+
+static void *YGScratchStackAllocate(YGScratchStack *const stack,
+                                    const size_t size) {
+  const size_t alignedSize = YG_ARENA_ALIGN(size);
+  YGArenaBlock *block = stack->block;
+  if (block == NULL || block->used + alignedSize > block->size) {
+    block = stack->spare;
+    if (block != NULL && block->size >= alignedSize) {
+      stack->spare = block->next;
+    } else {
+      const size_t blockSize = alignedSize > YG_SCRATCH_BLOCK_SIZE
+                                   ? alignedSize
+                                   : YG_SCRATCH_BLOCK_SIZE;
+      block = gYGMalloc(YG_ARENA_BLOCK_HEADER_SIZE + blockSize);
+      YGAssert(block != NULL, "Could not allocate memory for layout scratch");
+      block->size = blockSize;
+    }
+    block->next = stack->block;
+    block->used = 0;
+    stack->block = block;
+  }
+  void *const pointer =
+      (char *)block + YG_ARENA_BLOCK_HEADER_SIZE + block->used;
+  block->used += alignedSize;
+  return pointer;
+}
+
+// Gives back everything allocated since |mark| was taken.
+static void YGScratchStackRelease(YGScratchStack *const stack,
+                                  const YGScratchMark mark) {
+  while (stack->block != mark.block) {
+    YGArenaBlock *const block = stack->block;
+    stack->block = block->next;
+    block->next = stack->spare;
+    stack->spare = block;
+  }
+  if (mark.block != NULL) {
+    mark.block->used = mark.used;
+  }
+}
+
+static void YGScratchStackFree(YGScratchStack *const stack) {
+  YGScratchStackRelease(stack, (YGScratchMark){.block = NULL, .used = 0});
+  while (stack->spare != NULL) {
+    YGArenaBlock *const next = stack->spare->next;
+    if (stack->spare != stack->inlineBlock) {
+      gYGFree(stack->spare);
+    }
+    stack->spare = next;
+  }
+}
+
+// YGNodeList
+
+static inline uint32_t YGNodeListCapacity(const YGNodeList *const list) {
+  return list->capacity > 0 ? list->capacity : YG_NODE_LIST_INLINE_CAPACITY;
+}
+
+// The children of the list, contiguous in memory.
+static inline YGNodeRef *YGNodeListItems(YGNodeList *const list) {
+  return list->capacity > 0 ? list->items : list->inlineItems;
+}
+
+static inline uint32_t YGNodeListCount(const YGNodeList *const list) {
+  return list->count;
+}
+
+static inline YGNodeRef YGNodeListGet(YGNodeList *const list,
+                                      const uint32_t index) {
+  return index < list->count ? YGNodeListItems(list)[index] : NULL;
+}
+
+// Doubles the room for children, moving them out of the list itself the first
+// time. Arena memory can't be resized; the old items stay in the arena until
+// it is freed.
+static void YGNodeListGrow(YGNodeList *const list, const YGArenaRef arena) {
+  const uint32_t capacity = YGNodeListCapacity(list) * 2;
+  const size_t size = capacity * sizeof(YGNodeRef);
+  YGNodeRef *items;
+  if (arena != NULL || list->capacity == 0) {
+    items = arena != NULL ? YGArenaAllocate(arena, size) : gYGMalloc(size);
+    YGAssert(items != NULL, "Could not allocate memory for items");
+    memcpy(items, YGNodeListItems(list), list->count * sizeof(YGNodeRef));
+  } else {
+    items = gYGRealloc(list->items, size);
+    YGAssert(items != NULL, "Could not extend allocation for items");
+  }
+  list->items = items;
+  list->capacity = capacity;
+}
+
+static void YGNodeListInsert(YGNodeList *const list, const YGNodeRef node,
+                             const uint32_t index, const YGArenaRef arena) {
+  if (list->count == YGNodeListCapacity(list)) {
+    YGNodeListGrow(list, arena);
+  }
+  YGNodeRef *const items = YGNodeListItems(list);
+  memmove(&items[index + 1], &items[index],
+          (list->count - index) * sizeof(YGNodeRef));
+  items[index] = node;
+  list->count++;
+}
+
+static inline void YGNodeListReplace(YGNodeList *const list,
+                                     const uint32_t index,
+                                     const YGNodeRef newNode) {
+  YGNodeListItems(list)[index] = newNode;
+}
+
+static inline void YGNodeListRemoveAll(YGNodeList *const list) {
+  list->count = 0;
+}
+
+static YGNodeRef YGNodeListRemove(YGNodeList *const list,
+                                  const uint32_t index) {
+  YGNodeRef *const items = YGNodeListItems(list);
+  const YGNodeRef removed = items[index];
+  memmove(&items[index], &items[index + 1],
+          (list->count - index - 1) * sizeof(YGNodeRef));
+  list->count--;
+  return removed;
+}
+
+static YGNodeRef YGNodeListDelete(YGNodeList *const list,
+                                  const YGNodeRef node) {
+  const YGNodeRef *const items = YGNodeListItems(list);
+  for (uint32_t i = 0; i < list->count; i++) {
+    if (items[i] == node) {
+      return YGNodeListRemove(list, i);
+    }
+  }
+  return NULL;
+}
+
+// Gives |list|, a bitwise copy of another list, storage of its own.
+static void YGNodeListDetach(YGNodeList *const list) {
+  if (list->capacity == 0) {
+    return;
+  }
+  const YGNodeRef *const items = list->items;
+  list->capacity = 0;
+  if (list->count > YG_NODE_LIST_INLINE_CAPACITY) {
+    list->items = gYGMalloc(list->count * sizeof(YGNodeRef));
+    YGAssert(list->items != NULL, "Could not allocate memory for items");
+    list->capacity = list->count;
+  }
+  memcpy(YGNodeListItems(list), items, list->count * sizeof(YGNodeRef));
+}
+
+static void YGNodeListFree(YGNodeList *const list, const YGArenaRef arena) {
+  if (list->capacity > 0 && arena == NULL) {
+    gYGFree(list->items);
+  }
+  list->capacity = 0;
+  list->count = 0;
+}
+
+// Allocates out of line data owned by |node|, from its arena if it has one.
+static void *YGNodeAllocateColdData(const YGNodeRef node, const size_t size) {
+  void *const pointer = node->arena != NULL
+                            ? YGArenaAllocate(node->arena, size)
+                            : gYGMalloc(size);
+  YGAssertWithNode(node, pointer != NULL,
+                   "Could not allocate memory for node data");
+  return pointer;
+}
+
+static void YGNodeFreeColdData(const YGNodeRef node) {
+  if (node->arena != NULL) {
+    return;
+  }
+  if (node->cachedMeasurements != NULL) {
+    gYGFree(node->cachedMeasurements);
+  }
+  if (node->style.edges.capacity > 0) {
+    gYGFree(node->style.edges.values);
+  }
+}
+
+// Gives |node| its own copy of the out of line data of |oldNode|.
+static void YGNodeCloneColdData(const YGNodeRef node, const YGNodeRef oldNode) {
+  node->cachedMeasurements = NULL;
+  node->cachedMeasurementsCapacity = 0;
+  if (oldNode->cachedMeasurementsCapacity > 0) {
+    const size_t size =
+        oldNode->cachedMeasurementsCapacity * sizeof(YGMeasurementCacheEntry);
+    node->cachedMeasurements = YGNodeAllocateColdData(node, size);
+    node->cachedMeasurementsCapacity = oldNode->cachedMeasurementsCapacity;
+    memcpy(node->cachedMeasurements, oldNode->cachedMeasurements, size);
+  }
+  if (oldNode->style.edges.capacity > 0) {
+    const size_t size = oldNode->style.edges.capacity * sizeof(YGValue);
+    node->style.edges.values = YGNodeAllocateColdData(node, size);
+    memcpy(node->style.edges.values, oldNode->style.edges.values, size);
+  }
+}
+
+// Number of measurements |node| may keep. Nodes with a measure function are
+// the expensive ones to measure, so their config may let them keep more.
+static inline uint32_t YGNodeMeasurementCacheLimit(const YGNodeRef node) {
+  const uint32_t limit = node->measure != NULL
+                             ? node->config->leafMeasurementCacheCapacity
+                             : node->config->containerMeasurementCacheCapacity;
+  // Arena nodes cannot grow their cache, see YGNodeGrowCachedMeasurements.
+  return node->arena != NULL && node->cachedMeasurementsCapacity < limit
+             ? node->cachedMeasurementsCapacity
+             : limit;
+}
+
+// Makes room for at least one more measurement cache entry, up to |limit|.
+// Only called for heap nodes: arena nodes start with the largest capacity of
+// their config, because layout may run on several threads and the arena is
+// not thread safe.
+static void YGNodeGrowCachedMeasurements(const YGNodeRef node,
+                                         const uint32_t limit) {
+  uint32_t capacity = node->cachedMeasurementsCapacity == 0
+                          ? YG_INITIAL_CACHED_RESULT_COUNT
+                          : node->cachedMeasurementsCapacity * 4;
+  if (capacity > limit) {
+    capacity = limit;
+  }
+  node->cachedMeasurements = gYGRealloc(
+      node->cachedMeasurements, capacity * sizeof(YGMeasurementCacheEntry));
+  YGAssertWithNode(node, node->cachedMeasurements != NULL,
+                   "Could not allocate memory for measurement cache");
+  node->cachedMeasurementsCapacity = capacity;
+}
+
+YGNodeRef YGNodeNewInArena(const YGArenaRef arena, const YGConfigRef config) {
+  const YGNodeRef node = YGArenaAllocate(arena, sizeof(YGNode));
+  YGNodeInit(node, config);
+  node->arena = arena;
+  const uint32_t capacity =
+      node->config->leafMeasurementCacheCapacity >
+              node->config->containerMeasurementCacheCapacity
+          ? node->config->leafMeasurementCacheCapacity
+          : node->config->containerMeasurementCacheCapacity;
+  node->cachedMeasurements =
+      YGArenaAllocate(arena, capacity * sizeof(YGMeasurementCacheEntry));
+  node->cachedMeasurementsCapacity = capacity;
+  arena->nodeCount++;
   return node;
 }
 
@@ -358,17 +951,22 @@ YGNodeRef YGNodeClone(const YGNodeRef oldNode) {
   const YGNodeRef node = gYGMalloc(sizeof(YGNode));
   YGAssertWithConfig(oldNode->config, node != NULL,
                      "Could not allocate memory for node");
-  gNodeInstanceCount++;
+  YG_ATOMIC_INCREMENT(&gNodeInstanceCount);
 
   memcpy(node, oldNode, sizeof(YGNode));
-  node->children = YGNodeListClone(oldNode->children);
+  YGNodeListDetach(&node->children);
   node->parent = NULL;
+  node->arena = NULL;
+  node->snapshot = NULL;
+  node->styleUpdateDepth = 0;
+  node->styleSnapshot = NULL;
+  YGNodeCloneColdData(node, oldNode);
   return node;
 }
 
 void YGNodeFree(const YGNodeRef node) {
   if (node->parent) {
-    YGNodeListDelete(node->parent->children, node);
+    YGNodeListDelete(&node->parent->children, node);
     node->parent = NULL;
   }
 
@@ -376,11 +974,19 @@ void YGNodeFree(const YGNodeRef node) {
   for (uint32_t i = 0; i < childCount; i++) {
     const YGNodeRef child = YGNodeGetChild(node, i);
     child->parent = NULL;
+    child->snapshot = NULL;
   }
 
-  YGNodeListFree(node->children);
-  gYGFree(node);
-  gNodeInstanceCount--;
+  YGNodeListFree(&node->children, node->arena);
+  gYGFree(node->styleSnapshot);
+  if (node->arena != NULL) {
+    // The memory is reclaimed when the whole arena is freed.
+    node->arena->nodeCount--;
+  } else {
+    YGNodeFreeColdData(node);
+    gYGFree(node);
+  }
+  YG_ATOMIC_DECREMENT(&gNodeInstanceCount);
 }
 
 void YGNodeFreeRecursive(const YGNodeRef root) {
@@ -402,15 +1008,26 @@ void YGNodeReset(const YGNodeRef node) {
   YGAssertWithNode(node, node->parent == NULL,
                    "Cannot reset a node still attached to a parent");
 
-  YGNodeListFree(node->children);
+  YGNodeListFree(&node->children, node->arena);
+  gYGFree(node->styleSnapshot);
+  if (node->arena == NULL && node->style.edges.capacity > 0) {
+    gYGFree(node->style.edges.values);
+  }
 
   const YGConfigRef config = node->config;
+  const YGArenaRef arena = node->arena;
+  // The cache is emptied along with the layout, its storage can be reused.
+  YGMeasurementCacheEntry *const cachedMeasurements = node->cachedMeasurements;
+  const uint32_t cachedMeasurementsCapacity = node->cachedMeasurementsCapacity;
   memcpy(node, &gYGNodeDefaults, sizeof(YGNode));
   if (config->useWebDefaults) {
     node->style.flexDirection = YGFlexDirectionRow;
     node->style.alignContent = YGAlignStretch;
   }
   node->config = config;
+  node->arena = arena;
+  node->cachedMeasurements = cachedMeasurements;
+  node->cachedMeasurementsCapacity = cachedMeasurementsCapacity;
 }
 
 int32_t YGNodeGetInstanceCount(void) { return gNodeInstanceCount; }
@@ -424,30 +1041,75 @@ YGConfigRef YGConfigNew(void) {
   const YGConfigRef config = gYGMalloc(sizeof(YGConfig));
   YGAssert(config != NULL, "Could not allocate memory for config");
 
-  gConfigInstanceCount++;
+  YG_ATOMIC_INCREMENT(&gConfigInstanceCount);
   memcpy(config, &gYGConfigDefaults, sizeof(YGConfig));
   return config;
 }
 
 void YGConfigFree(const YGConfigRef config) {
   gYGFree(config);
-  gConfigInstanceCount--;
+  YG_ATOMIC_DECREMENT(&gConfigInstanceCount);
 }
 
 void YGConfigCopy(const YGConfigRef dest, const YGConfigRef src) {
   memcpy(dest, src, sizeof(YGConfig));
 }
 
+// Flags the ancestors of |node| up to the first one already flagged, so that
+// YGNodeCalculateLayout finds the dirty relayout boundary below them.
+static void YGNodeFlagDirtyBoundary(const YGNodeRef node) {
+  YGNodeRef parent = node->parent;
+  while (parent != NULL && !parent->hasDirtyBoundary) {
+    parent->hasDirtyBoundary = true;
+    parent = parent->parent;
+  }
+}
+
+// Marks |node| dirty after its content changed. The dirt stops at a relayout
+// boundary, whose parent lays it out at the same size whatever its content.
 static void YGNodeMarkDirtyInternal(const YGNodeRef node) {
   if (!node->isDirty) {
     node->isDirty = true;
     node->layout.computedFlexBasis = YGUndefined;
-    if (node->parent) {
+    if (node->layout.isRelayoutBoundary) {
+      YGNodeFlagDirtyBoundary(node);
+    } else if (node->parent) {
       YGNodeMarkDirtyInternal(node->parent);
     }
   }
 }
 
+// Marks |node| dirty after its style changed. The change may resize the node,
+// so its parent is dirtied even if the node is a relayout boundary. It is also
+// dirtied if the node already was, as a pass can leave a node dirty below clean
+// ancestors, e.g. below a node that is not displayed.
+static void YGNodeMarkStyleDirty(const YGNodeRef node) {
+  node->isDirty = true;
+  node->layout.computedFlexBasis = YGUndefined;
+  if (node->parent) {
+    YGNodeMarkDirtyInternal(node->parent);
+  }
+}
+
+// Dirties every ancestor of |node|, through relayout boundaries.
+static void YGNodeMarkAncestorsDirty(const YGNodeRef node) {
+  for (YGNodeRef parent = node->parent; parent != NULL;
+       parent = parent->parent) {
+    parent->isDirty = true;
+    parent->layout.computedFlexBasis = YGUndefined;
+  }
+}
+
+// Clears the memoised baseline of the node and of every ancestor whose
+// baseline may have been derived from it. Nothing above an ancestor without a
+// baseline has read it since it was cleared, so the walk stops there.
+static void YGNodeInvalidateBaselines(YGNodeRef node) {
+  while (node != NULL && !YGFloatIsUndefined(node->layout.baseline)) {
+    node->layout.baseline = YGUndefined;
+    node = node->parent;
+  }
+}
+
 void YGNodeSetMeasureFunc(const YGNodeRef node, YGMeasureFunc measureFunc) {
   if (measureFunc == NULL) {
     node->measure = NULL;
@@ -467,7 +1129,11 @@ YGMeasureFunc YGNodeGetMeasureFunc(const YGNodeRef node) {
 }
 
 void YGNodeSetBaselineFunc(const YGNodeRef node, YGBaselineFunc baselineFunc) {
-  node->baseline = baselineFunc;
+  if (node->baseline != baselineFunc) {
+    YGNodeInvalidateBaselines(node);
+    node->baseline = baselineFunc;
+    YGNodeUpdateBaselineReader(node);
+  }
 }
 
 YGBaselineFunc YGNodeGetBaselineFunc(const YGNodeRef node) {
@@ -491,7 +1157,7 @@ static void YGCloneChildrenIfNeeded(const YGNodeRef parent) {
     return;
   }
   const YGNodeClonedFunc cloneNodeCallback = parent->config->cloneNodeCallback;
-  const YGNodeListRef children = parent->children;
+  YGNodeList *const children = &parent->children;
   for (uint32_t i = 0; i < childCount; i++) {
     const YGNodeRef oldChild = YGNodeListGet(children, i);
     const YGNodeRef newChild = YGNodeClone(oldChild);
@@ -513,9 +1179,12 @@ void YGNodeInsertChild(const YGNodeRef node, const YGNodeRef child,
 
   YGCloneChildrenIfNeeded(node);
 
-  YGNodeListInsert(&node->children, child, index);
+  YGNodeListInsert(&node->children, child, index, node->arena);
   child->parent = node;
   YGNodeMarkDirtyInternal(node);
+  if (child->hasDirtyBoundary) {
+    YGNodeFlagDirtyBoundary(child);
+  }
 }
 
 void YGNodeRemoveChild(const YGNodeRef parent, const YGNodeRef excludedChild) {
@@ -530,10 +1199,11 @@ void YGNodeRemoveChild(const YGNodeRef parent, const YGNodeRef excludedChild) {
   if (firstChild->parent == parent) {
     // If the first child has this node as its parent, we assume that it is
     // already unique. We can now try to delete a child in this list.
-    if (YGNodeListDelete(parent->children, excludedChild) != NULL) {
+    if (YGNodeListDelete(&parent->children, excludedChild) != NULL) {
       excludedChild->layout =
           gYGNodeDefaults.layout;  // layout is no longer valid
       excludedChild->parent = NULL;
+      excludedChild->snapshot = NULL;
       YGNodeMarkDirtyInternal(parent);
     }
     return;
@@ -542,7 +1212,7 @@ void YGNodeRemoveChild(const YGNodeRef parent, const YGNodeRef excludedChild) {
   // to delete. We don't want to simply clone all children, because then the
   // host will need to free the clone of the child that was just deleted.
   const YGNodeClonedFunc cloneNodeCallback = parent->config->cloneNodeCallback;
-  const YGNodeListRef children = parent->children;
+  YGNodeList *const children = &parent->children;
   uint32_t nextInsertIndex = 0;
   for (uint32_t i = 0; i < childCount; i++) {
     const YGNodeRef oldChild = YGNodeListGet(children, i);
@@ -581,25 +1251,210 @@ void YGNodeRemoveAllChildren(const YGNodeRef parent) {
       const YGNodeRef oldChild = YGNodeGetChild(parent, i);
       oldChild->layout = gYGNodeDefaults.layout;  // layout is no longer valid
       oldChild->parent = NULL;
+      oldChild->snapshot = NULL;
     }
-    YGNodeListRemoveAll(parent->children);
+    YGNodeListRemoveAll(&parent->children);
     YGNodeMarkDirtyInternal(parent);
     return;
   }
   // Otherwise, we are not the owner of the child set. We don't have to do
   // anything to clear it.
-  parent->children = NULL;
+  YGNodeListRemoveAll(&parent->children);
   YGNodeMarkDirtyInternal(parent);
 }
 
 YGNodeRef YGNodeGetChild(const YGNodeRef node, const uint32_t index) {
-  return YGNodeListGet(node->children, index);
+  return YGNodeListGet(&node->children, index);
 }
 
 YGNodeRef YGNodeGetParent(const YGNodeRef node) { return node->parent; }
 
 uint32_t YGNodeGetChildCount(const YGNodeRef node) {
-  return YGNodeListCount(node->children);
+  return YGNodeListCount(&node->children);
+}
+
+// YGSnapshot
+
+typedef struct YGSnapshot {
+  YGNodeRef root;
+  // Root of the latest capture, NULL until the first one.
+  YGNodeRef version;
+} YGSnapshot;
+
+YGSnapshotRef YGSnapshotNew(const YGNodeRef root) {
+  YGAssertWithNode(root, root->parent == NULL,
+                   "Only the root of a tree can be snapshotted");
+  const YGSnapshotRef snapshot = gYGMalloc(sizeof(YGSnapshot));
+  YGAssertWithNode(root, snapshot != NULL,
+                   "Could not allocate memory for snapshot");
+  snapshot->root = root;
+  snapshot->version = NULL;
+  return snapshot;
+}
+
+// Counterpart of |child|, the child at |index| of a node whose counterpart is
+// |version|, or NULL if it was not a child of that node when |version| was
+// captured. Children are usually where they were, so |index| is tried first.
+static YGNodeRef YGSnapshotFindChild(const YGNodeRef version,
+                                     const YGNodeRef child,
+                                     const uint32_t index) {
+  if (version == NULL || child->snapshot == NULL) {
+    return NULL;
+  }
+  const YGNodeRef *const items = YGNodeListItems(&version->children);
+  const uint32_t count = YGNodeListCount(&version->children);
+  if (index < count && items[index] == child->snapshot) {
+    return child->snapshot;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (items[i] == child->snapshot) {
+      return child->snapshot;
+    }
+  }
+  return NULL;
+}
+
+// Returns the counterpart of |node| in a new version, given its counterpart
+// |previous| in the previous one. A clean node was not edited since, and
+// neither was anything below it, so its counterpart is shared as is. Edits
+// dirty or flag every ancestor, so only the spines above them are cloned.
+static YGNodeRef YGSnapshotCaptureNode(const YGNodeRef node,
+                                       const YGNodeRef previous) {
+  if (previous != NULL && !node->isDirty && !node->hasDirtyBoundary) {
+    return previous;
+  }
+  const YGNodeRef version = YGNodeClone(node);
+  YGResolveDimensions(version);
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(&node->children, i);
+    const YGNodeRef versionChild = YGSnapshotCaptureNode(
+        child, YGSnapshotFindChild(previous, child, i));
+    // Shared nodes are adopted, the version they come from is freed.
+    YGNodeListReplace(&version->children, i, versionChild);
+    versionChild->parent = version;
+  }
+  node->isDirty = false;
+  node->hasDirtyBoundary = false;
+  node->snapshot = version;
+  return version;
+}
+
+// Frees the nodes of |version| that were not adopted by a later version.
+static void YGSnapshotFreeVersion(const YGNodeRef version) {
+  const uint32_t childCount = YGNodeListCount(&version->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(&version->children, i);
+    if (child->parent == version) {
+      YGSnapshotFreeVersion(child);
+    }
+  }
+  YGNodeListRemoveAll(&version->children);
+  version->parent = NULL;
+  YGNodeFree(version);
+}
+
+YGNodeRef YGSnapshotCapture(const YGSnapshotRef snapshot) {
+  const YGNodeRef previous = snapshot->version;
+  snapshot->version = YGSnapshotCaptureNode(snapshot->root, previous);
+  if (previous != NULL && previous != snapshot->version) {
+    YGSnapshotFreeVersion(previous);
+  }
+  return snapshot->version;
+}
+
+// Gives |node| the measurement cache of |version|, or as much of it as fits
+// in an arena node.
+static void YGSnapshotCopyCachedMeasurements(const YGNodeRef node,
+                                             const YGNodeRef version) {
+  uint32_t count = version->layout.nextCachedMeasurementsIndex;
+  while (node->arena == NULL && node->cachedMeasurementsCapacity < count) {
+    YGNodeGrowCachedMeasurements(node, count);
+  }
+  if (count > node->cachedMeasurementsCapacity) {
+    count = node->cachedMeasurementsCapacity;
+  }
+  if (count > 0) {
+    memcpy(node->cachedMeasurements, version->cachedMeasurements,
+           count * sizeof(YGMeasurementCacheEntry));
+  }
+  node->layout.nextCachedMeasurementsIndex = count;
+}
+
+// Copies the layout of |version| to |node|, then does the same for the
+// children laid out since the last commit. Nodes edited since the capture
+// only get the frames: their caches and dirty flag are left for the next
+// capture.
+static void YGSnapshotCommitNode(const YGNodeRef node,
+                                 const YGNodeRef version) {
+  YGLayout *const layout = &node->layout;
+  if (node->isDirty) {
+    memcpy(layout->position, version->layout.position,
+           sizeof(layout->position));
+    memcpy(layout->dimensions, version->layout.dimensions,
+           sizeof(layout->dimensions));
+    memcpy(layout->absolutePosition, version->layout.absolutePosition,
+           sizeof(layout->absolutePosition));
+    memcpy(layout->margin, version->layout.margin, sizeof(layout->margin));
+    memcpy(layout->border, version->layout.border, sizeof(layout->border));
+    memcpy(layout->padding, version->layout.padding,
+           sizeof(layout->padding));
+    layout->direction = version->layout.direction;
+    layout->hadOverflow = version->layout.hadOverflow;
+    layout->generationCount = version->layout.generationCount;
+    layout->baseline = YGUndefined;
+  } else {
+    *layout = version->layout;
+    YGSnapshotCopyCachedMeasurements(node, version);
+  }
+  node->hasNewLayout |= version->hasNewLayout;
+  version->hasNewLayout = false;
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(&node->children, i);
+    const YGNodeRef versionChild = YGSnapshotFindChild(version, child, i);
+    if (versionChild != NULL && versionChild->layout.generationCount !=
+                                    child->layout.generationCount) {
+      YGSnapshotCommitNode(child, versionChild);
+    }
+  }
+}
+
+void YGSnapshotCommit(const YGSnapshotRef snapshot) {
+  const YGNodeRef root = snapshot->root;
+  const YGNodeRef version = snapshot->version;
+  if (version != NULL &&
+      version->layout.generationCount != root->layout.generationCount) {
+    YGSnapshotCommitNode(root, version);
+  }
+}
+
+// Forgets the counterparts of |node| and its children, marking dirty again
+// the nodes whose captured edits were not laid out and committed.
+static void YGSnapshotReleaseNode(const YGNodeRef node,
+                                  const YGNodeRef version) {
+  if (version->isDirty ||
+      version->layout.generationCount != node->layout.generationCount) {
+    YGNodeMarkDirtyInternal(node);
+  }
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(&node->children, i);
+    const YGNodeRef versionChild = YGSnapshotFindChild(version, child, i);
+    if (versionChild != NULL) {
+      YGSnapshotReleaseNode(child, versionChild);
+    }
+  }
+  node->snapshot = NULL;
+}
+
+void YGSnapshotFree(const YGSnapshotRef snapshot) {
+  if (snapshot->version != NULL) {
+    YGSnapshotReleaseNode(snapshot->root, snapshot->version);
+    YGSnapshotFreeVersion(snapshot->version);
+  }
+  gYGFree(snapshot);
 }
 
 void YGNodeMarkDirty(const YGNodeRef node) {
@@ -612,10 +1467,208 @@ void YGNodeMarkDirty(const YGNodeRef node) {
 
 bool YGNodeIsDirty(const YGNodeRef node) { return node->isDirty; }
 
+static inline bool YGNodeHasStyleEdge(const YGNodeRef node,
+                                      const YGEdgeProperty property,
+                                      const YGEdge edge) {
+  return (node->style.edges.setEdges >> (property * YGEdgeCount + edge)) & 1;
+}
+
+// Index of the value of |edge| in the packed values, or
+// YG_EDGE_VALUE_UNDEFINED if it isn't set.
+static inline uint32_t YGStyleEdgesIndex(const YGStyleEdges *const edges,
+                                         const YGEdgeProperty property,
+                                         const YGEdge edge) {
+  const uint64_t bit = 1ull << (property * YGEdgeCount + edge);
+  if ((edges->setEdges & bit) == 0) {
+    return YG_EDGE_VALUE_UNDEFINED;
+  }
+  return YG_EDGE_VALUE_FIRST + YGPopCount64(edges->setEdges & (bit - 1));
+}
+
+// The value set for |edge| itself, without shorthands or defaults.
+static inline const YGValue *YGNodeStyleEdge(const YGNodeRef node,
+                                             const YGEdgeProperty property,
+                                             const YGEdge edge) {
+  const YGStyleEdges *const edges = &node->style.edges;
+  return &edges->values[YGStyleEdgesIndex(edges, property, edge)];
+}
+
+// The value that applies to a physical, start or end edge.
+static inline const YGValue *YGNodeResolvedStyleEdge(
+    const YGNodeRef node, const YGEdgeProperty property, const YGEdge edge) {
+  const YGStyleEdges *const edges = &node->style.edges;
+  return &edges->values[edges->resolved[property][edge]];
+}
+
+// Rebuilds the resolved table. An edge takes its own value, then the
+// vertical (top, bottom) or horizontal (others) shorthand, then all. Start
+// and end are undefined without one; the others fall back to the default
+// of the property.
+static void YGStyleEdgesResolve(YGStyleEdges *const edges) {
+  for (uint32_t p = 0; p < YGEdgePropertyCount; p++) {
+    const YGEdgeProperty property = (YGEdgeProperty)p;
+    const uint32_t horizontal =
+        YGStyleEdgesIndex(edges, property, YGEdgeHorizontal);
+    const uint32_t vertical =
+        YGStyleEdgesIndex(edges, property, YGEdgeVertical);
+    const uint32_t all = YGStyleEdgesIndex(edges, property, YGEdgeAll);
+    const uint32_t fallback = property == YGEdgePropertyPosition
+                                  ? YG_EDGE_VALUE_UNDEFINED
+                                  : YG_EDGE_VALUE_ZERO;
+    for (YGEdge edge = YGEdgeLeft; edge <= YGEdgeEnd; edge++) {
+      uint32_t index = YGStyleEdgesIndex(edges, property, edge);
+      if (index == YG_EDGE_VALUE_UNDEFINED) {
+        index = edge == YGEdgeTop || edge == YGEdgeBottom ? vertical
+                                                          : horizontal;
+      }
+      if (index == YG_EDGE_VALUE_UNDEFINED) {
+        index = all;
+      }
+      if (index == YG_EDGE_VALUE_UNDEFINED &&
+          edge != YGEdgeStart && edge != YGEdgeEnd) {
+        index = fallback;
+      }
+      edges->resolved[p][edge] = (uint8_t)index;
+    }
+  }
+}
+
+// Makes room for |count| set edges.
+static void YGNodeReserveStyleEdges(const YGNodeRef node,
+                                    const uint32_t count) {
+  YGStyleEdges *const edges = &node->style.edges;
+  if (count == 0 || YG_EDGE_VALUE_FIRST + count <= edges->capacity) {
+    return;
+  }
+  uint32_t capacity = edges->capacity > 0 ? edges->capacity * 2 : 4;
+  while (capacity < YG_EDGE_VALUE_FIRST + count) {
+    capacity *= 2;
+  }
+  YGValue *values;
+  if (node->arena == NULL && edges->capacity > 0) {
+    values = gYGRealloc(edges->values, capacity * sizeof(YGValue));
+    YGAssertWithNode(node, values != NULL,
+                     "Could not allocate memory for style");
+  } else {
+    values = YGNodeAllocateColdData(node, capacity * sizeof(YGValue));
+    memcpy(values, edges->values,
+           (YG_EDGE_VALUE_FIRST + edges->count) * sizeof(YGValue));
+  }
+  edges->values = values;
+  edges->capacity = (uint8_t)capacity;
+}
+
+// Stores |value| for |edge|. Undefined values are not stored at all.
+static void YGNodeSetStyleEdge(const YGNodeRef node,
+                               const YGEdgeProperty property,
+                               const YGEdge edge, const YGValue value) {
+  YGStyleEdges *const edges = &node->style.edges;
+  const uint64_t bit = 1ull << (property * YGEdgeCount + edge);
+  const uint32_t index =
+      YG_EDGE_VALUE_FIRST + YGPopCount64(edges->setEdges & (bit - 1));
+  const uint32_t following = YG_EDGE_VALUE_FIRST + edges->count - index;
+  if (edges->setEdges & bit) {
+    if (value.unit != YGUnitUndefined) {
+      edges->values[index] = value;
+      return;
+    }
+    memmove(&edges->values[index], &edges->values[index + 1],
+            (following - 1) * sizeof(YGValue));
+    edges->setEdges &= ~bit;
+    edges->count--;
+  } else {
+    if (value.unit == YGUnitUndefined) {
+      return;
+    }
+    YGNodeReserveStyleEdges(node, edges->count + 1u);
+    memmove(&edges->values[index + 1], &edges->values[index],
+            following * sizeof(YGValue));
+    edges->values[index] = value;
+    edges->setEdges |= bit;
+    edges->count++;
+  }
+  YGStyleEdgesResolve(edges);
+}
+
+static bool YGStyleEdgesEqual(const YGStyleEdges *const a,
+                              const YGStyleEdges *const b) {
+  return a->setEdges == b->setEdges &&
+         memcmp(&a->values[YG_EDGE_VALUE_FIRST],
+                &b->values[YG_EDGE_VALUE_FIRST],
+                a->count * sizeof(YGValue)) == 0;
+}
+
+static bool YGStyleEqual(const YGStyle *const a, const YGStyle *const b) {
+  return memcmp(a, b, offsetof(YGStyle, edges)) == 0 &&
+         YGStyleEdgesEqual(&a->edges, &b->edges);
+}
+
+// Copy of a node's style, with its edge values stored inline.
+typedef struct YGStyleSnapshot {
+  YGStyle style;
+  YGValue edgeValues[];
+} YGStyleSnapshot;
+
+// Every style setter calls this before writing a new value. Outside of an
+// update the node is marked dirty right away; during one, the style is saved
+// so YGNodeStyleEndUpdate can tell whether it actually changed.
+static void YGNodeStyleWillChange(const YGNodeRef node) {
+  if (node->styleUpdateDepth == 0) {
+    YGNodeMarkStyleDirty(node);
+    return;
+  }
+  if (node->styleSnapshot != NULL) {
+    return;
+  }
+  const uint32_t valueCount = YG_EDGE_VALUE_FIRST + node->style.edges.count;
+  YGStyleSnapshot *const snapshot =
+      gYGMalloc(sizeof(YGStyleSnapshot) + valueCount * sizeof(YGValue));
+  YGAssertWithNode(node, snapshot != NULL,
+                   "Could not allocate memory for style update");
+  snapshot->style = node->style;
+  memcpy(snapshot->edgeValues, node->style.edges.values,
+         valueCount * sizeof(YGValue));
+  snapshot->style.edges.values = snapshot->edgeValues;
+  node->styleSnapshot = snapshot;
+}
+
+void YGNodeStyleBeginUpdate(const YGNodeRef node) {
+  YGAssertWithNode(node, node->styleUpdateDepth < UINT8_MAX,
+                   "Too many nested style updates");
+  node->styleUpdateDepth++;
+}
+
+bool YGNodeStyleEndUpdate(const YGNodeRef node) {
+  YGAssertWithNode(node, node->styleUpdateDepth > 0,
+                   "YGNodeStyleEndUpdate called without a matching "
+                   "YGNodeStyleBeginUpdate");
+  node->styleUpdateDepth--;
+  YGStyleSnapshot *const snapshot = node->styleSnapshot;
+  if (node->styleUpdateDepth > 0 || snapshot == NULL) {
+    return false;
+  }
+  node->styleSnapshot = NULL;
+  const bool changed = !YGStyleEqual(&snapshot->style, &node->style);
+  gYGFree(snapshot);
+  if (changed) {
+    YGNodeMarkStyleDirty(node);
+  }
+  return changed;
+}
+
 void YGNodeCopyStyle(const YGNodeRef dstNode, const YGNodeRef srcNode) {
-  if (memcmp(&dstNode->style, &srcNode->style, sizeof(YGStyle)) != 0) {
-    memcpy(&dstNode->style, &srcNode->style, sizeof(YGStyle));
-    YGNodeMarkDirtyInternal(dstNode);
+  const size_t inlineSize = offsetof(YGStyle, edges);
+  if (!YGStyleEqual(&dstNode->style, &srcNode->style)) {
+    YGNodeStyleWillChange(dstNode);
+    memcpy(&dstNode->style, &srcNode->style, inlineSize);
+    const YGStyleEdges *const src = &srcNode->style.edges;
+    YGStyleEdges *const dst = &dstNode->style.edges;
+    YGNodeReserveStyleEdges(dstNode, src->count);
+    memcpy(&dst->values[YG_EDGE_VALUE_FIRST], &src->values[YG_EDGE_VALUE_FIRST],
+           src->count * sizeof(YGValue));
+    dst->setEdges = src->setEdges;
+    dst->count = src->count;
+    memcpy(dst->resolved, src->resolved, sizeof(dst->resolved));
   }
 }
 
@@ -683,8 +1736,8 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
                                            instanceName)                  \
   void YGNodeStyleSet##name(const YGNodeRef node, const type paramName) { \
     if (node->style.instanceName != paramName) {                          \
+      YGNodeStyleWillChange(node);                                        \
       node->style.instanceName = paramName;                               \
-      YGNodeMarkDirtyInternal(node);                                      \
     }                                                                     \
   }
 
@@ -693,10 +1746,10 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
   void YGNodeStyleSet##name(const YGNodeRef node, const type paramName) { \
     if (node->style.instanceName.value != paramName ||                    \
         node->style.instanceName.unit != YGUnitPoint) {                   \
+      YGNodeStyleWillChange(node);                                        \
       node->style.instanceName.value = paramName;                         \
       node->style.instanceName.unit =                                     \
           YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPoint;       \
-      YGNodeMarkDirtyInternal(node);                                      \
     }                                                                     \
   }                                                                       \
                                                                           \
@@ -704,10 +1757,10 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
                                      const type paramName) {              \
     if (node->style.instanceName.value != paramName ||                    \
         node->style.instanceName.unit != YGUnitPercent) {                 \
+      YGNodeStyleWillChange(node);                                        \
       node->style.instanceName.value = paramName;                         \
       node->style.instanceName.unit =                                     \
           YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPercent;     \
-      YGNodeMarkDirtyInternal(node);                                      \
     }                                                                     \
   }
 
@@ -716,10 +1769,10 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
   void YGNodeStyleSet##name(const YGNodeRef node, const type paramName) {   \
     if (node->style.instanceName.value != paramName ||                      \
         node->style.instanceName.unit != YGUnitPoint) {                     \
+      YGNodeStyleWillChange(node);                                          \
       node->style.instanceName.value = paramName;                           \
       node->style.instanceName.unit =                                       \
           YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPoint;         \
-      YGNodeMarkDirtyInternal(node);                                        \
     }                                                                       \
   }                                                                         \
                                                                             \
@@ -727,18 +1780,18 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
                                      const type paramName) {                \
     if (node->style.instanceName.value != paramName ||                      \
         node->style.instanceName.unit != YGUnitPercent) {                   \
+      YGNodeStyleWillChange(node);                                          \
       node->style.instanceName.value = paramName;                           \
       node->style.instanceName.unit =                                       \
           YGFloatIsUndefined(paramName) ? YGUnitAuto : YGUnitPercent;       \
-      YGNodeMarkDirtyInternal(node);                                        \
     }                                                                       \
   }                                                                         \
                                                                             \
   void YGNodeStyleSet##name##Auto(const YGNodeRef node) {                   \
     if (node->style.instanceName.unit != YGUnitAuto) {                      \
+      YGNodeStyleWillChange(node);                                          \
       node->style.instanceName.value = YGUndefined;                         \
       node->style.instanceName.unit = YGUnitAuto;                           \
-      YGNodeMarkDirtyInternal(node);                                        \
     }                                                                       \
   }
 
@@ -766,58 +1819,70 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
     return node->style.instanceName;                                   \
   }
 
-#define YG_NODE_STYLE_EDGE_PROPERTY_UNIT_AUTO_IMPL(type, name, instanceName) \
+#define YG_NODE_STYLE_EDGE_PROPERTY_UNIT_AUTO_IMPL(type, name)              \
   void YGNodeStyleSet##name##Auto(const YGNodeRef node, const YGEdge edge) { \
-    if (node->style.instanceName[edge].unit != YGUnitAuto) {                 \
-      node->style.instanceName[edge].value = YGUndefined;                    \
-      node->style.instanceName[edge].unit = YGUnitAuto;                      \
-      YGNodeMarkDirtyInternal(node);                                         \
+    if (YGNodeStyleEdge(node, YGEdgeProperty##name, edge)->unit !=           \
+        YGUnitAuto) {                                                        \
+      YGNodeStyleWillChange(node);                                           \
+      const YGValue value = {.value = YGUndefined, .unit = YGUnitAuto};      \
+      YGNodeSetStyleEdge(node, YGEdgeProperty##name, edge, value);           \
     }                                                                        \
   }
 
-#define YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(type, name, paramName,          \
-                                              instanceName)                   \
-  void YGNodeStyleSet##name(const YGNodeRef node, const YGEdge edge,          \
-                            const float paramName) {                          \
-    if (node->style.instanceName[edge].value != paramName ||                  \
-        node->style.instanceName[edge].unit != YGUnitPoint) {                 \
-      node->style.instanceName[edge].value = paramName;                       \
-      node->style.instanceName[edge].unit =                                   \
-          YGFloatIsUndefined(paramName) ? YGUnitUndefined : YGUnitPoint;      \
-      YGNodeMarkDirtyInternal(node);                                          \
-    }                                                                         \
-  }                                                                           \
-                                                                              \
-  void YGNodeStyleSet##name##Percent(const YGNodeRef node, const YGEdge edge, \
-                                     const float paramName) {                 \
-    if (node->style.instanceName[edge].value != paramName ||                  \
-        node->style.instanceName[edge].unit != YGUnitPercent) {               \
-      node->style.instanceName[edge].value = paramName;                       \
-      node->style.instanceName[edge].unit =                                   \
-          YGFloatIsUndefined(paramName) ? YGUnitUndefined : YGUnitPercent;    \
-      YGNodeMarkDirtyInternal(node);                                          \
-    }                                                                         \
-  }                                                                           \
-                                                                              \
-  WIN_STRUCT(type)                                                            \
-  YGNodeStyleGet##name(const YGNodeRef node, const YGEdge edge) {             \
-    return WIN_STRUCT_REF(node->style.instanceName[edge]);                    \
-  }
-
-#define YG_NODE_STYLE_EDGE_PROPERTY_IMPL(type, name, paramName, instanceName) \
-  void YGNodeStyleSet##name(const YGNodeRef node, const YGEdge edge,          \
-                            const float paramName) {                          \
-    if (node->style.instanceName[edge].value != paramName ||                  \
-        node->style.instanceName[edge].unit != YGUnitPoint) {                 \
-      node->style.instanceName[edge].value = paramName;                       \
-      node->style.instanceName[edge].unit =                                   \
-          YGFloatIsUndefined(paramName) ? YGUnitUndefined : YGUnitPoint;      \
-      YGNodeMarkDirtyInternal(node);                                          \
-    }                                                                         \
-  }                                                                           \
-                                                                              \
-  float YGNodeStyleGet##name(const YGNodeRef node, const YGEdge edge) {       \
-    return node->style.instanceName[edge].value;                              \
+#define YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(type, name, paramName)           \
+  void YGNodeStyleSet##name(const YGNodeRef node, const YGEdge edge,           \
+                            const float paramName) {                           \
+    const YGValue *const current =                                             \
+        YGNodeStyleEdge(node, YGEdgeProperty##name, edge);                     \
+    if (current->value != paramName || current->unit != YGUnitPoint) {         \
+      YGNodeStyleWillChange(node);                                             \
+      const YGValue value = {                                                  \
+          .value = paramName,                                                  \
+          .unit = YGFloatIsUndefined(paramName) ? YGUnitUndefined              \
+                                                : YGUnitPoint,                 \
+      };                                                                       \
+      YGNodeSetStyleEdge(node, YGEdgeProperty##name, edge, value);             \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  void YGNodeStyleSet##name##Percent(const YGNodeRef node, const YGEdge edge,  \
+                                     const float paramName) {                  \
+    const YGValue *const current =                                             \
+        YGNodeStyleEdge(node, YGEdgeProperty##name, edge);                     \
+    if (current->value != paramName || current->unit != YGUnitPercent) {       \
+      YGNodeStyleWillChange(node);                                             \
+      const YGValue value = {                                                  \
+          .value = paramName,                                                  \
+          .unit = YGFloatIsUndefined(paramName) ? YGUnitUndefined              \
+                                                : YGUnitPercent,               \
+      };                                                                       \
+      YGNodeSetStyleEdge(node, YGEdgeProperty##name, edge, value);             \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  WIN_STRUCT(type)                                                             \
+  YGNodeStyleGet##name(const YGNodeRef node, const YGEdge edge) {              \
+    return WIN_STRUCT_REF(*YGNodeStyleEdge(node, YGEdgeProperty##name, edge)); \
+  }
+
+#define YG_NODE_STYLE_EDGE_PROPERTY_IMPL(type, name, paramName)                \
+  void YGNodeStyleSet##name(const YGNodeRef node, const YGEdge edge,           \
+                            const float paramName) {                           \
+    const YGValue *const current =                                             \
+        YGNodeStyleEdge(node, YGEdgeProperty##name, edge);                     \
+    if (current->value != paramName || current->unit != YGUnitPoint) {         \
+      YGNodeStyleWillChange(node);                                             \
+      const YGValue value = {                                                  \
+          .value = paramName,                                                  \
+          .unit = YGFloatIsUndefined(paramName) ? YGUnitUndefined              \
+                                                : YGUnitPoint,                 \
+      };                                                                       \
+      YGNodeSetStyleEdge(node, YGEdgeProperty##name, edge, value);             \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  float YGNodeStyleGet##name(const YGNodeRef node, const YGEdge edge) {        \
+    return YGNodeStyleEdge(node, YGEdgeProperty##name, edge)->value;           \
   }
 
 #define YG_NODE_LAYOUT_PROPERTY_IMPL(type, name, instanceName) \
@@ -851,6 +1916,8 @@ static inline const YGValue *YGNodeResolveFlexBasisPtr(const YGNodeRef node) {
 
 YG_NODE_PROPERTY_IMPL(void *, Context, context, context);
 YG_NODE_PROPERTY_IMPL(YGPrintFunc, PrintFunc, printFunc, print);
+YG_NODE_PROPERTY_IMPL(YGMeasureKeyFunc, MeasureKeyFunc, measureKeyFunc,
+                      measureKey);
 YG_NODE_PROPERTY_IMPL(bool, HasNewLayout, hasNewLayout, hasNewLayout);
 YG_NODE_PROPERTY_IMPL(YGNodeType, NodeType, nodeType, nodeType);
 
@@ -873,11 +1940,11 @@ YG_NODE_STYLE_PROPERTY_SETTER_IMPL(float, FlexGrow, flexGrow, flexGrow);
 YG_NODE_STYLE_PROPERTY_SETTER_IMPL(float, FlexShrink, flexShrink, flexShrink);
 YG_NODE_STYLE_PROPERTY_UNIT_AUTO_IMPL(YGValue, FlexBasis, flexBasis, flexBasis);
 
-YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(YGValue, Position, position, position);
-YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(YGValue, Margin, margin, margin);
-YG_NODE_STYLE_EDGE_PROPERTY_UNIT_AUTO_IMPL(YGValue, Margin, margin);
-YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(YGValue, Padding, padding, padding);
-YG_NODE_STYLE_EDGE_PROPERTY_IMPL(float, Border, border, border);
+YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(YGValue, Position, position);
+YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(YGValue, Margin, margin);
+YG_NODE_STYLE_EDGE_PROPERTY_UNIT_AUTO_IMPL(YGValue, Margin);
+YG_NODE_STYLE_EDGE_PROPERTY_UNIT_IMPL(YGValue, Padding, padding);
+YG_NODE_STYLE_EDGE_PROPERTY_IMPL(float, Border, border);
 
 YG_NODE_STYLE_PROPERTY_UNIT_AUTO_IMPL(YGValue, Width, width,
                                       dimensions[YGDimensionWidth]);
@@ -908,45 +1975,286 @@ YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(float, Margin, margin);
 YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(float, Border, border);
 YG_NODE_LAYOUT_RESOLVED_PROPERTY_IMPL(float, Padding, padding);
 
-uint32_t gCurrentGenerationCount = 0;
-
-bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
-                          const float availableHeight,
-                          const YGDirection parentDirection,
-                          const YGMeasureMode widthMeasureMode,
-                          const YGMeasureMode heightMeasureMode,
-                          const float parentWidth, const float parentHeight,
-                          const bool performLayout, const char *reason,
-                          const YGConfigRef config);
-
-inline bool YGFloatIsUndefined(const float value) { return isnan(value); }
-
-static inline bool YGValueEqual(const YGValue a, const YGValue b) {
-  if (a.unit != b.unit) {
+// Parallel child layout.
+//
+// When YGConfigSetParallelLayoutEnabled is set, wide containers hand the
+// independent parts of their children's layout (flex basis measurement and
+// the final per-child layout) to a process-wide work-stealing pool. Every
+// worker owns a deque: it pushes and pops work at the bottom, idle workers
+// steal from the top of the others. Threads that wait for a job to finish keep
+// executing queued work instead of blocking, so nested jobs (a wide container
+// inside a wide container) cannot deadlock. Results are only combined by the
+// thread that issued the job, in child order, so the output is identical to
+// the serial path.
+typedef void (*YGParallelBody)(void *userData, const uint32_t index);
+
+#ifndef _MSC_VER
+#define YG_PARALLEL_LAYOUT 1
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define YG_PARALLEL_MAX_WORKERS 64
+#define YG_PARALLEL_DEQUE_CAPACITY 256
+
+typedef struct YGParallelJob {
+  YGParallelBody body;
+  void *userData;
+  uint32_t grainSize;
+  // Number of indices that have not been executed yet.
+  uint32_t pending;
+} YGParallelJob;
+
+typedef struct YGParallelTask {
+  YGParallelJob *job;
+  uint32_t begin;
+  uint32_t end;
+} YGParallelTask;
+
+typedef struct YGParallelDeque {
+  pthread_mutex_t lock;
+  // Thieves take from top, the owner pushes and pops at bottom.
+  uint32_t top;
+  uint32_t bottom;
+  YGParallelTask tasks[YG_PARALLEL_DEQUE_CAPACITY];
+} YGParallelDeque;
+
+typedef struct YGParallelPool {
+  // Deque 0 is shared by all the threads that are not pool workers.
+  uint32_t dequeCount;
+  YGParallelDeque deques[YG_PARALLEL_MAX_WORKERS + 1];
+  uint32_t queuedTaskCount;
+  uint32_t sleepingWorkerCount;
+  pthread_mutex_t sleepLock;
+  pthread_cond_t wakeUp;
+} YGParallelPool;
+
+static YGParallelPool *gYGParallelPool = NULL;
+static pthread_once_t gYGParallelPoolOnce = PTHREAD_ONCE_INIT;
+static __thread uint32_t gYGParallelDequeIndex = 0;
+
+static bool YGParallelDequePush(YGParallelPool *const pool,
+                                YGParallelDeque *const deque,
+                                const YGParallelTask task) {
+  pthread_mutex_lock(&deque->lock);
+  const bool hasRoom =
+      deque->bottom - deque->top < YG_PARALLEL_DEQUE_CAPACITY;
+  if (hasRoom) {
+    deque->tasks[deque->bottom % YG_PARALLEL_DEQUE_CAPACITY] = task;
+    __atomic_store_n(&deque->bottom, deque->bottom + 1, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&deque->lock);
+  if (!hasRoom) {
     return false;
   }
 
-  if (a.unit == YGUnitUndefined) {
-    return true;
+  __atomic_add_fetch(&pool->queuedTaskCount, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&pool->sleepingWorkerCount, __ATOMIC_SEQ_CST) > 0) {
+    pthread_mutex_lock(&pool->sleepLock);
+    pthread_cond_signal(&pool->wakeUp);
+    pthread_mutex_unlock(&pool->sleepLock);
   }
-
-  return fabs(a.value - b.value) < 0.0001f;
+  return true;
 }
 
-static inline void YGResolveDimensions(YGNodeRef node) {
-  for (YGDimension dim = YGDimensionWidth; dim <= YGDimensionHeight; dim++) {
-    if (node->style.maxDimensions[dim].unit != YGUnitUndefined &&
-        YGValueEqual(node->style.maxDimensions[dim],
-                     node->style.minDimensions[dim])) {
-      node->resolvedDimensions[dim] = &node->style.maxDimensions[dim];
+static bool YGParallelDequeTake(YGParallelPool *const pool,
+                                YGParallelDeque *const deque,
+                                const bool steal, YGParallelTask *const task) {
+  // Cheap unlocked check, so idle threads scanning for work do not contend on
+  // the locks of empty deques. Indices are only modified under the lock.
+  if (__atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) ==
+      __atomic_load_n(&deque->top, __ATOMIC_RELAXED)) {
+    return false;
+  }
+  pthread_mutex_lock(&deque->lock);
+  const bool hasTask = deque->bottom != deque->top;
+  if (hasTask) {
+    if (steal) {
+      *task = deque->tasks[deque->top % YG_PARALLEL_DEQUE_CAPACITY];
+      __atomic_store_n(&deque->top, deque->top + 1, __ATOMIC_RELAXED);
     } else {
-      node->resolvedDimensions[dim] = &node->style.dimensions[dim];
+      __atomic_store_n(&deque->bottom, deque->bottom - 1, __ATOMIC_RELAXED);
+      *task = deque->tasks[deque->bottom % YG_PARALLEL_DEQUE_CAPACITY];
     }
   }
+  pthread_mutex_unlock(&deque->lock);
+  if (hasTask) {
+    __atomic_sub_fetch(&pool->queuedTaskCount, 1, __ATOMIC_SEQ_CST);
+  }
+  return hasTask;
 }
 
-static inline bool YGFloatsEqual(const float a, const float b) {
-  if (YGFloatIsUndefined(a)) {
+static bool YGParallelFindTask(YGParallelPool *const pool,
+                               YGParallelTask *const task) {
+  const uint32_t ownIndex = gYGParallelDequeIndex;
+  if (YGParallelDequeTake(pool, &pool->deques[ownIndex], false, task)) {
+    return true;
+  }
+  for (uint32_t i = 1; i < pool->dequeCount; i++) {
+    const uint32_t victim = (ownIndex + i) % pool->dequeCount;
+    if (YGParallelDequeTake(pool, &pool->deques[victim], true, task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void YGParallelRunTask(YGParallelPool *const pool,
+                              YGParallelTask task) {
+  YGParallelJob *const job = task.job;
+  // Split the range in halves until it reaches the grain size, leaving the
+  // upper halves for other workers to steal. If the deque is full the rest of
+  // the range simply runs inline.
+  while (task.end - task.begin > job->grainSize) {
+    const uint32_t middle = task.begin + (task.end - task.begin) / 2;
+    const YGParallelTask upperHalf = {
+        .job = job, .begin = middle, .end = task.end};
+    if (!YGParallelDequePush(pool, &pool->deques[gYGParallelDequeIndex],
+                             upperHalf)) {
+      break;
+    }
+    task.end = middle;
+  }
+  for (uint32_t i = task.begin; i < task.end; i++) {
+    job->body(job->userData, i);
+  }
+  __atomic_sub_fetch(&job->pending, task.end - task.begin, __ATOMIC_ACQ_REL);
+}
+
+static void *YGParallelWorkerMain(void *arg) {
+  YGParallelPool *const pool = gYGParallelPool;
+  gYGParallelDequeIndex = (uint32_t)(uintptr_t)arg;
+  while (true) {
+    YGParallelTask task;
+    if (YGParallelFindTask(pool, &task)) {
+      YGParallelRunTask(pool, task);
+      continue;
+    }
+    pthread_mutex_lock(&pool->sleepLock);
+    __atomic_add_fetch(&pool->sleepingWorkerCount, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&pool->queuedTaskCount, __ATOMIC_SEQ_CST) == 0) {
+      pthread_cond_wait(&pool->wakeUp, &pool->sleepLock);
+    }
+    __atomic_sub_fetch(&pool->sleepingWorkerCount, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool->sleepLock);
+  }
+  return NULL;
+}
+
+static void YGParallelPoolInit(void) {
+  long workerCount = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+  if (workerCount <= 0) {
+    // A single core gains nothing from a pool; jobs run on the caller.
+    return;
+  }
+  if (workerCount > YG_PARALLEL_MAX_WORKERS) {
+    workerCount = YG_PARALLEL_MAX_WORKERS;
+  }
+
+  YGParallelPool *const pool = calloc(1, sizeof(YGParallelPool));
+  if (pool == NULL) {
+    return;
+  }
+  pool->dequeCount = (uint32_t)workerCount + 1;
+  for (uint32_t i = 0; i < pool->dequeCount; i++) {
+    pthread_mutex_init(&pool->deques[i].lock, NULL);
+  }
+  pthread_mutex_init(&pool->sleepLock, NULL);
+  pthread_cond_init(&pool->wakeUp, NULL);
+  gYGParallelPool = pool;
+
+  for (uint32_t i = 1; i < pool->dequeCount; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, YGParallelWorkerMain,
+                       (void *)(uintptr_t)i) == 0) {
+      pthread_detach(thread);
+    }
+  }
+}
+
+// Calls |body| for every index in [0, count), spreading ranges of at least
+// |grainSize| indices across the pool. Returns once every index has run.
+static void YGParallelFor(const uint32_t count, const uint32_t grainSize,
+                          const YGParallelBody body, void *const userData) {
+  pthread_once(&gYGParallelPoolOnce, YGParallelPoolInit);
+  YGParallelPool *const pool = gYGParallelPool;
+  if (pool == NULL || count <= grainSize) {
+    for (uint32_t i = 0; i < count; i++) {
+      body(userData, i);
+    }
+    return;
+  }
+
+  YGParallelJob job = {
+      .body = body,
+      .userData = userData,
+      .grainSize = grainSize > 0 ? grainSize : 1,
+      .pending = count,
+  };
+  const YGParallelTask task = {.job = &job, .begin = 0, .end = count};
+  YGParallelRunTask(pool, task);
+  while (__atomic_load_n(&job.pending, __ATOMIC_ACQUIRE) > 0) {
+    YGParallelTask task;
+    if (YGParallelFindTask(pool, &task)) {
+      YGParallelRunTask(pool, task);
+    } else {
+      sched_yield();
+    }
+  }
+}
+#else
+static void YGParallelFor(const uint32_t count, const uint32_t grainSize,
+                          const YGParallelBody body, void *const userData) {
+  for (uint32_t i = 0; i < count; i++) {
+    body(userData, i);
+  }
+}
+#endif
+
+// Source of unique generation ids. It is only read through
+// YGLayoutContextBeginPass; the pass itself uses the id cached in its context.
+uint32_t gCurrentGenerationCount = 0;
+
+bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
+                          const float availableHeight,
+                          const YGDirection parentDirection,
+                          const YGMeasureMode widthMeasureMode,
+                          const YGMeasureMode heightMeasureMode,
+                          const float parentWidth, const float parentHeight,
+                          const bool performLayout, const char *reason,
+                          const YGConfigRef config,
+                          YGLayoutContext *const layoutContext);
+
+static uint64_t YGNow(void);
+
+inline bool YGFloatIsUndefined(const float value) { return isnan(value); }
+
+static inline bool YGValueEqual(const YGValue a, const YGValue b) {
+  if (a.unit != b.unit) {
+    return false;
+  }
+
+  if (a.unit == YGUnitUndefined) {
+    return true;
+  }
+
+  return fabs(a.value - b.value) < 0.0001f;
+}
+
+static inline void YGResolveDimensions(YGNodeRef node) {
+  for (YGDimension dim = YGDimensionWidth; dim <= YGDimensionHeight; dim++) {
+    if (node->style.maxDimensions[dim].unit != YGUnitUndefined &&
+        YGValueEqual(node->style.maxDimensions[dim],
+                     node->style.minDimensions[dim])) {
+      node->resolvedDimensions[dim] = &node->style.maxDimensions[dim];
+    } else {
+      node->resolvedDimensions[dim] = &node->style.dimensions[dim];
+    }
+  }
+}
+
+static inline bool YGFloatsEqual(const float a, const float b) {
+  if (YGFloatIsUndefined(a)) {
     return YGFloatIsUndefined(b);
   }
   return fabs(a - b) < 0.0001f;
@@ -1018,9 +2326,11 @@ static void YGPrintNumberIfNotAuto(YGStringStream *stream, const char *str,
 }
 
 static void YGPrintEdgeIfNotUndefined(YGStringStream *stream, const char *str,
-                                      const YGValue *edges, const YGEdge edge) {
-  YGPrintNumberIfNotUndefined(
-      stream, str, YGComputedEdgeValue(edges, edge, &YGValueUndefined));
+                                      const YGNodeRef node,
+                                      const YGEdgeProperty property,
+                                      const YGEdge edge) {
+  YGPrintNumberIfNotUndefined(stream, str,
+                              YGNodeResolvedStyleEdge(node, property, edge));
 }
 
 static void YGPrintNumberIfNotZero(YGStringStream *stream, const char *str,
@@ -1036,7 +2346,11 @@ static bool YGFourValuesEqual(const YGValue four[4]) {
 }
 
 static void YGPrintEdges(YGStringStream *stream, const char *str,
-                         const YGValue *edges) {
+                         const YGNodeRef node, const YGEdgeProperty property) {
+  YGValue edges[YGEdgeCount];
+  for (YGEdge edge = YGEdgeLeft; edge < YGEdgeCount; edge++) {
+    edges[edge] = *YGNodeStyleEdge(node, property, edge);
+  }
   if (YGFourValuesEqual(edges)) {
     YGPrintNumberIfNotZero(stream, str, &edges[YGEdgeLeft]);
   } else {
@@ -1113,9 +2427,9 @@ static void YGNodeToString(YGStringStream *stream, const YGNodeRef node,
                             YGDisplayToString(node->style.display));
     }
 
-    YGPrintEdges(stream, "margin", node->style.margin);
-    YGPrintEdges(stream, "padding", node->style.padding);
-    YGPrintEdges(stream, "border", node->style.border);
+    YGPrintEdges(stream, "margin", node, YGEdgePropertyMargin);
+    YGPrintEdges(stream, "padding", node, YGEdgePropertyPadding);
+    YGPrintEdges(stream, "border", node, YGEdgePropertyBorder);
 
     YGPrintNumberIfNotAuto(stream, "width",
                            &node->style.dimensions[YGDimensionWidth]);
@@ -1135,11 +2449,13 @@ static void YGNodeToString(YGStringStream *stream, const YGNodeRef node,
                             YGPositionTypeToString(node->style.positionType));
     }
 
-    YGPrintEdgeIfNotUndefined(stream, "left", node->style.position, YGEdgeLeft);
-    YGPrintEdgeIfNotUndefined(stream, "right", node->style.position,
+    YGPrintEdgeIfNotUndefined(stream, "left", node, YGEdgePropertyPosition,
+                              YGEdgeLeft);
+    YGPrintEdgeIfNotUndefined(stream, "right", node, YGEdgePropertyPosition,
                               YGEdgeRight);
-    YGPrintEdgeIfNotUndefined(stream, "top", node->style.position, YGEdgeTop);
-    YGPrintEdgeIfNotUndefined(stream, "bottom", node->style.position,
+    YGPrintEdgeIfNotUndefined(stream, "top", node, YGEdgePropertyPosition,
+                              YGEdgeTop);
+    YGPrintEdgeIfNotUndefined(stream, "bottom", node, YGEdgePropertyPosition,
                               YGEdgeBottom);
     YGWriteToStringStream(stream, "\" ");
 
@@ -1149,7 +2465,7 @@ static void YGNodeToString(YGStringStream *stream, const YGNodeRef node,
   }
   YGWriteToStringStream(stream, ">");
 
-  const uint32_t childCount = YGNodeListCount(node->children);
+  const uint32_t childCount = YGNodeListCount(&node->children);
   if (options & YGPrintOptionsChildren && childCount > 0) {
     for (uint32_t i = 0; i < childCount; i++) {
       YGWriteToStringStream(stream, "\n");
@@ -1214,114 +2530,130 @@ static inline bool YGFlexDirectionIsColumn(
          flexDirection == YGFlexDirectionColumnReverse;
 }
 
-static inline float YGNodeLeadingMargin(const YGNodeRef node,
-                                        const YGFlexDirection axis,
-                                        const float widthSize) {
+static YG_AXIS_INLINE float YGNodeLeadingMargin(const YGNodeRef node,
+                                                const YGFlexDirection axis,
+                                                const float widthSize) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.margin[YGEdgeStart].unit != YGUnitUndefined) {
-    return YGResolveValueMargin(&node->style.margin[YGEdgeStart], widthSize);
+      YGNodeHasStyleEdge(node, YGEdgePropertyMargin, YGEdgeStart)) {
+    return YGResolveValueMargin(
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyMargin, YGEdgeStart),
+        widthSize);
   }
 
   return YGResolveValueMargin(
-      YGComputedEdgeValue(node->style.margin, leading[axis], &YGValueZero),
+      YGNodeResolvedStyleEdge(node, YGEdgePropertyMargin, leading[axis]),
       widthSize);
 }
 
-static float YGNodeTrailingMargin(const YGNodeRef node,
-                                  const YGFlexDirection axis,
-                                  const float widthSize) {
+static YG_AXIS_INLINE float YGNodeTrailingMargin(const YGNodeRef node,
+                                                 const YGFlexDirection axis,
+                                                 const float widthSize) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.margin[YGEdgeEnd].unit != YGUnitUndefined) {
-    return YGResolveValueMargin(&node->style.margin[YGEdgeEnd], widthSize);
+      YGNodeHasStyleEdge(node, YGEdgePropertyMargin, YGEdgeEnd)) {
+    return YGResolveValueMargin(
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyMargin, YGEdgeEnd),
+        widthSize);
   }
 
   return YGResolveValueMargin(
-      YGComputedEdgeValue(node->style.margin, trailing[axis], &YGValueZero),
+      YGNodeResolvedStyleEdge(node, YGEdgePropertyMargin, trailing[axis]),
       widthSize);
 }
 
-static float YGNodeLeadingPadding(const YGNodeRef node,
-                                  const YGFlexDirection axis,
-                                  const float widthSize) {
+static YG_AXIS_INLINE float YGNodeLeadingPadding(const YGNodeRef node,
+                                                 const YGFlexDirection axis,
+                                                 const float widthSize) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.padding[YGEdgeStart].unit != YGUnitUndefined &&
-      YGResolveValue(&node->style.padding[YGEdgeStart], widthSize) >= 0.0f) {
-    return YGResolveValue(&node->style.padding[YGEdgeStart], widthSize);
+      YGNodeHasStyleEdge(node, YGEdgePropertyPadding, YGEdgeStart)) {
+    const float start = YGResolveValue(
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyPadding, YGEdgeStart),
+        widthSize);
+    if (start >= 0.0f) {
+      return start;
+    }
   }
 
-  return fmaxf(YGResolveValue(YGComputedEdgeValue(node->style.padding,
-                                                  leading[axis], &YGValueZero),
-                              widthSize),
-               0.0f);
+  return fmaxf(
+      YGResolveValue(
+          YGNodeResolvedStyleEdge(node, YGEdgePropertyPadding, leading[axis]),
+          widthSize),
+      0.0f);
 }
 
-static float YGNodeTrailingPadding(const YGNodeRef node,
-                                   const YGFlexDirection axis,
-                                   const float widthSize) {
+static YG_AXIS_INLINE float YGNodeTrailingPadding(const YGNodeRef node,
+                                                  const YGFlexDirection axis,
+                                                  const float widthSize) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.padding[YGEdgeEnd].unit != YGUnitUndefined &&
-      YGResolveValue(&node->style.padding[YGEdgeEnd], widthSize) >= 0.0f) {
-    return YGResolveValue(&node->style.padding[YGEdgeEnd], widthSize);
+      YGNodeHasStyleEdge(node, YGEdgePropertyPadding, YGEdgeEnd)) {
+    const float end = YGResolveValue(
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyPadding, YGEdgeEnd),
+        widthSize);
+    if (end >= 0.0f) {
+      return end;
+    }
   }
 
-  return fmaxf(YGResolveValue(YGComputedEdgeValue(node->style.padding,
-                                                  trailing[axis], &YGValueZero),
-                              widthSize),
-               0.0f);
+  return fmaxf(
+      YGResolveValue(
+          YGNodeResolvedStyleEdge(node, YGEdgePropertyPadding, trailing[axis]),
+          widthSize),
+      0.0f);
 }
 
-static float YGNodeLeadingBorder(const YGNodeRef node,
-                                 const YGFlexDirection axis) {
+static YG_AXIS_INLINE float YGNodeLeadingBorder(const YGNodeRef node,
+                                                const YGFlexDirection axis) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.border[YGEdgeStart].unit != YGUnitUndefined &&
-      node->style.border[YGEdgeStart].value >= 0.0f) {
-    return node->style.border[YGEdgeStart].value;
+      YGNodeHasStyleEdge(node, YGEdgePropertyBorder, YGEdgeStart)) {
+    const float start =
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyBorder, YGEdgeStart)->value;
+    if (start >= 0.0f) {
+      return start;
+    }
   }
 
   return fmaxf(
-      YGComputedEdgeValue(node->style.border, leading[axis], &YGValueZero)
-          ->value,
+      YGNodeResolvedStyleEdge(node, YGEdgePropertyBorder, leading[axis])->value,
       0.0f);
 }
 
-static float YGNodeTrailingBorder(const YGNodeRef node,
-                                  const YGFlexDirection axis) {
+static YG_AXIS_INLINE float YGNodeTrailingBorder(const YGNodeRef node,
+                                                 const YGFlexDirection axis) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.border[YGEdgeEnd].unit != YGUnitUndefined &&
-      node->style.border[YGEdgeEnd].value >= 0.0f) {
-    return node->style.border[YGEdgeEnd].value;
+      YGNodeHasStyleEdge(node, YGEdgePropertyBorder, YGEdgeEnd)) {
+    const float end =
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyBorder, YGEdgeEnd)->value;
+    if (end >= 0.0f) {
+      return end;
+    }
   }
 
   return fmaxf(
-      YGComputedEdgeValue(node->style.border, trailing[axis], &YGValueZero)
+      YGNodeResolvedStyleEdge(node, YGEdgePropertyBorder, trailing[axis])
           ->value,
       0.0f);
 }
 
-static inline float YGNodeLeadingPaddingAndBorder(const YGNodeRef node,
-                                                  const YGFlexDirection axis,
-                                                  const float widthSize) {
+static YG_AXIS_INLINE float YGNodeLeadingPaddingAndBorder(
+    const YGNodeRef node, const YGFlexDirection axis, const float widthSize) {
   return YGNodeLeadingPadding(node, axis, widthSize) +
          YGNodeLeadingBorder(node, axis);
 }
 
-static inline float YGNodeTrailingPaddingAndBorder(const YGNodeRef node,
-                                                   const YGFlexDirection axis,
-                                                   const float widthSize) {
+static YG_AXIS_INLINE float YGNodeTrailingPaddingAndBorder(
+    const YGNodeRef node, const YGFlexDirection axis, const float widthSize) {
   return YGNodeTrailingPadding(node, axis, widthSize) +
          YGNodeTrailingBorder(node, axis);
 }
 
-static inline float YGNodeMarginForAxis(const YGNodeRef node,
-                                        const YGFlexDirection axis,
-                                        const float widthSize) {
+static YG_AXIS_INLINE float YGNodeMarginForAxis(const YGNodeRef node,
+                                                const YGFlexDirection axis,
+                                                const float widthSize) {
   return YGNodeLeadingMargin(node, axis, widthSize) +
          YGNodeTrailingMargin(node, axis, widthSize);
 }
 
-static inline float YGNodePaddingAndBorderForAxis(const YGNodeRef node,
-                                                  const YGFlexDirection axis,
-                                                  const float widthSize) {
+static YG_AXIS_INLINE float YGNodePaddingAndBorderForAxis(
+    const YGNodeRef node, const YGFlexDirection axis, const float widthSize) {
   return YGNodeLeadingPaddingAndBorder(node, axis, widthSize) +
          YGNodeTrailingPaddingAndBorder(node, axis, widthSize);
 }
@@ -1348,7 +2680,9 @@ static inline YGDirection YGNodeResolveDirection(
   }
 }
 
-static float YGBaseline(const YGNodeRef node) {
+static float YGBaseline(const YGNodeRef node);
+
+static float YGComputeBaseline(const YGNodeRef node) {
   if (node->baseline != NULL) {
     const float baseline =
         node->baseline(node, node->layout.measuredDimensions[YGDimensionWidth],
@@ -1386,6 +2720,16 @@ static float YGBaseline(const YGNodeRef node) {
   return baseline + baselineChild->layout.position[YGEdgeTop];
 }
 
+// Baselines are asked for twice per child of a baseline aligned line, and the
+// baseline of a container recurses into its first child, so they are computed
+// once per layout of the node and kept in the layout until it changes.
+static float YGBaseline(const YGNodeRef node) {
+  if (YGFloatIsUndefined(node->layout.baseline)) {
+    node->layout.baseline = YGComputeBaseline(node);
+  }
+  return node->layout.baseline;
+}
+
 static inline YGFlexDirection YGResolveFlexDirection(
     const YGFlexDirection flexDirection, const YGDirection direction) {
   if (direction == YGDirectionRTL) {
@@ -1450,6 +2794,82 @@ static inline bool YGNodeIsStyleDimDefined(const YGNodeRef node,
              YGFloatIsUndefined(parentSize))));
 }
 
+// Whether the parent of |node| lays it out at the same size and position
+// whatever its content, so that once laid out at the constraints of
+// |cachedLayout| the node can be laid out again on its own when only its
+// content changes. Its width and height are set in points, none of its edges
+// or bounds depends on the size of its parent, and no ancestor reads its
+// baseline. The answer is kept in the layout of the node when it is laid out,
+// so that marking a node dirty does not walk the tree.
+static bool YGNodeIsRelayoutBoundary(const YGNodeRef node) {
+  const YGLayout *const layout = &node->layout;
+  if (node->parent == NULL || layout->hasBaselineReader ||
+      layout->cachedLayout.widthMeasureMode != YGMeasureModeExactly ||
+      layout->cachedLayout.heightMeasureMode != YGMeasureModeExactly ||
+      !YGNodeIsStyleDimDefined(node, YGFlexDirectionRow, YGUndefined) ||
+      !YGNodeIsStyleDimDefined(node, YGFlexDirectionColumn, YGUndefined)) {
+    return false;
+  }
+  const YGStyle *const style = &node->style;
+  for (uint32_t i = 0; i < 2; i++) {
+    if (style->minDimensions[i].unit == YGUnitPercent ||
+        style->maxDimensions[i].unit == YGUnitPercent) {
+      return false;
+    }
+  }
+  const uint32_t valueCount = YG_EDGE_VALUE_FIRST + style->edges.count;
+  for (uint32_t i = YG_EDGE_VALUE_FIRST; i < valueCount; i++) {
+    if (style->edges.values[i].unit == YGUnitPercent) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the first child of |node| in the flow, whose baseline a parent
+// without a baseline function takes unless it aligns a child to its baseline.
+static inline YGNodeRef YGNodeGetFirstFlowChild(const YGNodeRef node) {
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(&node->children, i);
+    if (child->style.positionType != YGPositionTypeAbsolute) {
+      return child;
+    }
+  }
+  return NULL;
+}
+
+// Whether the parent of |node| derives its baseline, or aligns the node, from
+// the baseline of the node as laid out.
+static bool YGNodeHasBaselineReader(const YGNodeRef node) {
+  const YGNodeRef parent = node->parent;
+  if (parent == NULL || node->baseline != NULL) {
+    return false;
+  }
+  if (YGNodeAlignItem(parent, node) == YGAlignBaseline) {
+    return true;
+  }
+  return parent->layout.hasBaselineReader &&
+         YGNodeGetFirstFlowChild(parent) == node;
+}
+
+// Refreshes whether the baseline of |node| is read, from the flag of its
+// parent. The children of a node answered by its layout cache are not laid
+// out, so a change is passed on to the first child, the only one it affects.
+static void YGNodeUpdateBaselineReader(const YGNodeRef node) {
+  YGLayout *const layout = &node->layout;
+  const bool hasBaselineReader = YGNodeHasBaselineReader(node);
+  if (layout->hasBaselineReader == hasBaselineReader) {
+    return;
+  }
+  layout->hasBaselineReader = hasBaselineReader;
+  layout->isRelayoutBoundary = YGNodeIsRelayoutBoundary(node);
+  const YGNodeRef firstChild = YGNodeGetFirstFlowChild(node);
+  if (firstChild != NULL) {
+    YGNodeUpdateBaselineReader(firstChild);
+  }
+}
+
 static inline bool YGNodeIsLayoutDimDefined(const YGNodeRef node,
                                             const YGFlexDirection axis) {
   const float value = node->layout.measuredDimensions[dim[axis]];
@@ -1459,22 +2879,18 @@ static inline bool YGNodeIsLayoutDimDefined(const YGNodeRef node,
 static inline bool YGNodeIsLeadingPosDefined(const YGNodeRef node,
                                              const YGFlexDirection axis) {
   return (YGFlexDirectionIsRow(axis) &&
-          YGComputedEdgeValue(node->style.position, YGEdgeStart,
-                              &YGValueUndefined)
+          YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, YGEdgeStart)
                   ->unit != YGUnitUndefined) ||
-         YGComputedEdgeValue(node->style.position, leading[axis],
-                             &YGValueUndefined)
+         YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, leading[axis])
                  ->unit != YGUnitUndefined;
 }
 
 static inline bool YGNodeIsTrailingPosDefined(const YGNodeRef node,
                                               const YGFlexDirection axis) {
   return (YGFlexDirectionIsRow(axis) &&
-          YGComputedEdgeValue(node->style.position, YGEdgeEnd,
-                              &YGValueUndefined)
+          YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, YGEdgeEnd)
                   ->unit != YGUnitUndefined) ||
-         YGComputedEdgeValue(node->style.position, trailing[axis],
-                             &YGValueUndefined)
+         YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, trailing[axis])
                  ->unit != YGUnitUndefined;
 }
 
@@ -1482,15 +2898,15 @@ static float YGNodeLeadingPosition(const YGNodeRef node,
                                    const YGFlexDirection axis,
                                    const float axisSize) {
   if (YGFlexDirectionIsRow(axis)) {
-    const YGValue *leadingPosition = YGComputedEdgeValue(
-        node->style.position, YGEdgeStart, &YGValueUndefined);
+    const YGValue *leadingPosition =
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, YGEdgeStart);
     if (leadingPosition->unit != YGUnitUndefined) {
       return YGResolveValue(leadingPosition, axisSize);
     }
   }
 
-  const YGValue *leadingPosition = YGComputedEdgeValue(
-      node->style.position, leading[axis], &YGValueUndefined);
+  const YGValue *leadingPosition =
+      YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, leading[axis]);
 
   return leadingPosition->unit == YGUnitUndefined
              ? 0.0f
@@ -1502,24 +2918,23 @@ static float YGNodeTrailingPosition(const YGNodeRef node,
                                     const float axisSize) {
   if (YGFlexDirectionIsRow(axis)) {
     const YGValue *trailingPosition =
-        YGComputedEdgeValue(node->style.position, YGEdgeEnd, &YGValueUndefined);
+        YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, YGEdgeEnd);
     if (trailingPosition->unit != YGUnitUndefined) {
       return YGResolveValue(trailingPosition, axisSize);
     }
   }
 
-  const YGValue *trailingPosition = YGComputedEdgeValue(
-      node->style.position, trailing[axis], &YGValueUndefined);
+  const YGValue *trailingPosition =
+      YGNodeResolvedStyleEdge(node, YGEdgePropertyPosition, trailing[axis]);
 
   return trailingPosition->unit == YGUnitUndefined
              ? 0.0f
              : YGResolveValue(trailingPosition, axisSize);
 }
 
-static float YGNodeBoundAxisWithinMinAndMax(const YGNodeRef node,
-                                            const YGFlexDirection axis,
-                                            const float value,
-                                            const float axisSize) {
+static YG_AXIS_INLINE float YGNodeBoundAxisWithinMinAndMax(
+    const YGNodeRef node, const YGFlexDirection axis, const float value,
+    const float axisSize) {
   float min = YGUndefined;
   float max = YGUndefined;
 
@@ -1548,32 +2963,31 @@ static float YGNodeBoundAxisWithinMinAndMax(const YGNodeRef node,
   return boundValue;
 }
 
-static inline YGValue *YGMarginLeadingValue(const YGNodeRef node,
-                                            const YGFlexDirection axis) {
+static inline const YGValue *YGMarginLeadingValue(
+    const YGNodeRef node, const YGFlexDirection axis) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.margin[YGEdgeStart].unit != YGUnitUndefined) {
-    return &node->style.margin[YGEdgeStart];
+      YGNodeHasStyleEdge(node, YGEdgePropertyMargin, YGEdgeStart)) {
+    return YGNodeStyleEdge(node, YGEdgePropertyMargin, YGEdgeStart);
   } else {
-    return &node->style.margin[leading[axis]];
+    return YGNodeStyleEdge(node, YGEdgePropertyMargin, leading[axis]);
   }
 }
 
-static inline YGValue *YGMarginTrailingValue(const YGNodeRef node,
-                                             const YGFlexDirection axis) {
+static inline const YGValue *YGMarginTrailingValue(
+    const YGNodeRef node, const YGFlexDirection axis) {
   if (YGFlexDirectionIsRow(axis) &&
-      node->style.margin[YGEdgeEnd].unit != YGUnitUndefined) {
-    return &node->style.margin[YGEdgeEnd];
+      YGNodeHasStyleEdge(node, YGEdgePropertyMargin, YGEdgeEnd)) {
+    return YGNodeStyleEdge(node, YGEdgePropertyMargin, YGEdgeEnd);
   } else {
-    return &node->style.margin[trailing[axis]];
+    return YGNodeStyleEdge(node, YGEdgePropertyMargin, trailing[axis]);
   }
 }
 
 // Like YGNodeBoundAxisWithinMinAndMax but also ensures that the value doesn't
 // go below the padding and border amount.
-static inline float YGNodeBoundAxis(const YGNodeRef node,
-                                    const YGFlexDirection axis,
-                                    const float value, const float axisSize,
-                                    const float widthSize) {
+static YG_AXIS_INLINE float YGNodeBoundAxis(
+    const YGNodeRef node, const YGFlexDirection axis, const float value,
+    const float axisSize, const float widthSize) {
   return fmaxf(YGNodeBoundAxisWithinMinAndMax(node, axis, value, axisSize),
                YGNodePaddingAndBorderForAxis(node, axis, widthSize));
 }
@@ -1652,7 +3066,8 @@ static void YGNodeComputeFlexBasisForChild(
     const YGNodeRef node, const YGNodeRef child, const float width,
     const YGMeasureMode widthMode, const float height, const float parentWidth,
     const float parentHeight, const YGMeasureMode heightMode,
-    const YGDirection direction, const YGConfigRef config) {
+    const YGDirection direction, const YGConfigRef config,
+    YGLayoutContext *const layoutContext) {
   const YGFlexDirection mainAxis =
       YGResolveFlexDirection(node->style.flexDirection, direction);
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
@@ -1677,7 +3092,7 @@ static void YGNodeComputeFlexBasisForChild(
         (YGConfigIsExperimentalFeatureEnabled(
              child->config, YGExperimentalFeatureWebFlexBasis) &&
          child->layout.computedFlexBasisGeneration !=
-             gCurrentGenerationCount)) {
+             layoutContext->generationCount)) {
       child->layout.computedFlexBasis =
           fmaxf(resolvedFlexBasis,
                 YGNodePaddingAndBorderForAxis(child, mainAxis, parentWidth));
@@ -1794,14 +3209,15 @@ static void YGNodeComputeFlexBasisForChild(
     // Measure the child
     YGLayoutNodeInternal(child, childWidth, childHeight, direction,
                          childWidthMeasureMode, childHeightMeasureMode,
-                         parentWidth, parentHeight, false, "measure", config);
+                         parentWidth, parentHeight, false, "measure", config,
+                         layoutContext);
 
     child->layout.computedFlexBasis =
         fmaxf(child->layout.measuredDimensions[dim[mainAxis]],
               YGNodePaddingAndBorderForAxis(child, mainAxis, parentWidth));
   }
 
-  child->layout.computedFlexBasisGeneration = gCurrentGenerationCount;
+  child->layout.computedFlexBasisGeneration = layoutContext->generationCount;
 }
 
 static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
@@ -1809,7 +3225,8 @@ static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
                                       const YGMeasureMode widthMode,
                                       const float height,
                                       const YGDirection direction,
-                                      const YGConfigRef config) {
+                                      const YGConfigRef config,
+                                      YGLayoutContext *const layoutContext) {
   const YGFlexDirection mainAxis =
       YGResolveFlexDirection(node->style.flexDirection, direction);
   const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
@@ -1901,7 +3318,8 @@ static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
 
     YGLayoutNodeInternal(child, childWidth, childHeight, direction,
                          childWidthMeasureMode, childHeightMeasureMode,
-                         childWidth, childHeight, false, "abs-measure", config);
+                         childWidth, childHeight, false, "abs-measure", config,
+                         layoutContext);
     childWidth = child->layout.measuredDimensions[YGDimensionWidth] +
                  YGNodeMarginForAxis(child, YGFlexDirectionRow, width);
     childHeight = child->layout.measuredDimensions[YGDimensionHeight] +
@@ -1910,7 +3328,7 @@ static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
 
   YGLayoutNodeInternal(child, childWidth, childHeight, direction,
                        YGMeasureModeExactly, YGMeasureModeExactly, childWidth,
-                       childHeight, true, "abs-layout", config);
+                       childHeight, true, "abs-layout", config, layoutContext);
 
   if (YGNodeIsTrailingPosDefined(child, mainAxis) &&
       !YGNodeIsLeadingPosDefined(child, mainAxis)) {
@@ -1957,11 +3375,289 @@ static void YGNodeAbsoluteLayoutChild(const YGNodeRef node,
   }
 }
 
+// Shared measurement cache
+//
+// Leaves whose content can be described by a key share their measurements
+// process-wide: the result of a measure function is stored under the key
+// returned by the node's measure key function, the measure function itself
+// and the constraints, and reused by any node reporting the same key. Entries
+// are evicted least recently used first. Layout passes may run concurrently,
+// so the cache is guarded by a spin lock; measure functions are always called
+// outside of it.
+
+#define YG_SHARED_MEASURE_CACHE_DEFAULT_CAPACITY 1024
+#define YG_SHARED_MEASURE_NONE UINT32_MAX
+
+typedef struct YGSharedMeasurement {
+  uint64_t key;
+  YGMeasureFunc measure;
+  uint32_t width;
+  uint32_t height;
+  YGMeasureMode widthMode;
+  YGMeasureMode heightMode;
+  YGSize size;
+  // Next entry of the same bucket.
+  uint32_t bucketNext;
+  // Neighbours in recency order, the head being the most recently used.
+  uint32_t lruPrev;
+  uint32_t lruNext;
+} YGSharedMeasurement;
+
+typedef struct YGSharedMeasureCache {
+  int32_t lock;
+  uint32_t capacity;
+  uint32_t count;
+  // A power of two no smaller than the capacity, 0 until the first insertion.
+  uint32_t bucketCount;
+  uint32_t *buckets;
+  YGSharedMeasurement *entries;
+  uint32_t lruHead;
+  uint32_t lruTail;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} YGSharedMeasureCache;
+
+static YGSharedMeasureCache gYGSharedMeasureCache = {
+    .capacity = YG_SHARED_MEASURE_CACHE_DEFAULT_CAPACITY,
+    .lruHead = YG_SHARED_MEASURE_NONE,
+    .lruTail = YG_SHARED_MEASURE_NONE,
+};
+
+static inline void YGSharedMeasureCacheLock(YGSharedMeasureCache *const cache) {
+  while (YG_ATOMIC_EXCHANGE_ACQUIRE(&cache->lock, 1) != 0) {
+  }
+}
+
+static inline void YGSharedMeasureCacheUnlock(
+    YGSharedMeasureCache *const cache) {
+  YG_ATOMIC_STORE_RELEASE(&cache->lock, 0);
+}
+
+// Constraints are compared bit for bit, with every undefined value the same.
+static inline uint32_t YGSharedMeasureConstraint(const float value) {
+  uint32_t bits;
+  if (YGFloatIsUndefined(value)) {
+    return UINT32_MAX;
+  }
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline uint32_t YGSharedMeasurementBucket(
+    const YGSharedMeasurement *const entry, const uint32_t bucketCount) {
+  uint64_t hash = entry->key ^ (uint64_t)(uintptr_t)entry->measure;
+  hash ^= ((uint64_t)entry->width << 32 | entry->height) +
+          0x9e3779b97f4a7c15ull +
+          ((uint64_t)entry->widthMode << 2 | entry->heightMode);
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+  return (uint32_t)(hash ^ (hash >> 31)) & (bucketCount - 1);
+}
+
+static inline bool YGSharedMeasurementsEqual(const YGSharedMeasurement *a,
+                                             const YGSharedMeasurement *b) {
+  return a->key == b->key && a->measure == b->measure &&
+         a->width == b->width && a->height == b->height &&
+         a->widthMode == b->widthMode && a->heightMode == b->heightMode;
+}
+
+static void YGSharedMeasureCacheUnlink(YGSharedMeasureCache *const cache,
+                                       const uint32_t index) {
+  YGSharedMeasurement *const entry = &cache->entries[index];
+  if (entry->lruPrev != YG_SHARED_MEASURE_NONE) {
+    cache->entries[entry->lruPrev].lruNext = entry->lruNext;
+  } else {
+    cache->lruHead = entry->lruNext;
+  }
+  if (entry->lruNext != YG_SHARED_MEASURE_NONE) {
+    cache->entries[entry->lruNext].lruPrev = entry->lruPrev;
+  } else {
+    cache->lruTail = entry->lruPrev;
+  }
+}
+
+static void YGSharedMeasureCachePushFront(YGSharedMeasureCache *const cache,
+                                          const uint32_t index) {
+  YGSharedMeasurement *const entry = &cache->entries[index];
+  entry->lruPrev = YG_SHARED_MEASURE_NONE;
+  entry->lruNext = cache->lruHead;
+  if (cache->lruHead != YG_SHARED_MEASURE_NONE) {
+    cache->entries[cache->lruHead].lruPrev = index;
+  } else {
+    cache->lruTail = index;
+  }
+  cache->lruHead = index;
+}
+
+// Returns the index of the entry matching |probe|, or YG_SHARED_MEASURE_NONE.
+// |bucketIndex| receives the bucket the entry belongs to.
+static uint32_t YGSharedMeasureCacheFind(
+    const YGSharedMeasureCache *const cache,
+    const YGSharedMeasurement *const probe, uint32_t *const bucketIndex) {
+  *bucketIndex = YGSharedMeasurementBucket(probe, cache->bucketCount);
+  uint32_t index = cache->buckets[*bucketIndex];
+  while (index != YG_SHARED_MEASURE_NONE &&
+         !YGSharedMeasurementsEqual(&cache->entries[index], probe)) {
+    index = cache->entries[index].bucketNext;
+  }
+  return index;
+}
+
+static void YGSharedMeasureCacheRemoveFromBucket(
+    YGSharedMeasureCache *const cache, const uint32_t index) {
+  const YGSharedMeasurement *const entry = &cache->entries[index];
+  uint32_t *link =
+      &cache->buckets[YGSharedMeasurementBucket(entry, cache->bucketCount)];
+  while (*link != index) {
+    link = &cache->entries[*link].bucketNext;
+  }
+  *link = entry->bucketNext;
+}
+
+static void YGSharedMeasureCacheReleaseStorage(
+    YGSharedMeasureCache *const cache) {
+  if (cache->bucketCount > 0) {
+    gYGFree(cache->buckets);
+    gYGFree(cache->entries);
+  }
+  cache->buckets = NULL;
+  cache->entries = NULL;
+  cache->bucketCount = 0;
+  cache->count = 0;
+  cache->lruHead = YG_SHARED_MEASURE_NONE;
+  cache->lruTail = YG_SHARED_MEASURE_NONE;
+}
+
+static bool YGSharedMeasureCacheLookup(const YGSharedMeasurement *const probe,
+                                       YGSize *const size) {
+  YGSharedMeasureCache *const cache = &gYGSharedMeasureCache;
+  YGSharedMeasureCacheLock(cache);
+  uint32_t bucketIndex;
+  const uint32_t index =
+      cache->count > 0 ? YGSharedMeasureCacheFind(cache, probe, &bucketIndex)
+                       : YG_SHARED_MEASURE_NONE;
+  if (index != YG_SHARED_MEASURE_NONE) {
+    *size = cache->entries[index].size;
+    YGSharedMeasureCacheUnlink(cache, index);
+    YGSharedMeasureCachePushFront(cache, index);
+    cache->hits++;
+  } else {
+    cache->misses++;
+  }
+  YGSharedMeasureCacheUnlock(cache);
+  return index != YG_SHARED_MEASURE_NONE;
+}
+
+static void YGSharedMeasureCacheInsert(const YGSharedMeasurement *const probe,
+                                       const YGSize size) {
+  YGSharedMeasureCache *const cache = &gYGSharedMeasureCache;
+  YGSharedMeasureCacheLock(cache);
+  if (cache->capacity == 0) {
+    YGSharedMeasureCacheUnlock(cache);
+    return;
+  }
+  if (cache->bucketCount == 0) {
+    uint32_t bucketCount = 1;
+    while (bucketCount < cache->capacity) {
+      bucketCount *= 2;
+    }
+    cache->buckets = gYGMalloc(bucketCount * sizeof(uint32_t));
+    cache->entries = gYGMalloc(cache->capacity * sizeof(YGSharedMeasurement));
+    YGAssert(cache->buckets != NULL && cache->entries != NULL,
+             "Could not allocate memory for the shared measurement cache");
+    memset(cache->buckets, 0xff, bucketCount * sizeof(uint32_t));
+    cache->bucketCount = bucketCount;
+  }
+
+  // Another pass may have inserted the same measurement in the meantime.
+  uint32_t bucketIndex;
+  uint32_t index = YGSharedMeasureCacheFind(cache, probe, &bucketIndex);
+  if (index != YG_SHARED_MEASURE_NONE) {
+    YGSharedMeasureCacheUnlink(cache, index);
+  } else {
+    if (cache->count < cache->capacity) {
+      index = cache->count++;
+    } else {
+      index = cache->lruTail;
+      YGSharedMeasureCacheUnlink(cache, index);
+      YGSharedMeasureCacheRemoveFromBucket(cache, index);
+      cache->evictions++;
+    }
+    cache->entries[index] = *probe;
+    cache->entries[index].bucketNext = cache->buckets[bucketIndex];
+    cache->buckets[bucketIndex] = index;
+  }
+  cache->entries[index].size = size;
+  YGSharedMeasureCachePushFront(cache, index);
+  YGSharedMeasureCacheUnlock(cache);
+}
+
+void YGSharedMeasureCacheSetCapacity(const uint32_t capacity) {
+  YGSharedMeasureCache *const cache = &gYGSharedMeasureCache;
+  YGSharedMeasureCacheLock(cache);
+  YGSharedMeasureCacheReleaseStorage(cache);
+  cache->capacity = capacity;
+  YGSharedMeasureCacheUnlock(cache);
+}
+
+void YGSharedMeasureCacheClear(void) {
+  YGSharedMeasureCache *const cache = &gYGSharedMeasureCache;
+  YGSharedMeasureCacheLock(cache);
+  YGSharedMeasureCacheReleaseStorage(cache);
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->evictions = 0;
+  YGSharedMeasureCacheUnlock(cache);
+}
+
+YGMeasureCacheStats YGSharedMeasureCacheGetStats(void) {
+  YGSharedMeasureCache *const cache = &gYGSharedMeasureCache;
+  YGSharedMeasureCacheLock(cache);
+  const YGMeasureCacheStats stats = {
+      .hits = cache->hits,
+      .misses = cache->misses,
+      .evictions = cache->evictions,
+      .count = cache->count,
+      .capacity = cache->capacity,
+  };
+  YGSharedMeasureCacheUnlock(cache);
+  return stats;
+}
+
+// Calls the measure function of |node|, or reuses the measurement of a node
+// with the same measure key.
+static YGSize YGNodeMeasure(const YGNodeRef node, const float width,
+                            const YGMeasureMode widthMode, const float height,
+                            const YGMeasureMode heightMode,
+                            YGLayoutContext *const layoutContext) {
+  const uint64_t key = node->measureKey != NULL ? node->measureKey(node) : 0;
+  if (key == 0) {
+    layoutContext->stats.measureCalls++;
+    return node->measure(node, width, widthMode, height, heightMode);
+  }
+  const YGSharedMeasurement probe = {
+      .key = key,
+      .measure = node->measure,
+      .width = YGSharedMeasureConstraint(width),
+      .height = YGSharedMeasureConstraint(height),
+      .widthMode = widthMode,
+      .heightMode = heightMode,
+  };
+  YGSize size;
+  if (!YGSharedMeasureCacheLookup(&probe, &size)) {
+    layoutContext->stats.measureCalls++;
+    size = node->measure(node, width, widthMode, height, heightMode);
+    YGSharedMeasureCacheInsert(&probe, size);
+  }
+  return size;
+}
+
 static void YGNodeWithMeasureFuncSetMeasuredDimensions(
     const YGNodeRef node, const float availableWidth,
     const float availableHeight, const YGMeasureMode widthMeasureMode,
     const YGMeasureMode heightMeasureMode, const float parentWidth,
-    const float parentHeight) {
+    const float parentHeight, YGLayoutContext *const layoutContext) {
   YGAssertWithNode(node, node->measure != NULL,
                    "Expected node to have custom measure function");
 
@@ -1995,8 +3691,9 @@ static void YGNodeWithMeasureFuncSetMeasuredDimensions(
         parentHeight, parentWidth);
   } else {
     // Measure the text under the current constraints.
-    const YGSize measuredSize = node->measure(
-        node, innerWidth, widthMeasureMode, innerHeight, heightMeasureMode);
+    const YGSize measuredSize =
+        YGNodeMeasure(node, innerWidth, widthMeasureMode, innerHeight,
+                      heightMeasureMode, layoutContext);
 
     node->layout.measuredDimensions[YGDimensionWidth] =
         YGNodeBoundAxis(node, YGFlexDirectionRow,
@@ -2087,191 +3784,1227 @@ static bool YGNodeFixedSizeSetMeasuredDimensions(
 
 static void YGZeroOutLayoutRecursivly(const YGNodeRef node) {
   memset(&(node->layout), 0, sizeof(YGLayout));
+  node->layout.baseline = YGUndefined;
   node->hasNewLayout = true;
   YGCloneChildrenIfNeeded(node);
   const uint32_t childCount = YGNodeGetChildCount(node);
   for (uint32_t i = 0; i < childCount; i++) {
-    const YGNodeRef child = YGNodeListGet(node->children, i);
+    const YGNodeRef child = YGNodeListGet(&node->children, i);
     YGZeroOutLayoutRecursivly(child);
   }
 }
 
+// A child layout that does not depend on its siblings. Wide containers queue
+// these in a batch and run the batch on the parallel layout pool.
+typedef struct YGChildLayoutJob {
+  YGNodeRef child;
+  float width;
+  float height;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+  bool performLayout;
+  // Counters of the job, added to those of the pass once the batch is done.
+  YGLayoutStats stats;
+} YGChildLayoutJob;
+
+typedef struct YGChildLayoutBatch {
+  YGChildLayoutJob *jobs;
+  uint32_t count;
+
+  // Arguments shared by every job of the container.
+  YGNodeRef node;
+  float availableInnerWidth;
+  float availableInnerHeight;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+  YGDirection direction;
+  YGConfigRef config;
+  const YGLayoutContext *layoutContext;
+} YGChildLayoutBatch;
+
+static inline bool YGConfigShouldLayoutChildrenInParallel(
+    const YGConfigRef config, const uint32_t childCount) {
+  // Cloning shared children would touch nodes reachable from other subtrees.
+  return config->parallelLayout && config->cloneNodeCallback == NULL &&
+         childCount > config->parallelLayoutGrainSize;
+}
+
+// Depth, counters and scratch memory are the only state a pass mutates, so
+// each job runs with its own copy of the context, keeps its counters in its own
+// slot and has its own scratch memory.
+static YGLayoutContext YGChildLayoutBatchContext(
+    const YGChildLayoutBatch *const batch,
+    YGScratchInlineBlock *const inlineScratch) {
+  YGLayoutContext layoutContext = *batch->layoutContext;
+  memset(&layoutContext.stats, 0, sizeof(YGLayoutStats));
+  YGScratchStackInit(&layoutContext.scratch, inlineScratch);
+  return layoutContext;
+}
+
+static void YGChildLayoutBatchComputeFlexBasis(void *userData,
+                                               const uint32_t index) {
+  const YGChildLayoutBatch *const batch = userData;
+  YGChildLayoutJob *const job = &batch->jobs[index];
+  YGScratchInlineBlock inlineScratch;
+  YGLayoutContext layoutContext =
+      YGChildLayoutBatchContext(batch, &inlineScratch);
+  YGNodeComputeFlexBasisForChild(
+      batch->node, job->child, batch->availableInnerWidth,
+      batch->widthMeasureMode, batch->availableInnerHeight,
+      batch->availableInnerWidth, batch->availableInnerHeight,
+      batch->heightMeasureMode, batch->direction, batch->config,
+      &layoutContext);
+  job->stats = layoutContext.stats;
+  YGScratchStackFree(&layoutContext.scratch);
+}
+
+static void YGChildLayoutBatchLayout(void *userData, const uint32_t index) {
+  const YGChildLayoutBatch *const batch = userData;
+  YGChildLayoutJob *const job = &batch->jobs[index];
+  YGScratchInlineBlock inlineScratch;
+  YGLayoutContext layoutContext =
+      YGChildLayoutBatchContext(batch, &inlineScratch);
+  YGLayoutNodeInternal(job->child, job->width, job->height, batch->direction,
+                       job->widthMeasureMode, job->heightMeasureMode,
+                       batch->availableInnerWidth, batch->availableInnerHeight,
+                       job->performLayout, "flex", batch->config,
+                       &layoutContext);
+  job->stats = layoutContext.stats;
+  YGScratchStackFree(&layoutContext.scratch);
+}
+
+static void YGLayoutStatsAdd(YGLayoutStats *const stats,
+                             const YGLayoutStats *const other) {
+  stats->nodesVisited += other->nodesVisited;
+  stats->layoutCacheHits += other->layoutCacheHits;
+  stats->measurementCacheHits += other->measurementCacheHits;
+  stats->measureCalls += other->measureCalls;
+  stats->stretchLayoutsAvoided += other->stretchLayoutsAvoided;
+  stats->relayoutBoundaries += other->relayoutBoundaries;
+  if (other->maxDepth > stats->maxDepth) {
+    stats->maxDepth = other->maxDepth;
+  }
+}
+
+// Distributes the free space of a flex line according to justify-content.
+static void YGJustifyLine(const YGJustify justifyContent,
+                          const float remainingFreeSpace,
+                          const uint32_t itemsOnLine,
+                          float *const leadingMainDim,
+                          float *const betweenMainDim) {
+  switch (justifyContent) {
+    case YGJustifyCenter:
+      *leadingMainDim = remainingFreeSpace / 2;
+      break;
+    case YGJustifyFlexEnd:
+      *leadingMainDim = remainingFreeSpace;
+      break;
+    case YGJustifySpaceBetween:
+      if (itemsOnLine > 1) {
+        *betweenMainDim = fmaxf(remainingFreeSpace, 0) / (itemsOnLine - 1);
+      } else {
+        *betweenMainDim = 0;
+      }
+      break;
+    case YGJustifySpaceAround:
+      // Space on the edges is half of the space between elements
+      *betweenMainDim = remainingFreeSpace / itemsOnLine;
+      *leadingMainDim = *betweenMainDim / 2;
+      break;
+    case YGJustifyFlexStart:
+      break;
+  }
+}
+
+// Distributes the free cross space of a multi-line container according to
+// align-content.
+static void YGAlignLines(const YGAlign alignContent,
+                         const float availableInnerCrossDim,
+                         const float totalLineCrossDim,
+                         const uint32_t lineCount, float *const currentLead,
+                         float *const crossDimLead) {
+  const float remainingAlignContentDim =
+      availableInnerCrossDim - totalLineCrossDim;
+
+  switch (alignContent) {
+    case YGAlignFlexEnd:
+      *currentLead += remainingAlignContentDim;
+      break;
+    case YGAlignCenter:
+      *currentLead += remainingAlignContentDim / 2;
+      break;
+    case YGAlignStretch:
+      if (availableInnerCrossDim > totalLineCrossDim) {
+        *crossDimLead = remainingAlignContentDim / lineCount;
+      }
+      break;
+    case YGAlignSpaceAround:
+      if (availableInnerCrossDim > totalLineCrossDim) {
+        *currentLead += remainingAlignContentDim / (2 * lineCount);
+        if (lineCount > 1) {
+          *crossDimLead = remainingAlignContentDim / lineCount;
+        }
+      } else {
+        *currentLead += remainingAlignContentDim / 2;
+      }
+      break;
+    case YGAlignSpaceBetween:
+      if (availableInnerCrossDim > totalLineCrossDim && lineCount > 1) {
+        *crossDimLead = remainingAlignContentDim / (lineCount - 1);
+      }
+      break;
+    case YGAlignAuto:
+    case YGAlignFlexStart:
+    case YGAlignBaseline:
+      break;
+  }
+}
+
+// STEP 9 of the algorithm: sizes the container from its lines along the axes
+// it was not given an exact size for.
+static void YGNodeSetMeasuredDimensionsFromLines(
+    const YGNodeRef node, const float availableWidth,
+    const float availableHeight, const YGFlexDirection mainAxis,
+    const YGFlexDirection crossAxis, const YGMeasureMode measureModeMainDim,
+    const YGMeasureMode measureModeCrossDim, const float availableInnerMainDim,
+    const float availableInnerCrossDim, const float maxLineMainDim,
+    const float totalLineCrossDim, const float parentWidth,
+    const float parentHeight) {
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const float mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
+  const float crossAxisParentSize = isMainAxisRow ? parentHeight : parentWidth;
+  const float paddingAndBorderAxisMain =
+      YGNodePaddingAndBorderForAxis(node, mainAxis, parentWidth);
+  const float paddingAndBorderAxisCross =
+      YGNodePaddingAndBorderForAxis(node, crossAxis, parentWidth);
+  const float marginAxisRow =
+      YGNodeMarginForAxis(node, YGFlexDirectionRow, parentWidth);
+  const float marginAxisColumn =
+      YGNodeMarginForAxis(node, YGFlexDirectionColumn, parentWidth);
+
+  node->layout.measuredDimensions[YGDimensionWidth] =
+      YGNodeBoundAxis(node, YGFlexDirectionRow, availableWidth - marginAxisRow,
+                      parentWidth, parentWidth);
+  node->layout.measuredDimensions[YGDimensionHeight] = YGNodeBoundAxis(
+      node, YGFlexDirectionColumn, availableHeight - marginAxisColumn,
+      parentHeight, parentWidth);
+
+  // If the user didn't specify a width or height for the node, set the
+  // dimensions based on the children.
+  if (measureModeMainDim == YGMeasureModeUndefined ||
+      (node->style.overflow != YGOverflowScroll &&
+       measureModeMainDim == YGMeasureModeAtMost)) {
+    // Clamp the size to the min/max size, if specified, and make sure it
+    // doesn't go below the padding and border amount.
+    node->layout.measuredDimensions[dim[mainAxis]] = YGNodeBoundAxis(
+        node, mainAxis, maxLineMainDim, mainAxisParentSize, parentWidth);
+  } else if (measureModeMainDim == YGMeasureModeAtMost &&
+             node->style.overflow == YGOverflowScroll) {
+    node->layout.measuredDimensions[dim[mainAxis]] =
+        fmaxf(fminf(availableInnerMainDim + paddingAndBorderAxisMain,
+                    YGNodeBoundAxisWithinMinAndMax(
+                        node, mainAxis, maxLineMainDim, mainAxisParentSize)),
+              paddingAndBorderAxisMain);
+  }
+
+  if (measureModeCrossDim == YGMeasureModeUndefined ||
+      (node->style.overflow != YGOverflowScroll &&
+       measureModeCrossDim == YGMeasureModeAtMost)) {
+    // Clamp the size to the min/max size, if specified, and make sure it
+    // doesn't go below the padding and border amount.
+    node->layout.measuredDimensions[dim[crossAxis]] = YGNodeBoundAxis(
+        node, crossAxis, totalLineCrossDim + paddingAndBorderAxisCross,
+        crossAxisParentSize, parentWidth);
+  } else if (measureModeCrossDim == YGMeasureModeAtMost &&
+             node->style.overflow == YGOverflowScroll) {
+    node->layout.measuredDimensions[dim[crossAxis]] =
+        fmaxf(fminf(availableInnerCrossDim + paddingAndBorderAxisCross,
+                    YGNodeBoundAxisWithinMinAndMax(
+                        node, crossAxis,
+                        totalLineCrossDim + paddingAndBorderAxisCross,
+                        crossAxisParentSize)),
+              paddingAndBorderAxisCross);
+  }
+}
+
+// Whether the children of |node| are identical leaves that the uniform grid
+// kernel can place: wrapped rows or columns of same-size cells, such as photo
+// grids and launcher icons. Every child must have the style of the first one,
+// a size in points along both axes and nothing that would make flex layout
+// treat it apart from its siblings: flex, auto margins, offsets, percentages
+// or baseline alignment.
+static bool YGNodeHasUniformChildren(const YGNodeRef node,
+                                     const YGFlexDirection mainAxis,
+                                     const YGFlexDirection crossAxis) {
+  if (mainAxis == YGFlexDirectionRowReverse ||
+      mainAxis == YGFlexDirectionColumnReverse ||
+      crossAxis == YGFlexDirectionRowReverse ||
+      crossAxis == YGFlexDirectionColumnReverse ||
+      node->style.flexWrap == YGWrapWrapReverse ||
+      node->style.alignItems == YGAlignBaseline) {
+    return false;
+  }
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  YGNodeRef *const children = YGNodeListItems(&node->children);
+  const YGNodeRef first = children[0];
+  if (YGNodeListCount(&first->children) > 0 ||
+      first->style.display != YGDisplayFlex ||
+      first->style.positionType != YGPositionTypeRelative ||
+      YGNodeIsFlex(first) || !YGFloatIsUndefined(first->style.aspectRatio) ||
+      YGNodeResolveFlexBasisPtr(first)->unit != YGUnitAuto) {
+    return false;
+  }
+
+  const YGAlign align = YGNodeAlignItem(node, first);
+  if (align != YGAlignFlexStart && align != YGAlignCenter &&
+      align != YGAlignFlexEnd && align != YGAlignStretch) {
+    return false;
+  }
+
+  YGResolveDimensions(first);
+  for (YGFlexDirection axis = YGFlexDirectionColumn;
+       axis <= YGFlexDirectionRow; axis++) {
+    const YGValue *const size = first->resolvedDimensions[dim[axis]];
+    const YGUnit minUnit = first->style.minDimensions[dim[axis]].unit;
+    const YGUnit maxUnit = first->style.maxDimensions[dim[axis]].unit;
+    if (size->unit != YGUnitPoint || size->value < 0.0f ||
+        minUnit == YGUnitPercent || maxUnit == YGUnitPercent ||
+        YGMarginLeadingValue(first, axis)->unit == YGUnitAuto ||
+        YGMarginTrailingValue(first, axis)->unit == YGUnitAuto ||
+        YGNodeIsLeadingPosDefined(first, axis) ||
+        YGNodeIsTrailingPosDefined(first, axis)) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 1; i < childCount; i++) {
+    const YGNodeRef child = children[i];
+    if (YGNodeListCount(&child->children) > 0 ||
+        (child->measure == NULL) != (first->measure == NULL) ||
+        !YGStyleEqual(&child->style, &first->style)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Gives |node| the layout its identical sibling |source| was just given for
+// the constraints of |cachedLayout|, as YGLayoutNodeInternal would have.
+static inline void YGNodeCopyUniformLayout(
+    const YGNodeRef node, const YGNodeRef source,
+    const YGCachedMeasurement *const cachedLayout,
+    const YGDirection parentDirection, const uint32_t generationCount) {
+  YGLayout *const layout = &node->layout;
+  const YGLayout *const sourceLayout = &source->layout;
+  if ((node->isDirty && layout->generationCount != generationCount) ||
+      layout->lastParentDirection != parentDirection) {
+    layout->nextCachedMeasurementsIndex = 0;
+  }
+  if (layout->measuredDimensions[YGDimensionWidth] !=
+          sourceLayout->measuredDimensions[YGDimensionWidth] ||
+      layout->measuredDimensions[YGDimensionHeight] !=
+          sourceLayout->measuredDimensions[YGDimensionHeight]) {
+    layout->baseline = YGUndefined;
+  }
+
+  YGResolveDimensions(node);
+  layout->direction = sourceLayout->direction;
+  memcpy(layout->margin, sourceLayout->margin, sizeof(layout->margin));
+  memcpy(layout->border, sourceLayout->border, sizeof(layout->border));
+  memcpy(layout->padding, sourceLayout->padding, sizeof(layout->padding));
+  layout->computedFlexBasis = sourceLayout->computedFlexBasis;
+  layout->computedFlexBasisGeneration =
+      sourceLayout->computedFlexBasisGeneration;
+  layout->measuredDimensions[YGDimensionWidth] =
+      sourceLayout->measuredDimensions[YGDimensionWidth];
+  layout->measuredDimensions[YGDimensionHeight] =
+      sourceLayout->measuredDimensions[YGDimensionHeight];
+  layout->dimensions[YGDimensionWidth] =
+      sourceLayout->measuredDimensions[YGDimensionWidth];
+  layout->dimensions[YGDimensionHeight] =
+      sourceLayout->measuredDimensions[YGDimensionHeight];
+  layout->cachedLayout = *cachedLayout;
+  layout->cachedLayout.computedWidth =
+      sourceLayout->measuredDimensions[YGDimensionWidth];
+  layout->cachedLayout.computedHeight =
+      sourceLayout->measuredDimensions[YGDimensionHeight];
+  layout->lastParentDirection = parentDirection;
+  layout->generationCount = generationCount;
+  YGNodeUpdateBaselineReader(node);
+  layout->isRelayoutBoundary = YGNodeIsRelayoutBoundary(node);
+  node->hasNewLayout = true;
+  node->isDirty = false;
+}
+
+// STEPs 3 to 8 of the algorithm for children accepted by
+// YGNodeHasUniformChildren. Every child has the same flex basis and is given
+// the same size, so only the first child is laid out and the others copy its
+// layout instead of recursing. Lines are then broken, justified and aligned
+// with the arithmetic of the general steps, in the same order so that the
+// results are identical to the last bit, and positions are written in one
+// tight loop per line.
 //
-// This is the main routine that implements a subset of the flexbox layout
-// algorithm
-// described in the W3C YG documentation: https://www.w3.org/TR/YG3-flexbox/.
-//
-// Limitations of this algorithm, compared to the full standard:
-//  * Display property is always assumed to be 'flex' except for Text nodes,
-//  which
-//    are assumed to be 'inline-flex'.
-//  * The 'zIndex' property (or any form of z ordering) is not supported. Nodes
-//  are
-//    stacked in document order.
-//  * The 'order' property is not supported. The order of flex items is always
-//  defined
-//    by document order.
-//  * The 'visibility' property is always assumed to be 'visible'. Values of
-//  'collapse'
-//    and 'hidden' are not supported.
-//  * There is no support for forced breaks.
-//  * It does not support vertical inline directions (top-to-bottom or
-//  bottom-to-top text).
-//
-// Deviations from standard:
-//  * Section 4.5 of the spec indicates that all flex items have a default
-//  minimum
-//    main size. For text blocks, for example, this is the width of the widest
-//    word.
-//    Calculating the minimum width is expensive, so we forego it and assume a
-//    default
-//    minimum main size of 0.
-//  * Min/Max sizes in the main axis are not honored when resolving flexible
-//  lengths.
-//  * The spec indicates that the default value for 'flexDirection' is 'row',
-//  but
-//    the algorithm below assumes a default of 'column'.
-//
-// Input parameters:
-//    - node: current node to be sized and layed out
-//    - availableWidth & availableHeight: available size to be used for sizing
-//    the node
-//      or YGUndefined if the size is not available; interpretation depends on
-//      layout
-//      flags
-//    - parentDirection: the inline (text) direction within the parent
-//    (left-to-right or
-//      right-to-left)
-//    - widthMeasureMode: indicates the sizing rules for the width (see below
-//    for explanation)
-//    - heightMeasureMode: indicates the sizing rules for the height (see below
-//    for explanation)
-//    - performLayout: specifies whether the caller is interested in just the
-//    dimensions
-//      of the node or it requires the entire node and its subtree to be layed
-//      out
-//      (with final positions)
-//
-// Details:
-//    This routine is called recursively to lay out subtrees of flexbox
-//    elements. It uses the
-//    information in node.style, which is treated as a read-only input. It is
-//    responsible for
-//    setting the layout.direction and layout.measuredDimensions fields for the
-//    input node as well
-//    as the layout.position and layout.lineIndex fields for its child nodes.
-//    The
-//    layout.measuredDimensions field includes any border or padding for the
-//    node but does
-//    not include margins.
-//
-//    The spec describes four different layout modes: "fill available", "max
-//    content", "min
-//    content",
-//    and "fit content". Of these, we don't use "min content" because we don't
-//    support default
-//    minimum main sizes (see above for details). Each of our measure modes maps
-//    to a layout mode
-//    from the spec (https://www.w3.org/TR/YG3-sizing/#terms):
-//      - YGMeasureModeUndefined: max content
-//      - YGMeasureModeExactly: fill available
-//      - YGMeasureModeAtMost: fit content
-//
-//    When calling YGNodelayoutImpl and YGLayoutNodeInternal, if the caller
-//    passes an available size of undefined then it must also pass a measure
-//    mode of YGMeasureModeUndefined in that dimension.
-//
-static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
-                             const float availableHeight,
-                             const YGDirection parentDirection,
-                             const YGMeasureMode widthMeasureMode,
-                             const YGMeasureMode heightMeasureMode,
-                             const float parentWidth, const float parentHeight,
-                             const bool performLayout,
-                             const YGConfigRef config) {
-  YGAssertWithNode(node,
-                   YGFloatIsUndefined(availableWidth)
-                       ? widthMeasureMode == YGMeasureModeUndefined
-                       : true,
-                   "availableWidth is indefinite so widthMeasureMode must be "
-                   "YGMeasureModeUndefined");
-  YGAssertWithNode(node,
-                   YGFloatIsUndefined(availableHeight)
-                       ? heightMeasureMode == YGMeasureModeUndefined
-                       : true,
-                   "availableHeight is indefinite so heightMeasureMode must be "
-                   "YGMeasureModeUndefined");
+// Updates the main axis measure mode and available size like the general
+// steps do, and returns the dimensions of the lines for STEP 9.
+static void YGNodeLayoutUniformChildren(
+    const YGNodeRef node, const YGFlexDirection mainAxis,
+    const YGFlexDirection crossAxis, const YGDirection direction,
+    const float availableInnerWidth, const float availableInnerHeight,
+    const YGMeasureMode widthMeasureMode,
+    const YGMeasureMode heightMeasureMode, float *const availableInnerMainDim,
+    YGMeasureMode *const measureModeMainDim, const float minInnerMainDim,
+    const float maxInnerMainDim, const float parentWidth,
+    const float parentHeight, const bool performLayout,
+    const YGConfigRef config, YGLayoutContext *const layoutContext,
+    float *const maxLineMainDim, float *const totalLineCrossDim) {
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  YGNodeRef *const children = YGNodeListItems(&node->children);
+  const YGNodeRef first = children[0];
+  const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
+  const bool isNodeFlexWrap = node->style.flexWrap != YGWrapNoWrap;
+  const YGMeasureMode measureModeCrossDim =
+      isMainAxisRow ? heightMeasureMode : widthMeasureMode;
+  const float mainAxisParentSize = isMainAxisRow ? parentWidth : parentHeight;
+  const float crossAxisParentSize = isMainAxisRow ? parentHeight : parentWidth;
+  const float availableInnerCrossDim =
+      isMainAxisRow ? availableInnerHeight : availableInnerWidth;
+  const float leadingPaddingAndBorderMain =
+      YGNodeLeadingPaddingAndBorder(node, mainAxis, parentWidth);
+  const float trailingPaddingAndBorderMain =
+      YGNodeTrailingPaddingAndBorder(node, mainAxis, parentWidth);
+  const float leadingPaddingAndBorderCross =
+      YGNodeLeadingPaddingAndBorder(node, crossAxis, parentWidth);
+  const float paddingAndBorderAxisCross =
+      YGNodePaddingAndBorderForAxis(node, crossAxis, parentWidth);
+  const YGEdge mainEdge = pos[mainAxis];
+  const YGEdge crossEdge = pos[crossAxis];
+  const YGAlign align = YGNodeAlignItem(node, first);
 
-  // Set the resolved resolution in the node's layout.
-  const YGDirection direction = YGNodeResolveDirection(node, parentDirection);
-  node->layout.direction = direction;
+  // STEP 3: DETERMINE FLEX BASIS FOR EACH ITEM
+  float position[4] = {0, 0, 0, 0};
+  if (performLayout) {
+    YGNodeSetPosition(first, YGNodeResolveDirection(first, direction),
+                      *availableInnerMainDim, availableInnerCrossDim,
+                      availableInnerWidth);
+    memcpy(position, first->layout.position, sizeof(position));
+  }
+  YGNodeComputeFlexBasisForChild(
+      node, first, availableInnerWidth, widthMeasureMode, availableInnerHeight,
+      availableInnerWidth, availableInnerHeight, heightMeasureMode, direction,
+      config, layoutContext);
+  const float flexBasis = first->layout.computedFlexBasis;
+  const float marginMain =
+      YGNodeMarginForAxis(first, mainAxis, availableInnerWidth);
+  const float marginCross =
+      YGNodeMarginForAxis(first, crossAxis, availableInnerWidth);
 
-  const YGFlexDirection flexRowDirection =
-      YGResolveFlexDirection(YGFlexDirectionRow, direction);
-  const YGFlexDirection flexColumnDirection =
-      YGResolveFlexDirection(YGFlexDirectionColumn, direction);
+  float totalOuterFlexBasis = 0;
+  for (uint32_t i = 0; i < childCount; i++) {
+    totalOuterFlexBasis += flexBasis + marginMain;
+  }
+  const bool flexBasisOverflows =
+      *measureModeMainDim == YGMeasureModeUndefined
+          ? false
+          : totalOuterFlexBasis > *availableInnerMainDim;
+  if (isNodeFlexWrap && flexBasisOverflows &&
+      *measureModeMainDim == YGMeasureModeAtMost) {
+    *measureModeMainDim = YGMeasureModeExactly;
+  }
+
+  // The size every child is laid out with in STEP 5. Min and max sizes are
+  // in points, so it does not depend on the line.
+  const float minMain = YGResolveValue(
+      &first->style.minDimensions[dim[mainAxis]], mainAxisParentSize);
+  const float maxMain = YGResolveValue(
+      &first->style.maxDimensions[dim[mainAxis]], mainAxisParentSize);
+  const float flexBasisWithMinAndMaxConstraints =
+      fmaxf(minMain, fminf(maxMain, flexBasis));
+  const float childFlexBasis = fminf(maxMain, fmaxf(minMain, flexBasis));
+  float childMainSize = childFlexBasis + marginMain;
+  float childCrossSize =
+      YGResolveValue(first->resolvedDimensions[dim[crossAxis]],
+                     availableInnerCrossDim) +
+      marginCross;
+  YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
+  YGMeasureMode childCrossMeasureMode = YGMeasureModeExactly;
+  YGConstrainMaxSizeForMode(first, mainAxis, *availableInnerMainDim,
+                            availableInnerWidth, &childMainMeasureMode,
+                            &childMainSize);
+  YGConstrainMaxSizeForMode(first, crossAxis, availableInnerCrossDim,
+                            availableInnerWidth, &childCrossMeasureMode,
+                            &childCrossSize);
+
+  // If we don't need to measure the cross axis, we can skip the entire flex
+  // step.
+  const bool canSkipFlex =
+      !performLayout && measureModeCrossDim == YGMeasureModeExactly;
+  float childDimWithMarginMain = 0;
+  float childDimWithMarginCross = 0;
+  const YGCachedMeasurement childLayout = {
+      .availableWidth = isMainAxisRow ? childMainSize : childCrossSize,
+      .availableHeight = isMainAxisRow ? childCrossSize : childMainSize,
+      .widthMeasureMode =
+          isMainAxisRow ? childMainMeasureMode : childCrossMeasureMode,
+      .heightMeasureMode =
+          isMainAxisRow ? childCrossMeasureMode : childMainMeasureMode,
+  };
+  if (!canSkipFlex) {
+    YGLayoutNodeInternal(first, childLayout.availableWidth,
+                         childLayout.availableHeight, direction,
+                         childLayout.widthMeasureMode,
+                         childLayout.heightMeasureMode, availableInnerWidth,
+                         availableInnerHeight, performLayout, "flex", config,
+                         layoutContext);
+    childDimWithMarginMain =
+        YGNodeDimWithMargin(first, mainAxis, availableInnerWidth);
+    childDimWithMarginCross =
+        YGNodeDimWithMargin(first, crossAxis, availableInnerWidth);
+    for (uint32_t i = 0; i < childCount; i++) {
+      node->layout.hadOverflow |= children[i]->layout.hadOverflow;
+    }
+  }
+  if (performLayout) {
+    for (uint32_t i = 1; i < childCount; i++) {
+      YGNodeCopyUniformLayout(children[i], first, &childLayout, direction,
+                              layoutContext->generationCount);
+    }
+  }
 
-  node->layout.margin[YGEdgeStart] =
-      YGNodeLeadingMargin(node, flexRowDirection, parentWidth);
-  node->layout.margin[YGEdgeEnd] =
-      YGNodeTrailingMargin(node, flexRowDirection, parentWidth);
-  node->layout.margin[YGEdgeTop] =
-      YGNodeLeadingMargin(node, flexColumnDirection, parentWidth);
-  node->layout.margin[YGEdgeBottom] =
-      YGNodeTrailingMargin(node, flexColumnDirection, parentWidth);
+  // STEP 4: COLLECT FLEX ITEMS INTO FLEX LINES
+  uint32_t startOfLineIndex = 0;
+  uint32_t endOfLineIndex = 0;
+  uint32_t lineCount = 0;
+  for (; endOfLineIndex < childCount;
+       lineCount++, startOfLineIndex = endOfLineIndex) {
+    uint32_t itemsOnLine = 0;
+    float sizeConsumedOnCurrentLine = 0;
+    for (uint32_t i = startOfLineIndex; i < childCount;
+         i++, endOfLineIndex++) {
+      if (sizeConsumedOnCurrentLine + flexBasisWithMinAndMaxConstraints +
+                  marginMain >
+              *availableInnerMainDim &&
+          isNodeFlexWrap && itemsOnLine > 0) {
+        break;
+      }
+      sizeConsumedOnCurrentLine +=
+          flexBasisWithMinAndMaxConstraints + marginMain;
+      itemsOnLine++;
+    }
 
-  node->layout.border[YGEdgeStart] =
-      YGNodeLeadingBorder(node, flexRowDirection);
-  node->layout.border[YGEdgeEnd] = YGNodeTrailingBorder(node, flexRowDirection);
-  node->layout.border[YGEdgeTop] =
-      YGNodeLeadingBorder(node, flexColumnDirection);
-  node->layout.border[YGEdgeBottom] =
-      YGNodeTrailingBorder(node, flexColumnDirection);
+    // STEP 5: RESOLVING FLEXIBLE LENGTHS ON MAIN AXIS
+    // Nothing flexes, so this only determines the free space of the line.
+    if (*measureModeMainDim != YGMeasureModeExactly) {
+      if (!YGFloatIsUndefined(minInnerMainDim) &&
+          sizeConsumedOnCurrentLine < minInnerMainDim) {
+        *availableInnerMainDim = minInnerMainDim;
+      } else if (!YGFloatIsUndefined(maxInnerMainDim) &&
+                 sizeConsumedOnCurrentLine > maxInnerMainDim) {
+        *availableInnerMainDim = maxInnerMainDim;
+      } else if (!node->config->useLegacyStretchBehaviour) {
+        *availableInnerMainDim = sizeConsumedOnCurrentLine;
+      }
+    }
 
-  node->layout.padding[YGEdgeStart] =
-      YGNodeLeadingPadding(node, flexRowDirection, parentWidth);
-  node->layout.padding[YGEdgeEnd] =
-      YGNodeTrailingPadding(node, flexRowDirection, parentWidth);
-  node->layout.padding[YGEdgeTop] =
-      YGNodeLeadingPadding(node, flexColumnDirection, parentWidth);
-  node->layout.padding[YGEdgeBottom] =
-      YGNodeTrailingPadding(node, flexColumnDirection, parentWidth);
+    float remainingFreeSpace = 0;
+    if (!YGFloatIsUndefined(*availableInnerMainDim)) {
+      remainingFreeSpace = *availableInnerMainDim - sizeConsumedOnCurrentLine;
+    } else if (sizeConsumedOnCurrentLine < 0) {
+      remainingFreeSpace = -sizeConsumedOnCurrentLine;
+    }
+    node->layout.hadOverflow |= (remainingFreeSpace < 0);
 
-  if (node->measure) {
-    YGNodeWithMeasureFuncSetMeasuredDimensions(
-        node, availableWidth, availableHeight, widthMeasureMode,
-        heightMeasureMode, parentWidth, parentHeight);
-    return;
+    // STEP 6: MAIN-AXIS JUSTIFICATION & CROSS-AXIS SIZE DETERMINATION
+    if (*measureModeMainDim == YGMeasureModeAtMost && remainingFreeSpace > 0) {
+      if (node->style.minDimensions[dim[mainAxis]].unit != YGUnitUndefined &&
+          YGResolveValue(&node->style.minDimensions[dim[mainAxis]],
+                         mainAxisParentSize) >= 0) {
+        remainingFreeSpace =
+            fmaxf(0, YGResolveValue(&node->style.minDimensions[dim[mainAxis]],
+                                    mainAxisParentSize) -
+                         (*availableInnerMainDim - remainingFreeSpace));
+      } else {
+        remainingFreeSpace = 0;
+      }
+    }
+
+    float leadingMainDim = 0;
+    float betweenMainDim = 0;
+    YGJustifyLine(node->style.justifyContent, remainingFreeSpace, itemsOnLine,
+                  &leadingMainDim, &betweenMainDim);
+    const float mainStep = canSkipFlex
+                               ? betweenMainDim + marginMain + flexBasis
+                               : betweenMainDim + childDimWithMarginMain;
+    float crossDim = canSkipFlex ? availableInnerCrossDim
+                                 : fmaxf(0, childDimWithMarginCross);
+
+    float containerCrossAxis = availableInnerCrossDim;
+    if (measureModeCrossDim == YGMeasureModeUndefined ||
+        measureModeCrossDim == YGMeasureModeAtMost) {
+      containerCrossAxis =
+          YGNodeBoundAxis(node, crossAxis, crossDim + paddingAndBorderAxisCross,
+                          crossAxisParentSize, parentWidth) -
+          paddingAndBorderAxisCross;
+    }
+    if (!isNodeFlexWrap && measureModeCrossDim == YGMeasureModeExactly) {
+      crossDim = availableInnerCrossDim;
+    }
+    crossDim =
+        YGNodeBoundAxis(node, crossAxis, crossDim + paddingAndBorderAxisCross,
+                        crossAxisParentSize, parentWidth) -
+        paddingAndBorderAxisCross;
+
+    // STEP 7: CROSS-AXIS ALIGNMENT
+    float leadingCrossDim = leadingPaddingAndBorderCross;
+    if (align != YGAlignStretch) {
+      const float remainingCrossDim =
+          containerCrossAxis - childDimWithMarginCross;
+      if (align == YGAlignCenter) {
+        leadingCrossDim += remainingCrossDim / 2;
+      } else if (align == YGAlignFlexEnd) {
+        leadingCrossDim += remainingCrossDim;
+      }
+    }
+    const float crossPosition =
+        position[crossEdge] + (*totalLineCrossDim + leadingCrossDim);
+
+    float mainDim = leadingPaddingAndBorderMain + leadingMainDim;
+    for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
+      const YGNodeRef child = children[i];
+      child->lineIndex = lineCount;
+      if (performLayout) {
+        memcpy(child->layout.position, position, sizeof(position));
+        child->layout.position[mainEdge] += mainDim;
+        child->layout.position[crossEdge] = crossPosition;
+      }
+      mainDim += mainStep;
+    }
+    mainDim += trailingPaddingAndBorderMain;
+
+    *totalLineCrossDim += crossDim;
+    *maxLineMainDim = fmaxf(*maxLineMainDim, mainDim);
   }
 
-  const uint32_t childCount = YGNodeListCount(node->children);
-  if (childCount == 0) {
-    YGNodeEmptyContainerSetMeasuredDimensions(
-        node, availableWidth, availableHeight, widthMeasureMode,
-        heightMeasureMode, parentWidth, parentHeight);
-    return;
+  // STEP 8: MULTI-LINE CONTENT ALIGNMENT
+  if (performLayout && lineCount > 1 &&
+      !YGFloatIsUndefined(availableInnerCrossDim)) {
+    float crossDimLead = 0;
+    float currentLead = leadingPaddingAndBorderCross;
+    YGAlignLines(node->style.alignContent, availableInnerCrossDim,
+                 *totalLineCrossDim, lineCount, &currentLead, &crossDimLead);
+
+    // Every line is as high as its items.
+    const float childCrossDim =
+        first->layout.measuredDimensions[dim[crossAxis]];
+    float lineHeight = 0;
+    if (YGNodeIsLayoutDimDefined(first, crossAxis)) {
+      lineHeight = fmaxf(lineHeight, childCrossDim + marginCross);
+    }
+    lineHeight += crossDimLead;
+
+    const float leadingMarginCross =
+        YGNodeLeadingMargin(first, crossAxis, availableInnerWidth);
+    const float trailingMarginCross =
+        YGNodeTrailingMargin(first, crossAxis, availableInnerWidth);
+
+    uint32_t startIndex = 0;
+    for (uint32_t line = 0; line < lineCount; line++) {
+      float crossPosition;
+      switch (align) {
+        case YGAlignFlexEnd:
+          crossPosition = currentLead + lineHeight - trailingMarginCross -
+                          childCrossDim;
+          break;
+        case YGAlignCenter:
+          crossPosition = currentLead + (lineHeight - childCrossDim) / 2;
+          break;
+        default:
+          crossPosition = currentLead + leadingMarginCross;
+          break;
+      }
+      uint32_t i = startIndex;
+      for (; i < childCount && children[i]->lineIndex == line; i++) {
+        children[i]->layout.position[crossEdge] = crossPosition;
+      }
+      startIndex = i;
+      currentLead += lineHeight;
+    }
   }
+}
 
-  // If we're not being asked to perform a full layout we can skip the algorithm
-  // if we already know the size
-  if (!performLayout &&
-      YGNodeFixedSizeSetMeasuredDimensions(
-          node, availableWidth, availableHeight, widthMeasureMode,
-          heightMeasureMode, parentWidth, parentHeight)) {
-    return;
+// Values of the children of a container that STEPs 4 to 7 read more than once,
+// gathered in child order once every flex basis is known. The steps then walk
+// these arrays instead of the children and their styles.
+typedef struct YGFlexItems {
+  float *flexBasis;
+  float *minMainDim;
+  float *maxMainDim;
+  float *marginMain;
+  float *marginCross;
+  float *flexGrow;
+  float *flexShrink;
+  // Main sizes resolved by YGFlexItemsResolveLine.
+  float *mainSize;
+  uint8_t *flags;
+} YGFlexItems;
+
+// Bits of YGFlexItems.flags.
+enum {
+  // Displayed and not absolutely positioned.
+  YGFlexItemInFlow = 1,
+  YGFlexItemFlexible = 2,
+  YGFlexItemAutoMarginMainLeading = 4,
+  YGFlexItemAutoMarginMainTrailing = 8,
+  // Laid out in STEP 5 at the cross size STEP 7 stretches it to.
+  YGFlexItemLaidOutStretched = 16,
+};
+
+// The arrays share a single allocation.
+static YGFlexItems YGFlexItemsAllocate(YGScratchStack *const scratch,
+                                       const uint32_t count) {
+  float *const values =
+      YGScratchStackAllocate(scratch, (sizeof(float) * 8 + 1) * count);
+  return (YGFlexItems){
+      .flexBasis = values,
+      .minMainDim = values + count,
+      .maxMainDim = values + count * 2,
+      .marginMain = values + count * 3,
+      .marginCross = values + count * 4,
+      .flexGrow = values + count * 5,
+      .flexShrink = values + count * 6,
+      .mainSize = values + count * 7,
+      .flags = (uint8_t *)(values + count * 8),
+  };
+}
+
+// Breakpoints of the flexible items of a line: the ratio of free space per
+// unit of flex factor at which an item reaches its min or its max size.
+typedef struct YGFlexBreakpoint {
+  float ratio;
+  uint32_t item;
+} YGFlexBreakpoint;
+
+static int YGFlexBreakpointCompareDescending(const void *a, const void *b) {
+  const float x = ((const YGFlexBreakpoint *)a)->ratio;
+  const float y = ((const YGFlexBreakpoint *)b)->ratio;
+  return x > y ? -1 : (x < y ? 1 : 0);
+}
+
+static int YGFlexBreakpointCompareAscending(const void *a, const void *b) {
+  return YGFlexBreakpointCompareDescending(b, a);
+}
+
+// Sums over the unfrozen items of a prefix of breakpoints, kept in a Fenwick
+// tree so that freezing an item and summing a prefix both take a logarithmic
+// time.
+typedef struct YGFlexViolationSums {
+  // Sum of the bound each item is clamped to minus its flex basis.
+  double bound;
+  double factor;
+  int32_t count;
+} YGFlexViolationSums;
+
+static void YGFlexViolationSumsAdd(YGFlexViolationSums *const tree,
+                                   const uint32_t size,
+                                   const uint32_t position,
+                                   const double bound, const double factor,
+                                   const int32_t count) {
+  for (uint32_t i = position + 1; i <= size; i += i & (0u - i)) {
+    tree[i - 1].bound += bound;
+    tree[i - 1].factor += factor;
+    tree[i - 1].count += count;
+  }
+}
+
+static YGFlexViolationSums YGFlexViolationSumsPrefix(
+    const YGFlexViolationSums *const tree, const uint32_t end) {
+  YGFlexViolationSums sums = {0, 0, 0};
+  for (uint32_t i = end; i > 0; i -= i & (0u - i)) {
+    sums.bound += tree[i - 1].bound;
+    sums.factor += tree[i - 1].factor;
+    sums.count += tree[i - 1].count;
+  }
+  return sums;
+}
+
+// Number of breakpoints, sorted in descending order, above |ratio|.
+static uint32_t YGFlexBreakpointsAbove(const YGFlexBreakpoint *const points,
+                                       const uint32_t count,
+                                       const float ratio) {
+  uint32_t low = 0;
+  uint32_t high = count;
+  while (low < high) {
+    const uint32_t middle = low + (high - low) / 2;
+    if (points[middle].ratio > ratio) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
   }
+  return low;
+}
+
+// Number of breakpoints, sorted in ascending order, below |ratio|.
+static uint32_t YGFlexBreakpointsBelow(const YGFlexBreakpoint *const points,
+                                       const uint32_t count,
+                                       const float ratio) {
+  uint32_t low = 0;
+  uint32_t high = count;
+  while (low < high) {
+    const uint32_t middle = low + (high - low) / 2;
+    if (points[middle].ratio < ratio) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// The flexible items of a line, that is the items not frozen by step 2 of
+// section 9.7 of the flexbox spec.
+typedef struct YGFlexibleItems {
+  uint32_t count;
+  const float *flexBasis;
+  // Flex grow factors, or flex shrink factors scaled by the flex basis.
+  const float *factor;
+  // Flex grow or flex shrink factors, as set in the style.
+  const float *styleFactor;
+  const float *minSize;
+  const float *maxSize;
+  float *size;
+} YGFlexibleItems;
+
+// Sums over the unfrozen items of a line, kept up to date as items freeze.
+typedef struct YGFlexibleItemsState {
+  double frozenSize;
+  double flexBasis;
+  double factor;
+  double styleFactor;
+  uint32_t count;
+} YGFlexibleItemsState;
+
+// Free space per unit of flex factor of a round of the loop of section 9.7,
+// steps 4b and 4c: every unfrozen item is given its flex basis plus its factor
+// times this ratio.
+static float YGFlexibleItemsRatio(const YGFlexibleItemsState *const state,
+                                  const bool grow, const double space,
+                                  const double initialFreeSpace) {
+  double remainingFreeSpace = space - state->frozenSize - state->flexBasis;
+  if (state->styleFactor < 1 &&
+      fabs(initialFreeSpace * state->styleFactor) < fabs(remainingFreeSpace)) {
+    remainingFreeSpace = initialFreeSpace * state->styleFactor;
+  }
+  if (remainingFreeSpace == 0 || state->factor <= 0) {
+    return 0;
+  }
+  // Shrinking takes the absolute value of the free space away.
+  return (float)((grow ? remainingFreeSpace : -fabs(remainingFreeSpace)) /
+                 state->factor);
+}
+
+static inline float YGUnclampedFlexibleItemSize(
+    const YGFlexibleItems *const items, const uint32_t i, const float ratio) {
+  return items->factor[i] != 0 ? items->flexBasis[i] + ratio * items->factor[i]
+                               : items->flexBasis[i];
+}
+
+static inline float YGFlexibleItemSize(const YGFlexibleItems *const items,
+                                       const uint32_t i, const float ratio) {
+  return fminf(fmaxf(YGUnclampedFlexibleItemSize(items, i, ratio),
+                     items->minSize[i]),
+               items->maxSize[i]);
+}
+
+static void YGFreezeFlexibleItem(const YGFlexibleItems *const items,
+                                 const uint32_t i, const float size,
+                                 YGFlexibleItemsState *const state,
+                                 bool *const frozen) {
+  items->size[i] = size;
+  frozen[i] = true;
+  state->frozenSize += size;
+  state->flexBasis -= items->flexBasis[i];
+  state->factor -= items->factor[i];
+  state->styleFactor -= items->styleFactor[i];
+  state->count--;
+}
+
+// Lines whose items are not all frozen after this many rounds of the loop of
+// section 9.7 switch to YGResolveFlexibleItemsSorted.
+#define YG_FLEX_LINEAR_ROUNDS 4
+
+// Runs the rounds left of the loop of section 9.7 on the unfrozen items.
+//
+// Every round distributes the free space left by the frozen items and freezes
+// the items that violate their min size, or their max size, depending on the
+// sign of the total violation. Run as written, every round walks every
+// unfrozen item, which takes a quadratic time on long lines where items keep
+// freezing a few at a time. An item violates its min size when the ratio of
+// the round is below the ratio at which it reaches its min size, and its max
+// size when the ratio is above the one at which it reaches its max size. With
+// the items sorted by both, a round finds its violations with a binary search
+// and sums them with Fenwick trees, and each item is frozen once: O(n log n)
+// overall.
+static void YGResolveFlexibleItemsSorted(const YGFlexibleItems *const items,
+                                         const bool grow, const double space,
+                                         const double initialFreeSpace,
+                                         YGFlexibleItemsState *const state,
+                                         bool *const frozen,
+                                         YGScratchStack *const scratch) {
+  const YGScratchMark scratchMark = YGScratchStackMark(scratch);
+  const uint32_t count = state->count;
+  YGFlexBreakpoint *const minPoints =
+      YGScratchStackAllocate(scratch, sizeof(YGFlexBreakpoint) * count);
+  YGFlexBreakpoint *const maxPoints =
+      YGScratchStackAllocate(scratch, sizeof(YGFlexBreakpoint) * count);
+  uint32_t point = 0;
+  for (uint32_t i = 0; i < items->count; i++) {
+    if (frozen[i]) {
+      continue;
+    }
+    const float flexBasis = items->flexBasis[i];
+    const float factor = items->factor[i];
+    // Items without a factor keep their flex basis, so they violate a bound
+    // at every ratio or never.
+    minPoints[point] = (YGFlexBreakpoint){
+        .ratio = factor != 0 ? (items->minSize[i] - flexBasis) / factor
+                             : (flexBasis < items->minSize[i] ? INFINITY
+                                                              : -INFINITY),
+        .item = i,
+    };
+    maxPoints[point] = (YGFlexBreakpoint){
+        .ratio = factor != 0 ? (items->maxSize[i] - flexBasis) / factor
+                             : (flexBasis > items->maxSize[i] ? -INFINITY
+                                                              : INFINITY),
+        .item = i,
+    };
+    point++;
+  }
+  // Min violations are the items whose min breakpoint is above the ratio of
+  // the round and max violations those whose max breakpoint is below it.
+  qsort(minPoints, count, sizeof(YGFlexBreakpoint),
+        YGFlexBreakpointCompareDescending);
+  qsort(maxPoints, count, sizeof(YGFlexBreakpoint),
+        YGFlexBreakpointCompareAscending);
+
+  uint32_t *const minPositions =
+      YGScratchStackAllocate(scratch, sizeof(uint32_t) * items->count);
+  uint32_t *const maxPositions =
+      YGScratchStackAllocate(scratch, sizeof(uint32_t) * items->count);
+  YGFlexViolationSums *const minSums =
+      YGScratchStackAllocate(scratch, sizeof(YGFlexViolationSums) * count);
+  YGFlexViolationSums *const maxSums =
+      YGScratchStackAllocate(scratch, sizeof(YGFlexViolationSums) * count);
+  memset(minSums, 0, sizeof(YGFlexViolationSums) * count);
+  memset(maxSums, 0, sizeof(YGFlexViolationSums) * count);
+  for (uint32_t position = 0; position < count; position++) {
+    const uint32_t minItem = minPoints[position].item;
+    const uint32_t maxItem = maxPoints[position].item;
+    minPositions[minItem] = position;
+    maxPositions[maxItem] = position;
+    YGFlexViolationSumsAdd(
+        minSums, count, position,
+        items->minSize[minItem] - items->flexBasis[minItem],
+        items->factor[minItem], 1);
+    YGFlexViolationSumsAdd(
+        maxSums, count, position,
+        items->maxSize[maxItem] - items->flexBasis[maxItem],
+        items->factor[maxItem], 1);
+  }
+
+  // Items before these positions are all frozen.
+  uint32_t minFront = 0;
+  uint32_t maxFront = 0;
+  while (state->count > 0) {
+    const float ratio =
+        YGFlexibleItemsRatio(state, grow, space, initialFreeSpace);
+    const uint32_t minEnd = YGFlexBreakpointsAbove(minPoints, count, ratio);
+    const uint32_t maxEnd = YGFlexBreakpointsBelow(maxPoints, count, ratio);
+    const YGFlexViolationSums minViolations =
+        YGFlexViolationSumsPrefix(minSums, minEnd);
+    const YGFlexViolationSums maxViolations =
+        YGFlexViolationSumsPrefix(maxSums, maxEnd);
+    // The total violation, clamped minus unclamped sizes.
+    const double totalViolation =
+        minViolations.bound - ratio * minViolations.factor +
+        maxViolations.bound - ratio * maxViolations.factor;
+
+    if ((minViolations.count == 0 && maxViolations.count == 0) ||
+        totalViolation == 0) {
+      // Step 4d freezes every item when no item is clamped or when the
+      // violations cancel out.
+      for (uint32_t i = 0; i < items->count; i++) {
+        if (!frozen[i]) {
+          items->size[i] = YGFlexibleItemSize(items, i, ratio);
+        }
+      }
+      break;
+    }
+
+    const bool freezeMin = totalViolation > 0;
+    const YGFlexBreakpoint *const points = freezeMin ? minPoints : maxPoints;
+    uint32_t *const front = freezeMin ? &minFront : &maxFront;
+    const uint32_t end = freezeMin ? minEnd : maxEnd;
+    for (; *front < end; (*front)++) {
+      const uint32_t i = points[*front].item;
+      if (frozen[i]) {
+        continue;
+      }
+      YGFreezeFlexibleItem(
+          items, i, freezeMin ? items->minSize[i] : items->maxSize[i], state,
+          frozen);
+      YGFlexViolationSumsAdd(minSums, count, minPositions[i],
+                             -(items->minSize[i] - items->flexBasis[i]),
+                             -items->factor[i], -1);
+      YGFlexViolationSumsAdd(maxSums, count, maxPositions[i],
+                             -(items->maxSize[i] - items->flexBasis[i]),
+                             -items->factor[i], -1);
+    }
+  }
+  YGScratchStackRelease(scratch, scratchMark);
+}
+
+// Runs the loop of section 9.7 of the flexbox spec, steps 4a to 4f, on the
+// flexible items of a line. |space| is the room the items share and
+// |initialFreeSpace| the free space of step 3.
+//
+// Most lines are resolved in a round or two, each a linear walk of the items,
+// as the spec describes. Lines that take more rounds finish in
+// YGResolveFlexibleItemsSorted, which bounds the loop to O(n log n).
+static void YGResolveFlexibleItems(const YGFlexibleItems *const items,
+                                   const bool grow, const double space,
+                                   const double initialFreeSpace,
+                                   YGScratchStack *const scratch) {
+  const uint32_t count = items->count;
+  YGFlexibleItemsState state = {0, 0, 0, 0, count};
+  for (uint32_t i = 0; i < count; i++) {
+    state.flexBasis += items->flexBasis[i];
+    state.factor += items->factor[i];
+    state.styleFactor += items->styleFactor[i];
+  }
+
+  const YGScratchMark scratchMark = YGScratchStackMark(scratch);
+  bool *const frozen = YGScratchStackAllocate(scratch, sizeof(bool) * count);
+  memset(frozen, 0, sizeof(bool) * count);
+  for (uint32_t round = 0; state.count > 0; round++) {
+    if (round == YG_FLEX_LINEAR_ROUNDS) {
+      YGResolveFlexibleItemsSorted(items, grow, space, initialFreeSpace,
+                                   &state, frozen, scratch);
+      break;
+    }
+    const float ratio =
+        YGFlexibleItemsRatio(&state, grow, space, initialFreeSpace);
+    double totalViolation = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      if (!frozen[i]) {
+        items->size[i] = YGFlexibleItemSize(items, i, ratio);
+        totalViolation +=
+            items->size[i] - YGUnclampedFlexibleItemSize(items, i, ratio);
+      }
+    }
+    // Step 4d freezes every item when no item is clamped or when the
+    // violations cancel out.
+    if (totalViolation == 0) {
+      break;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+      if (frozen[i]) {
+        continue;
+      }
+      const float unclampedSize = YGUnclampedFlexibleItemSize(items, i, ratio);
+      if (totalViolation > 0 ? items->size[i] > unclampedSize
+                             : items->size[i] < unclampedSize) {
+        YGFreezeFlexibleItem(items, i, items->size[i], &state, frozen);
+      }
+    }
+  }
+  YGScratchStackRelease(scratch, scratchMark);
+}
+
+// Resolves the main sizes of the items of a line, from |start| to |end|, the
+// way section 9.7 of the flexbox spec does, into |items->mainSize|. |lineSpace|
+// is the main size the line fills.
+static void YGFlexItemsResolveLine(
+    const YGFlexItems *const items, const YGNodeRef *const children,
+    const uint32_t start, const uint32_t end, const YGFlexDirection mainAxis,
+    const bool grow, const float lineSpace, const float availableInnerMainDim,
+    const float availableInnerWidth, YGScratchStack *const scratch) {
+  const YGScratchMark scratchMark = YGScratchStackMark(scratch);
+  const uint32_t lineCount = end - start;
+  float *const values =
+      YGScratchStackAllocate(scratch, sizeof(float) * 6 * lineCount);
+  float *const flexBasis = values;
+  float *const factor = values + lineCount;
+  float *const styleFactor = values + lineCount * 2;
+  float *const minSize = values + lineCount * 3;
+  float *const maxSize = values + lineCount * 4;
+  uint32_t *const indices =
+      YGScratchStackAllocate(scratch, sizeof(uint32_t) * lineCount);
+
+  // Step 2: items that cannot flex, or that their min or max size already
+  // pushes the wrong way, are frozen at their hypothetical main size.
+  // Long lines sum thousands of sizes.
+  double space = lineSpace;
+  double flexibleFlexBasis = 0;
+  uint32_t count = 0;
+  for (uint32_t i = start; i < end; i++) {
+    if (!(items->flags[i] & YGFlexItemInFlow)) {
+      continue;
+    }
+    const YGNodeRef child = children[i];
+    const float childFlexBasis = items->flexBasis[i];
+    const float childMinSize =
+        YGNodeBoundAxis(child, mainAxis, -INFINITY, availableInnerMainDim,
+                        availableInnerWidth);
+    const float childMaxSize =
+        YGNodeBoundAxis(child, mainAxis, INFINITY, availableInnerMainDim,
+                        availableInnerWidth);
+    const float hypotheticalMainSize =
+        fminf(fmaxf(childFlexBasis, childMinSize), childMaxSize);
+    const float childFactor = grow ? items->flexGrow[i] : items->flexShrink[i];
+    space -= items->marginMain[i];
+    if (!(items->flags[i] & YGFlexItemFlexible) || childFactor == 0 ||
+        (grow && childFlexBasis > hypotheticalMainSize) ||
+        (!grow && childFlexBasis < hypotheticalMainSize)) {
+      items->mainSize[i] = hypotheticalMainSize;
+      space -= hypotheticalMainSize;
+      continue;
+    }
+    indices[count] = i;
+    flexBasis[count] = childFlexBasis;
+    factor[count] = grow ? childFactor : childFactor * childFlexBasis;
+    styleFactor[count] = childFactor;
+    minSize[count] = childMinSize;
+    maxSize[count] = childMaxSize;
+    flexibleFlexBasis += childFlexBasis;
+    count++;
+  }
+
+  if (count > 0) {
+    const YGFlexibleItems flexibleItems = {
+        .count = count,
+        .flexBasis = flexBasis,
+        .factor = factor,
+        .styleFactor = styleFactor,
+        .minSize = minSize,
+        .maxSize = maxSize,
+        .size = values + lineCount * 5,
+    };
+    YGResolveFlexibleItems(&flexibleItems, grow, space,
+                           space - flexibleFlexBasis, scratch);
+    for (uint32_t item = 0; item < count; item++) {
+      items->mainSize[indices[item]] = flexibleItems.size[item];
+    }
+  }
+  YGScratchStackRelease(scratch, scratchMark);
+}
+
+//
+// This is the main routine that implements a subset of the flexbox layout
+// algorithm
+// described in the W3C YG documentation: https://www.w3.org/TR/YG3-flexbox/.
+//
+// Limitations of this algorithm, compared to the full standard:
+//  * Display property is always assumed to be 'flex' except for Text nodes,
+//  which
+//    are assumed to be 'inline-flex'.
+//  * The 'zIndex' property (or any form of z ordering) is not supported. Nodes
+//  are
+//    stacked in document order.
+//  * The 'order' property is not supported. The order of flex items is always
+//  defined
+//    by document order.
+//  * The 'visibility' property is always assumed to be 'visible'. Values of
+//  'collapse'
+//    and 'hidden' are not supported.
+//  * There is no support for forced breaks.
+//  * It does not support vertical inline directions (top-to-bottom or
+//  bottom-to-top text).
+//
+// Deviations from standard:
+//  * Section 4.5 of the spec indicates that all flex items have a default
+//  minimum
+//    main size. For text blocks, for example, this is the width of the widest
+//    word.
+//    Calculating the minimum width is expensive, so we forego it and assume a
+//    default
+//    minimum main size of 0.
+//  * Min/Max sizes in the main axis are not honored when resolving flexible
+//  lengths.
+//  * The spec indicates that the default value for 'flexDirection' is 'row',
+//  but
+//    the algorithm below assumes a default of 'column'.
+//
+// Input parameters:
+//    - node: current node to be sized and layed out
+//    - availableWidth & availableHeight: available size to be used for sizing
+//    the node
+//      or YGUndefined if the size is not available; interpretation depends on
+//      layout
+//      flags
+//    - parentDirection: the inline (text) direction within the parent
+//    (left-to-right or
+//      right-to-left)
+//    - widthMeasureMode: indicates the sizing rules for the width (see below
+//    for explanation)
+//    - heightMeasureMode: indicates the sizing rules for the height (see below
+//    for explanation)
+//    - performLayout: specifies whether the caller is interested in just the
+//    dimensions
+//      of the node or it requires the entire node and its subtree to be layed
+//      out
+//      (with final positions)
+//
+// Details:
+//    This routine is called recursively to lay out subtrees of flexbox
+//    elements. It uses the
+//    information in node.style, which is treated as a read-only input. It is
+//    responsible for
+//    setting the layout.direction and layout.measuredDimensions fields for the
+//    input node as well
+//    as the layout.position and layout.lineIndex fields for its child nodes.
+//    The
+//    layout.measuredDimensions field includes any border or padding for the
+//    node but does
+//    not include margins.
+//
+//    The spec describes four different layout modes: "fill available", "max
+//    content", "min
+//    content",
+//    and "fit content". Of these, we don't use "min content" because we don't
+//    support default
+//    minimum main sizes (see above for details). Each of our measure modes maps
+//    to a layout mode
+//    from the spec (https://www.w3.org/TR/YG3-sizing/#terms):
+//      - YGMeasureModeUndefined: max content
+//      - YGMeasureModeExactly: fill available
+//      - YGMeasureModeAtMost: fit content
+//
+//    When calling YGNodelayoutImpl and YGLayoutNodeInternal, if the caller
+//    passes an available size of undefined then it must also pass a measure
+//    mode of YGMeasureModeUndefined in that dimension.
+//
+// Runs the flexbox algorithm on a container with children. The main and cross
+// axes are arguments so that the specialisations below, which pass them as
+// constants, let the compiler fold every lookup of the axis tables.
+static YG_ALWAYS_INLINE void YGNodeLayoutFlexContainer(
+    const YGNodeRef node, const float availableWidth,
+    const float availableHeight, const YGDirection direction,
+    const YGMeasureMode widthMeasureMode, const YGMeasureMode heightMeasureMode,
+    const float parentWidth, const float parentHeight, const bool performLayout,
+    const YGConfigRef config, YGLayoutContext *const layoutContext,
+    const YGFlexDirection mainAxis, const YGFlexDirection crossAxis) {
+  const uint32_t childCount = YGNodeListCount(&node->children);
 
   // At this point we know we're going to perform work. Ensure that each child
   // has a mutable copy.
   YGCloneChildrenIfNeeded(node);
+  YGNodeRef *const children = YGNodeListItems(&node->children);
 
   // Reset layout flags, as they could have changed.
   node->layout.hadOverflow = false;
 
   // STEP 1: CALCULATE VALUES FOR REMAINDER OF ALGORITHM
-  const YGFlexDirection mainAxis =
-      YGResolveFlexDirection(node->style.flexDirection, direction);
-  const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
   const bool isMainAxisRow = YGFlexDirectionIsRow(mainAxis);
   const YGJustify justifyContent = node->style.justifyContent;
   const bool isNodeFlexWrap = node->style.flexWrap != YGWrapNoWrap;
@@ -2353,6 +5086,25 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
   const float availableInnerCrossDim =
       isMainAxisRow ? availableInnerHeight : availableInnerWidth;
 
+  // Identical leaves are placed by the uniform grid kernel instead of STEPs 3
+  // to 8, and never need the general steps below.
+  if (YGNodeHasUniformChildren(node, mainAxis, crossAxis)) {
+    float maxLineMainDim = 0;
+    float totalLineCrossDim = 0;
+    YGNodeLayoutUniformChildren(
+        node, mainAxis, crossAxis, direction, availableInnerWidth,
+        availableInnerHeight, widthMeasureMode, heightMeasureMode,
+        &availableInnerMainDim, &measureModeMainDim, minInnerMainDim,
+        maxInnerMainDim, parentWidth, parentHeight, performLayout, config,
+        layoutContext, &maxLineMainDim, &totalLineCrossDim);
+    YGNodeSetMeasuredDimensionsFromLines(
+        node, availableWidth, availableHeight, mainAxis, crossAxis,
+        measureModeMainDim, measureModeCrossDim, availableInnerMainDim,
+        availableInnerCrossDim, maxLineMainDim, totalLineCrossDim, parentWidth,
+        parentHeight);
+    return;
+  }
+
   // If there is only one child with flexGrow + flexShrink it means we can set
   // the computedFlexBasis to 0 instead of measuring and shrinking / flexing the
   // child to exactly match the remaining space
@@ -2373,11 +5125,31 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
     }
   }
 
-  float totalOuterFlexBasis = 0;
+  // Wide containers measure and lay out their children on the parallel layout
+  // pool. The batch collects the children that can be handed off.
+  YGChildLayoutBatch parallelBatch = {
+      .jobs = NULL,
+      .count = 0,
+      .node = node,
+      .availableInnerWidth = availableInnerWidth,
+      .availableInnerHeight = availableInnerHeight,
+      .widthMeasureMode = widthMeasureMode,
+      .heightMeasureMode = heightMeasureMode,
+      .direction = direction,
+      .config = config,
+      .layoutContext = layoutContext,
+  };
+  // Per-container buffers come from the scratch memory of the pass and are
+  // given back once the children are placed.
+  const YGScratchMark scratchMark = YGScratchStackMark(&layoutContext->scratch);
+  if (YGConfigShouldLayoutChildrenInParallel(config, childCount)) {
+    parallelBatch.jobs = YGScratchStackAllocate(
+        &layoutContext->scratch, sizeof(YGChildLayoutJob) * childCount);
+  }
 
   // STEP 3: DETERMINE FLEX BASIS FOR EACH ITEM
   for (uint32_t i = 0; i < childCount; i++) {
-    const YGNodeRef child = YGNodeListGet(node->children, i);
+    const YGNodeRef child = children[i];
     if (child->style.display == YGDisplayNone) {
       YGZeroOutLayoutRecursivly(child);
       child->hasNewLayout = true;
@@ -2408,20 +5180,72 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
       child->nextChild = NULL;
     } else {
       if (child == singleFlexChild) {
-        child->layout.computedFlexBasisGeneration = gCurrentGenerationCount;
+        child->layout.computedFlexBasisGeneration =
+            layoutContext->generationCount;
         child->layout.computedFlexBasis = 0;
+      } else if (parallelBatch.jobs != NULL) {
+        parallelBatch.jobs[parallelBatch.count++].child = child;
       } else {
         YGNodeComputeFlexBasisForChild(
             node, child, availableInnerWidth, widthMeasureMode,
             availableInnerHeight, availableInnerWidth, availableInnerHeight,
-            heightMeasureMode, direction, config);
+            heightMeasureMode, direction, config, layoutContext);
       }
     }
+  }
+
+  if (parallelBatch.jobs != NULL) {
+    YGParallelFor(parallelBatch.count, config->parallelLayoutGrainSize,
+                  YGChildLayoutBatchComputeFlexBasis, &parallelBatch);
+    for (uint32_t i = 0; i < parallelBatch.count; i++) {
+      YGLayoutStatsAdd(&layoutContext->stats, &parallelBatch.jobs[i].stats);
+    }
+    parallelBatch.count = 0;
+  }
 
-    totalOuterFlexBasis +=
-        child->layout.computedFlexBasis +
+  // Gather the flex items and sum in child order once every flex basis is
+  // known, so that the total is the same whether or not the children were
+  // measured in parallel.
+  const YGFlexItems items =
+      YGFlexItemsAllocate(&layoutContext->scratch, childCount);
+  float totalOuterFlexBasis = 0;
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = children[i];
+    // Hidden children still count their auto margins in STEP 6.
+    uint8_t flags = 0;
+    if (child->style.positionType == YGPositionTypeRelative) {
+      if (YGMarginLeadingValue(child, mainAxis)->unit == YGUnitAuto) {
+        flags |= YGFlexItemAutoMarginMainLeading;
+      }
+      if (YGMarginTrailingValue(child, mainAxis)->unit == YGUnitAuto) {
+        flags |= YGFlexItemAutoMarginMainTrailing;
+      }
+    }
+    items.flags[i] = flags;
+    if (child->style.display == YGDisplayNone) {
+      continue;
+    }
+    items.flexBasis[i] = child->layout.computedFlexBasis;
+    items.marginMain[i] =
         YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
-    ;
+    totalOuterFlexBasis += items.flexBasis[i] + items.marginMain[i];
+    if (child->style.positionType == YGPositionTypeAbsolute) {
+      continue;
+    }
+
+    flags |= YGFlexItemInFlow;
+    if (YGNodeIsFlex(child)) {
+      flags |= YGFlexItemFlexible;
+    }
+    items.flags[i] = flags;
+    items.minMainDim[i] = YGResolveValue(
+        &child->style.minDimensions[dim[mainAxis]], mainAxisParentSize);
+    items.maxMainDim[i] = YGResolveValue(
+        &child->style.maxDimensions[dim[mainAxis]], mainAxisParentSize);
+    items.marginCross[i] =
+        YGNodeMarginForAxis(child, crossAxis, availableInnerWidth);
+    items.flexGrow[i] = YGResolveFlexGrow(child);
+    items.flexShrink[i] = YGNodeResolveFlexShrink(child);
   }
 
   const bool flexBasisOverflows =
@@ -2466,29 +5290,24 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
     float totalFlexGrowFactors = 0;
     float totalFlexShrinkScaledFactors = 0;
 
-    // Maintain a linked list of the child nodes that can shrink and/or grow.
-    YGNodeRef firstRelativeChild = NULL;
-    YGNodeRef currentRelativeChild = NULL;
+    // Whether any item on the line can grow or shrink. Most lines, such as
+    // those of plain stacks, have none and keep every item at its flex basis.
+    bool isLineFlexible = false;
 
     // Add items to the current line until it's full or we run out of items.
     for (uint32_t i = startOfLineIndex; i < childCount; i++, endOfLineIndex++) {
-      const YGNodeRef child = YGNodeListGet(node->children, i);
+      const YGNodeRef child = children[i];
       if (child->style.display == YGDisplayNone) {
         continue;
       }
       child->lineIndex = lineCount;
 
-      if (child->style.positionType != YGPositionTypeAbsolute) {
-        const float childMarginMainAxis =
-            YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+      if (items.flags[i] & YGFlexItemInFlow) {
+        const float childMarginMainAxis = items.marginMain[i];
         const float flexBasisWithMaxConstraints =
-            fminf(YGResolveValue(&child->style.maxDimensions[dim[mainAxis]],
-                                 mainAxisParentSize),
-                  child->layout.computedFlexBasis);
+            fminf(items.maxMainDim[i], items.flexBasis[i]);
         const float flexBasisWithMinAndMaxConstraints =
-            fmaxf(YGResolveValue(&child->style.minDimensions[dim[mainAxis]],
-                                 mainAxisParentSize),
-                  flexBasisWithMaxConstraints);
+            fmaxf(items.minMainDim[i], flexBasisWithMaxConstraints);
 
         // If this is a multi-line flow and this item pushes us over the
         // available size, we've
@@ -2507,24 +5326,15 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
             flexBasisWithMinAndMaxConstraints + childMarginMainAxis;
         itemsOnLine++;
 
-        if (YGNodeIsFlex(child)) {
-          totalFlexGrowFactors += YGResolveFlexGrow(child);
+        if (items.flags[i] & YGFlexItemFlexible) {
+          isLineFlexible = true;
+          totalFlexGrowFactors += items.flexGrow[i];
 
           // Unlike the grow factor, the shrink factor is scaled relative to the
           // child dimension.
           totalFlexShrinkScaledFactors +=
-              -YGNodeResolveFlexShrink(child) * child->layout.computedFlexBasis;
-        }
-
-        // Store a private linked list of children that need to be layed out.
-        if (firstRelativeChild == NULL) {
-          firstRelativeChild = child;
-        }
-        if (currentRelativeChild != NULL) {
-          currentRelativeChild->nextChild = child;
+              -items.flexShrink[i] * items.flexBasis[i];
         }
-        currentRelativeChild = child;
-        child->nextChild = NULL;
       }
     }
 
@@ -2616,24 +5426,40 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
       // won't handle all cases but it was simpler to implement and it mitigates
       // performance
       // concerns because we know exactly how many passes it'll do.
+      //
+      // With YGExperimentalFeatureSpecFlexibleLengths the sizes are resolved
+      // the way the spec describes instead, before the second pass.
+      const bool isLineResolvedBySpec =
+          isLineFlexible &&
+          YGConfigIsExperimentalFeatureEnabled(
+              config, YGExperimentalFeatureSpecFlexibleLengths);
+      if (isLineResolvedBySpec) {
+        YGFlexItemsResolveLine(
+            &items, children, startOfLineIndex, endOfLineIndex, mainAxis,
+            remainingFreeSpace > 0,
+            sizeConsumedOnCurrentLine + remainingFreeSpace,
+            availableInnerMainDim, availableInnerWidth,
+            &layoutContext->scratch);
+      }
 
       // First pass: detect the flex items whose min/max constraints trigger
+      // A line without flexible items has nothing to freeze.
       float deltaFlexShrinkScaledFactors = 0;
       float deltaFlexGrowFactors = 0;
-      currentRelativeChild = firstRelativeChild;
-      while (currentRelativeChild != NULL) {
-        childFlexBasis = fminf(
-            YGResolveValue(
-                &currentRelativeChild->style.maxDimensions[dim[mainAxis]],
-                mainAxisParentSize),
-            fmaxf(YGResolveValue(
-                      &currentRelativeChild->style.minDimensions[dim[mainAxis]],
-                      mainAxisParentSize),
-                  currentRelativeChild->layout.computedFlexBasis));
+      for (uint32_t i = isLineFlexible && !isLineResolvedBySpec
+                            ? startOfLineIndex
+                            : endOfLineIndex;
+           i < endOfLineIndex; i++) {
+        if (!(items.flags[i] & YGFlexItemInFlow)) {
+          continue;
+        }
+        const YGNodeRef currentRelativeChild = children[i];
+        childFlexBasis =
+            fminf(items.maxMainDim[i],
+                  fmaxf(items.minMainDim[i], items.flexBasis[i]));
 
         if (remainingFreeSpace < 0) {
-          flexShrinkScaledFactor =
-              -YGNodeResolveFlexShrink(currentRelativeChild) * childFlexBasis;
+          flexShrinkScaledFactor = -items.flexShrink[i] * childFlexBasis;
 
           // Is this child able to shrink?
           if (flexShrinkScaledFactor != 0) {
@@ -2655,7 +5481,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
             }
           }
         } else if (remainingFreeSpace > 0) {
-          flexGrowFactor = YGResolveFlexGrow(currentRelativeChild);
+          flexGrowFactor = items.flexGrow[i];
 
           // Is this child able to grow?
           if (flexGrowFactor != 0) {
@@ -2678,31 +5504,41 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
             }
           }
         }
-
-        currentRelativeChild = currentRelativeChild->nextChild;
       }
 
       totalFlexShrinkScaledFactors += deltaFlexShrinkScaledFactors;
       totalFlexGrowFactors += deltaFlexGrowFactors;
       remainingFreeSpace += deltaFreeSpace;
 
+      // The only line of a container with an exact cross size is as large as
+      // the container, unless STEP 7 clamps it, so a child stretched across it
+      // already has its final cross size and is laid out once, below, instead
+      // of being measured now and laid out again in STEP 7.
+      const bool canLayOutStretched =
+          performLayout && !isNodeFlexWrap &&
+          measureModeCrossDim == YGMeasureModeExactly &&
+          YGNodeBoundAxis(node, crossAxis,
+                          availableInnerCrossDim + paddingAndBorderAxisCross,
+                          crossAxisParentSize, parentWidth) -
+                  paddingAndBorderAxisCross ==
+              availableInnerCrossDim;
+
       // Second pass: resolve the sizes of the flexible items
       deltaFreeSpace = 0;
-      currentRelativeChild = firstRelativeChild;
-      while (currentRelativeChild != NULL) {
-        childFlexBasis = fminf(
-            YGResolveValue(
-                &currentRelativeChild->style.maxDimensions[dim[mainAxis]],
-                mainAxisParentSize),
-            fmaxf(YGResolveValue(
-                      &currentRelativeChild->style.minDimensions[dim[mainAxis]],
-                      mainAxisParentSize),
-                  currentRelativeChild->layout.computedFlexBasis));
+      for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
+        if (!(items.flags[i] & YGFlexItemInFlow)) {
+          continue;
+        }
+        const YGNodeRef currentRelativeChild = children[i];
+        childFlexBasis =
+            fminf(items.maxMainDim[i],
+                  fmaxf(items.minMainDim[i], items.flexBasis[i]));
         float updatedMainSize = childFlexBasis;
 
-        if (remainingFreeSpace < 0) {
-          flexShrinkScaledFactor =
-              -YGNodeResolveFlexShrink(currentRelativeChild) * childFlexBasis;
+        if (isLineResolvedBySpec) {
+          updatedMainSize = items.mainSize[i];
+        } else if (isLineFlexible && remainingFreeSpace < 0) {
+          flexShrinkScaledFactor = -items.flexShrink[i] * childFlexBasis;
           // Is this child able to shrink?
           if (flexShrinkScaledFactor != 0) {
             float childSize;
@@ -2719,8 +5555,8 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
                 YGNodeBoundAxis(currentRelativeChild, mainAxis, childSize,
                                 availableInnerMainDim, availableInnerWidth);
           }
-        } else if (remainingFreeSpace > 0) {
-          flexGrowFactor = YGResolveFlexGrow(currentRelativeChild);
+        } else if (isLineFlexible && remainingFreeSpace > 0) {
+          flexGrowFactor = items.flexGrow[i];
 
           // Is this child able to grow?
           if (flexGrowFactor != 0) {
@@ -2734,15 +5570,14 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
 
         deltaFreeSpace -= updatedMainSize - childFlexBasis;
 
-        const float marginMain = YGNodeMarginForAxis(
-            currentRelativeChild, mainAxis, availableInnerWidth);
-        const float marginCross = YGNodeMarginForAxis(
-            currentRelativeChild, crossAxis, availableInnerWidth);
+        const float marginMain = items.marginMain[i];
+        const float marginCross = items.marginCross[i];
 
         float childCrossSize;
         float childMainSize = updatedMainSize + marginMain;
         YGMeasureMode childCrossMeasureMode;
         YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
+        bool isCrossSizeStretched = false;
 
         if (!YGFloatIsUndefined(currentRelativeChild->style.aspectRatio)) {
           childCrossSize = isMainAxisRow
@@ -2762,6 +5597,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
                        YGAlignStretch) {
           childCrossSize = availableInnerCrossDim;
           childCrossMeasureMode = YGMeasureModeExactly;
+          isCrossSizeStretched = true;
         } else if (!YGNodeIsStyleDimDefined(currentRelativeChild, crossAxis,
                                             availableInnerCrossDim)) {
           childCrossSize = availableInnerCrossDim;
@@ -2796,6 +5632,33 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
                                      availableInnerCrossDim) &&
             YGNodeAlignItem(node, currentRelativeChild) == YGAlignStretch;
 
+        // STEP 7 lays the child out at the main size it measures itself, with
+        // its own min and max sizes and its margins resolved physically, so
+        // the child is only laid out here if that comes back unchanged.
+        const bool isLaidOutStretched =
+            canLayOutStretched && requiresStretchLayout &&
+            isCrossSizeStretched &&
+            YGMarginLeadingValue(currentRelativeChild, crossAxis)->unit !=
+                YGUnitAuto &&
+            YGMarginTrailingValue(currentRelativeChild, crossAxis)->unit !=
+                YGUnitAuto &&
+            YGNodeBoundAxis(
+                currentRelativeChild, mainAxis,
+                childMainSize - YGNodeMarginForAxis(currentRelativeChild,
+                                                    isMainAxisRow
+                                                        ? YGFlexDirectionRow
+                                                        : YGFlexDirectionColumn,
+                                                    availableInnerWidth),
+                availableInnerMainDim, availableInnerWidth) +
+                    marginMain ==
+                childMainSize;
+        if (isLaidOutStretched) {
+          items.flags[i] |= YGFlexItemLaidOutStretched;
+        }
+
+        const bool childPerformsLayout =
+            performLayout && (!requiresStretchLayout || isLaidOutStretched);
+
         const float childWidth = isMainAxisRow ? childMainSize : childCrossSize;
         const float childHeight =
             !isMainAxisRow ? childMainSize : childCrossSize;
@@ -2807,14 +5670,36 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
 
         // Recursively call the layout algorithm for this child with the updated
         // main size.
-        YGLayoutNodeInternal(
-            currentRelativeChild, childWidth, childHeight, direction,
-            childWidthMeasureMode, childHeightMeasureMode, availableInnerWidth,
-            availableInnerHeight, performLayout && !requiresStretchLayout,
-            "flex", config);
-        node->layout.hadOverflow |= currentRelativeChild->layout.hadOverflow;
-
-        currentRelativeChild = currentRelativeChild->nextChild;
+        if (parallelBatch.jobs != NULL) {
+          parallelBatch.jobs[parallelBatch.count++] = (YGChildLayoutJob){
+              .child = currentRelativeChild,
+              .width = childWidth,
+              .height = childHeight,
+              .widthMeasureMode = childWidthMeasureMode,
+              .heightMeasureMode = childHeightMeasureMode,
+              .performLayout = childPerformsLayout,
+          };
+        } else {
+          YGLayoutNodeInternal(
+              currentRelativeChild, childWidth, childHeight, direction,
+              childWidthMeasureMode, childHeightMeasureMode,
+              availableInnerWidth, availableInnerHeight, childPerformsLayout,
+              "flex", config, layoutContext);
+          node->layout.hadOverflow |=
+              currentRelativeChild->layout.hadOverflow;
+        }
+      }
+
+      if (parallelBatch.jobs != NULL) {
+        YGParallelFor(parallelBatch.count, config->parallelLayoutGrainSize,
+                      YGChildLayoutBatchLayout, &parallelBatch);
+        for (uint32_t i = 0; i < parallelBatch.count; i++) {
+          node->layout.hadOverflow |=
+              parallelBatch.jobs[i].child->layout.hadOverflow;
+          YGLayoutStatsAdd(&layoutContext->stats,
+                           &parallelBatch.jobs[i].stats);
+        }
+        parallelBatch.count = 0;
       }
     }
 
@@ -2848,47 +5733,24 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
 
     int numberOfAutoMarginsOnCurrentLine = 0;
     for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
-      const YGNodeRef child = YGNodeListGet(node->children, i);
-      if (child->style.positionType == YGPositionTypeRelative) {
-        if (YGMarginLeadingValue(child, mainAxis)->unit == YGUnitAuto) {
-          numberOfAutoMarginsOnCurrentLine++;
-        }
-        if (YGMarginTrailingValue(child, mainAxis)->unit == YGUnitAuto) {
-          numberOfAutoMarginsOnCurrentLine++;
-        }
+      if (items.flags[i] & YGFlexItemAutoMarginMainLeading) {
+        numberOfAutoMarginsOnCurrentLine++;
+      }
+      if (items.flags[i] & YGFlexItemAutoMarginMainTrailing) {
+        numberOfAutoMarginsOnCurrentLine++;
       }
     }
 
     if (numberOfAutoMarginsOnCurrentLine == 0) {
-      switch (justifyContent) {
-        case YGJustifyCenter:
-          leadingMainDim = remainingFreeSpace / 2;
-          break;
-        case YGJustifyFlexEnd:
-          leadingMainDim = remainingFreeSpace;
-          break;
-        case YGJustifySpaceBetween:
-          if (itemsOnLine > 1) {
-            betweenMainDim = fmaxf(remainingFreeSpace, 0) / (itemsOnLine - 1);
-          } else {
-            betweenMainDim = 0;
-          }
-          break;
-        case YGJustifySpaceAround:
-          // Space on the edges is half of the space between elements
-          betweenMainDim = remainingFreeSpace / itemsOnLine;
-          leadingMainDim = betweenMainDim / 2;
-          break;
-        case YGJustifyFlexStart:
-          break;
-      }
+      YGJustifyLine(justifyContent, remainingFreeSpace, itemsOnLine,
+                    &leadingMainDim, &betweenMainDim);
     }
 
     float mainDim = leadingPaddingAndBorderMain + leadingMainDim;
     float crossDim = 0;
 
     for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
-      const YGNodeRef child = YGNodeListGet(node->children, i);
+      const YGNodeRef child = children[i];
       if (child->style.display == YGDisplayNone) {
         continue;
       }
@@ -2908,7 +5770,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
         // We need to do that only for relative elements. Absolute elements
         // do not take part in that phase.
         if (child->style.positionType == YGPositionTypeRelative) {
-          if (YGMarginLeadingValue(child, mainAxis)->unit == YGUnitAuto) {
+          if (items.flags[i] & YGFlexItemAutoMarginMainLeading) {
             mainDim += remainingFreeSpace / numberOfAutoMarginsOnCurrentLine;
           }
 
@@ -2916,7 +5778,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
             child->layout.position[pos[mainAxis]] += mainDim;
           }
 
-          if (YGMarginTrailingValue(child, mainAxis)->unit == YGUnitAuto) {
+          if (items.flags[i] & YGFlexItemAutoMarginMainTrailing) {
             mainDim += remainingFreeSpace / numberOfAutoMarginsOnCurrentLine;
           }
 
@@ -2925,10 +5787,8 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
             // measuredDims because
             // they weren't computed. This means we can't call
             // YGNodeDimWithMargin.
-            mainDim +=
-                betweenMainDim +
-                YGNodeMarginForAxis(child, mainAxis, availableInnerWidth) +
-                child->layout.computedFlexBasis;
+            mainDim += betweenMainDim + items.marginMain[i] +
+                       child->layout.computedFlexBasis;
             crossDim = availableInnerCrossDim;
           } else {
             // The main dimension is the sum of all the elements dimension plus
@@ -2977,7 +5837,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
     // We can skip child alignment if we're just measuring the container.
     if (performLayout) {
       for (uint32_t i = startOfLineIndex; i < endOfLineIndex; i++) {
-        const YGNodeRef child = YGNodeListGet(node->children, i);
+        const YGNodeRef child = children[i];
         if (child->style.display == YGDisplayNone) {
           continue;
         }
@@ -3026,15 +5886,13 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
                   child->layout.measuredDimensions[dim[mainAxis]];
               float childCrossSize =
                   !YGFloatIsUndefined(child->style.aspectRatio)
-                      ? ((YGNodeMarginForAxis(child, crossAxis,
-                                              availableInnerWidth) +
+                      ? ((items.marginCross[i] +
                           (isMainAxisRow
                                ? childMainSize / child->style.aspectRatio
                                : childMainSize * child->style.aspectRatio)))
                       : crossDim;
 
-              childMainSize +=
-                  YGNodeMarginForAxis(child, mainAxis, availableInnerWidth);
+              childMainSize += items.marginMain[i];
 
               YGMeasureMode childMainMeasureMode = YGMeasureModeExactly;
               YGMeasureMode childCrossMeasureMode = YGMeasureModeExactly;
@@ -3057,11 +5915,24 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
                   YGFloatIsUndefined(childHeight) ? YGMeasureModeUndefined
                                                   : YGMeasureModeExactly;
 
-              YGLayoutNodeInternal(child, childWidth, childHeight, direction,
-                                   childWidthMeasureMode,
-                                   childHeightMeasureMode, availableInnerWidth,
-                                   availableInnerHeight, true, "stretch",
-                                   config);
+              // A child laid out stretched in STEP 5 is only laid out again
+              // if it was laid out at a different size, even by a rounding
+              // error, so that it ends up exactly as if laid out here.
+              const YGCachedMeasurement *const cachedLayout =
+                  &child->layout.cachedLayout;
+              if ((items.flags[i] & YGFlexItemLaidOutStretched) &&
+                  cachedLayout->availableWidth == childWidth &&
+                  cachedLayout->availableHeight == childHeight &&
+                  cachedLayout->widthMeasureMode == childWidthMeasureMode &&
+                  cachedLayout->heightMeasureMode == childHeightMeasureMode) {
+                layoutContext->stats.stretchLayoutsAvoided++;
+              } else {
+                YGLayoutNodeInternal(
+                    child, childWidth, childHeight, direction,
+                    childWidthMeasureMode, childHeightMeasureMode,
+                    availableInnerWidth, availableInnerHeight, true,
+                    "stretch", config, layoutContext);
+              }
             }
           } else {
             const float remainingCrossDim =
@@ -3099,44 +5970,10 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
   // STEP 8: MULTI-LINE CONTENT ALIGNMENT
   if (performLayout && (lineCount > 1 || YGIsBaselineLayout(node)) &&
       !YGFloatIsUndefined(availableInnerCrossDim)) {
-    const float remainingAlignContentDim =
-        availableInnerCrossDim - totalLineCrossDim;
-
     float crossDimLead = 0;
     float currentLead = leadingPaddingAndBorderCross;
-
-    switch (node->style.alignContent) {
-      case YGAlignFlexEnd:
-        currentLead += remainingAlignContentDim;
-        break;
-      case YGAlignCenter:
-        currentLead += remainingAlignContentDim / 2;
-        break;
-      case YGAlignStretch:
-        if (availableInnerCrossDim > totalLineCrossDim) {
-          crossDimLead = remainingAlignContentDim / lineCount;
-        }
-        break;
-      case YGAlignSpaceAround:
-        if (availableInnerCrossDim > totalLineCrossDim) {
-          currentLead += remainingAlignContentDim / (2 * lineCount);
-          if (lineCount > 1) {
-            crossDimLead = remainingAlignContentDim / lineCount;
-          }
-        } else {
-          currentLead += remainingAlignContentDim / 2;
-        }
-        break;
-      case YGAlignSpaceBetween:
-        if (availableInnerCrossDim > totalLineCrossDim && lineCount > 1) {
-          crossDimLead = remainingAlignContentDim / (lineCount - 1);
-        }
-        break;
-      case YGAlignAuto:
-      case YGAlignFlexStart:
-      case YGAlignBaseline:
-        break;
-    }
+    YGAlignLines(node->style.alignContent, availableInnerCrossDim,
+                 totalLineCrossDim, lineCount, &currentLead, &crossDimLead);
 
     uint32_t endIndex = 0;
     for (uint32_t i = 0; i < lineCount; i++) {
@@ -3148,7 +5985,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
       float maxAscentForCurrentLine = 0;
       float maxDescentForCurrentLine = 0;
       for (ii = startIndex; ii < childCount; ii++) {
-        const YGNodeRef child = YGNodeListGet(node->children, ii);
+        const YGNodeRef child = children[ii];
         if (child->style.display == YGDisplayNone) {
           continue;
         }
@@ -3184,7 +6021,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
 
       if (performLayout) {
         for (ii = startIndex; ii < endIndex; ii++) {
-          const YGNodeRef child = YGNodeListGet(node->children, ii);
+          const YGNodeRef child = children[ii];
           if (child->style.display == YGDisplayNone) {
             continue;
           }
@@ -3248,7 +6085,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
                         child, childWidth, childHeight, direction,
                         YGMeasureModeExactly, YGMeasureModeExactly,
                         availableInnerWidth, availableInnerHeight, true,
-                        "multiline-stretch", config);
+                        "multiline-stretch", config, layoutContext);
                   }
                 }
                 break;
@@ -3274,49 +6111,11 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
   }
 
   // STEP 9: COMPUTING FINAL DIMENSIONS
-  node->layout.measuredDimensions[YGDimensionWidth] =
-      YGNodeBoundAxis(node, YGFlexDirectionRow, availableWidth - marginAxisRow,
-                      parentWidth, parentWidth);
-  node->layout.measuredDimensions[YGDimensionHeight] = YGNodeBoundAxis(
-      node, YGFlexDirectionColumn, availableHeight - marginAxisColumn,
-      parentHeight, parentWidth);
-
-  // If the user didn't specify a width or height for the node, set the
-  // dimensions based on the children.
-  if (measureModeMainDim == YGMeasureModeUndefined ||
-      (node->style.overflow != YGOverflowScroll &&
-       measureModeMainDim == YGMeasureModeAtMost)) {
-    // Clamp the size to the min/max size, if specified, and make sure it
-    // doesn't go below the padding and border amount.
-    node->layout.measuredDimensions[dim[mainAxis]] = YGNodeBoundAxis(
-        node, mainAxis, maxLineMainDim, mainAxisParentSize, parentWidth);
-  } else if (measureModeMainDim == YGMeasureModeAtMost &&
-             node->style.overflow == YGOverflowScroll) {
-    node->layout.measuredDimensions[dim[mainAxis]] =
-        fmaxf(fminf(availableInnerMainDim + paddingAndBorderAxisMain,
-                    YGNodeBoundAxisWithinMinAndMax(
-                        node, mainAxis, maxLineMainDim, mainAxisParentSize)),
-              paddingAndBorderAxisMain);
-  }
-
-  if (measureModeCrossDim == YGMeasureModeUndefined ||
-      (node->style.overflow != YGOverflowScroll &&
-       measureModeCrossDim == YGMeasureModeAtMost)) {
-    // Clamp the size to the min/max size, if specified, and make sure it
-    // doesn't go below the padding and border amount.
-    node->layout.measuredDimensions[dim[crossAxis]] = YGNodeBoundAxis(
-        node, crossAxis, totalLineCrossDim + paddingAndBorderAxisCross,
-        crossAxisParentSize, parentWidth);
-  } else if (measureModeCrossDim == YGMeasureModeAtMost &&
-             node->style.overflow == YGOverflowScroll) {
-    node->layout.measuredDimensions[dim[crossAxis]] =
-        fmaxf(fminf(availableInnerCrossDim + paddingAndBorderAxisCross,
-                    YGNodeBoundAxisWithinMinAndMax(
-                        node, crossAxis,
-                        totalLineCrossDim + paddingAndBorderAxisCross,
-                        crossAxisParentSize)),
-              paddingAndBorderAxisCross);
-  }
+  YGNodeSetMeasuredDimensionsFromLines(
+      node, availableWidth, availableHeight, mainAxis, crossAxis,
+      measureModeMainDim, measureModeCrossDim, availableInnerMainDim,
+      availableInnerCrossDim, maxLineMainDim, totalLineCrossDim, parentWidth,
+      parentHeight);
 
   // As we only wrapped in normal direction yet, we need to reverse the
   // positions on wrap-reverse.
@@ -3340,7 +6139,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
       YGNodeAbsoluteLayoutChild(
           node, currentAbsoluteChild, availableInnerWidth,
           isMainAxisRow ? measureModeMainDim : measureModeCrossDim,
-          availableInnerHeight, direction, config);
+          availableInnerHeight, direction, config, layoutContext);
     }
 
     // STEP 11: SETTING TRAILING POSITIONS FOR CHILDREN
@@ -3353,7 +6152,7 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
     // Set trailing position if necessary.
     if (needsMainTrailingPos || needsCrossTrailingPos) {
       for (uint32_t i = 0; i < childCount; i++) {
-        const YGNodeRef child = YGNodeListGet(node->children, i);
+        const YGNodeRef child = children[i];
         if (child->style.display == YGDisplayNone) {
           continue;
         }
@@ -3367,9 +6166,143 @@ static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
       }
     }
   }
+
+  YGScratchStackRelease(&layoutContext->scratch, scratchMark);
+}
+
+#ifdef YG_SPECIALIZE_AXES
+// Copies of the flexbox algorithm for the two most common kinds of containers,
+// left-to-right rows and columns.
+static void YGNodeLayoutColumn(
+    const YGNodeRef node, const float availableWidth,
+    const float availableHeight, const YGDirection direction,
+    const YGMeasureMode widthMeasureMode, const YGMeasureMode heightMeasureMode,
+    const float parentWidth, const float parentHeight, const bool performLayout,
+    const YGConfigRef config, YGLayoutContext *const layoutContext) {
+  YGNodeLayoutFlexContainer(node, availableWidth, availableHeight, direction,
+                            widthMeasureMode, heightMeasureMode, parentWidth,
+                            parentHeight, performLayout, config, layoutContext,
+                            YGFlexDirectionColumn, YGFlexDirectionRow);
+}
+
+static void YGNodeLayoutRow(
+    const YGNodeRef node, const float availableWidth,
+    const float availableHeight, const YGDirection direction,
+    const YGMeasureMode widthMeasureMode, const YGMeasureMode heightMeasureMode,
+    const float parentWidth, const float parentHeight, const bool performLayout,
+    const YGConfigRef config, YGLayoutContext *const layoutContext) {
+  YGNodeLayoutFlexContainer(node, availableWidth, availableHeight, direction,
+                            widthMeasureMode, heightMeasureMode, parentWidth,
+                            parentHeight, performLayout, config, layoutContext,
+                            YGFlexDirectionRow, YGFlexDirectionColumn);
+}
+#endif
+
+static void YGNodelayoutImpl(const YGNodeRef node, const float availableWidth,
+                             const float availableHeight,
+                             const YGDirection parentDirection,
+                             const YGMeasureMode widthMeasureMode,
+                             const YGMeasureMode heightMeasureMode,
+                             const float parentWidth, const float parentHeight,
+                             const bool performLayout,
+                             const YGConfigRef config,
+                             YGLayoutContext *const layoutContext) {
+  YGAssertWithNode(node,
+                   YGFloatIsUndefined(availableWidth)
+                       ? widthMeasureMode == YGMeasureModeUndefined
+                       : true,
+                   "availableWidth is indefinite so widthMeasureMode must be "
+                   "YGMeasureModeUndefined");
+  YGAssertWithNode(node,
+                   YGFloatIsUndefined(availableHeight)
+                       ? heightMeasureMode == YGMeasureModeUndefined
+                       : true,
+                   "availableHeight is indefinite so heightMeasureMode must be "
+                   "YGMeasureModeUndefined");
+
+  // Set the resolved resolution in the node's layout.
+  const YGDirection direction = YGNodeResolveDirection(node, parentDirection);
+  node->layout.direction = direction;
+
+  const YGFlexDirection flexRowDirection =
+      YGResolveFlexDirection(YGFlexDirectionRow, direction);
+  const YGFlexDirection flexColumnDirection =
+      YGResolveFlexDirection(YGFlexDirectionColumn, direction);
+
+  node->layout.margin[YGEdgeStart] =
+      YGNodeLeadingMargin(node, flexRowDirection, parentWidth);
+  node->layout.margin[YGEdgeEnd] =
+      YGNodeTrailingMargin(node, flexRowDirection, parentWidth);
+  node->layout.margin[YGEdgeTop] =
+      YGNodeLeadingMargin(node, flexColumnDirection, parentWidth);
+  node->layout.margin[YGEdgeBottom] =
+      YGNodeTrailingMargin(node, flexColumnDirection, parentWidth);
+
+  node->layout.border[YGEdgeStart] =
+      YGNodeLeadingBorder(node, flexRowDirection);
+  node->layout.border[YGEdgeEnd] = YGNodeTrailingBorder(node, flexRowDirection);
+  node->layout.border[YGEdgeTop] =
+      YGNodeLeadingBorder(node, flexColumnDirection);
+  node->layout.border[YGEdgeBottom] =
+      YGNodeTrailingBorder(node, flexColumnDirection);
+
+  node->layout.padding[YGEdgeStart] =
+      YGNodeLeadingPadding(node, flexRowDirection, parentWidth);
+  node->layout.padding[YGEdgeEnd] =
+      YGNodeTrailingPadding(node, flexRowDirection, parentWidth);
+  node->layout.padding[YGEdgeTop] =
+      YGNodeLeadingPadding(node, flexColumnDirection, parentWidth);
+  node->layout.padding[YGEdgeBottom] =
+      YGNodeTrailingPadding(node, flexColumnDirection, parentWidth);
+
+  if (node->measure) {
+    YGNodeWithMeasureFuncSetMeasuredDimensions(
+        node, availableWidth, availableHeight, widthMeasureMode,
+        heightMeasureMode, parentWidth, parentHeight, layoutContext);
+    return;
+  }
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  if (childCount == 0) {
+    YGNodeEmptyContainerSetMeasuredDimensions(
+        node, availableWidth, availableHeight, widthMeasureMode,
+        heightMeasureMode, parentWidth, parentHeight);
+    return;
+  }
+
+  // If we're not being asked to perform a full layout we can skip the algorithm
+  // if we already know the size
+  if (!performLayout &&
+      YGNodeFixedSizeSetMeasuredDimensions(
+          node, availableWidth, availableHeight, widthMeasureMode,
+          heightMeasureMode, parentWidth, parentHeight)) {
+    return;
+  }
+
+  const YGFlexDirection mainAxis =
+      YGResolveFlexDirection(node->style.flexDirection, direction);
+  const YGFlexDirection crossAxis = YGFlexDirectionCross(mainAxis, direction);
+#ifdef YG_SPECIALIZE_AXES
+  if (mainAxis == YGFlexDirectionColumn && crossAxis == YGFlexDirectionRow) {
+    YGNodeLayoutColumn(node, availableWidth, availableHeight, direction,
+                       widthMeasureMode, heightMeasureMode, parentWidth,
+                       parentHeight, performLayout, config, layoutContext);
+    return;
+  }
+  if (mainAxis == YGFlexDirectionRow && crossAxis == YGFlexDirectionColumn) {
+    YGNodeLayoutRow(node, availableWidth, availableHeight, direction,
+                    widthMeasureMode, heightMeasureMode, parentWidth,
+                    parentHeight, performLayout, config, layoutContext);
+    return;
+  }
+#endif
+  YGNodeLayoutFlexContainer(node, availableWidth, availableHeight, direction,
+                            widthMeasureMode, heightMeasureMode, parentWidth,
+                            parentHeight, performLayout, config, layoutContext,
+                            mainAxis, crossAxis);
 }
 
-uint32_t gDepth = 0;
+
 bool gPrintTree = false;
 bool gPrintChanges = false;
 bool gPrintSkips = false;
@@ -3445,6 +6378,122 @@ float YGRoundValueToPixelGrid(const float value, const float pointScaleFactor,
   return scaledValue / pointScaleFactor;
 }
 
+// The vector versions of YGRoundValueToPixelGrid below return bit for bit the
+// same values. For finite values that fit an int32, scaled - fmodf(scaled, 1)
+// is exactly the truncated value, so truncating and subtracting is enough.
+// Larger values and NaN are already integral or lost; they are not truncated.
+
+#if YG_SSE2
+static inline __m128 YGLoadForceMask(const bool *const flags) {
+  int32_t bytes;
+  memcpy(&bytes, flags, sizeof(bytes));
+  __m128i mask = _mm_cvtsi32_si128(bytes);
+  mask = _mm_unpacklo_epi8(mask, mask);
+  mask = _mm_unpacklo_epi16(mask, mask);
+  return _mm_castsi128_ps(_mm_cmpgt_epi32(mask, _mm_setzero_si128()));
+}
+
+static inline __m128 YGRoundVectorToPixelGrid(const __m128 value,
+                                              const __m128 pointScaleFactor,
+                                              const __m128 forceCeil,
+                                              const __m128 forceFloor) {
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 epsilon = _mm_set1_ps(0.0001f);
+
+  const __m128 scaledValue = _mm_mul_ps(value, pointScaleFactor);
+  const __m128 isSmall = _mm_cmplt_ps(_mm_andnot_ps(signMask, scaledValue),
+                                      _mm_set1_ps(8388608.0f));
+  const __m128 truncated =
+      _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_and_ps(scaledValue, isSmall)));
+  const __m128 integral = _mm_or_ps(_mm_and_ps(isSmall, truncated),
+                                    _mm_andnot_ps(isSmall, scaledValue));
+  const __m128 fractial = _mm_sub_ps(scaledValue, integral);
+
+  const __m128 isZero =
+      _mm_cmplt_ps(_mm_andnot_ps(signMask, fractial), epsilon);
+  const __m128 isOne = _mm_cmplt_ps(
+      _mm_andnot_ps(signMask, _mm_sub_ps(fractial, one)), epsilon);
+  const __m128 roundsUp = _mm_andnot_ps(
+      forceFloor, _mm_cmpge_ps(fractial, _mm_set1_ps(0.5f)));
+  const __m128 up = _mm_andnot_ps(
+      isZero, _mm_or_ps(isOne, _mm_or_ps(forceCeil, roundsUp)));
+
+  const __m128 roundedValue = _mm_add_ps(_mm_sub_ps(scaledValue, fractial),
+                                         _mm_and_ps(up, one));
+  return _mm_div_ps(roundedValue, pointScaleFactor);
+}
+#elif YG_NEON
+static inline uint32x4_t YGLoadForceMask(const bool *const flags) {
+  uint32_t bytes;
+  memcpy(&bytes, flags, sizeof(bytes));
+  const uint8x8_t mask = vreinterpret_u8_u32(vdup_n_u32(bytes));
+  return vcgtq_u32(vmovl_u16(vget_low_u16(vmovl_u8(mask))), vdupq_n_u32(0));
+}
+
+static inline float32x4_t YGRoundVectorToPixelGrid(
+    const float32x4_t value, const float32x4_t pointScaleFactor,
+    const uint32x4_t forceCeil, const uint32x4_t forceFloor) {
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t epsilon = vdupq_n_f32(0.0001f);
+
+  const float32x4_t scaledValue = vmulq_f32(value, pointScaleFactor);
+  const uint32x4_t isSmall =
+      vcltq_f32(vabsq_f32(scaledValue), vdupq_n_f32(8388608.0f));
+  const float32x4_t truncated = vcvtq_f32_s32(vcvtq_s32_f32(scaledValue));
+  const float32x4_t integral = vbslq_f32(isSmall, truncated, scaledValue);
+  const float32x4_t fractial = vsubq_f32(scaledValue, integral);
+
+  const uint32x4_t isZero = vcltq_f32(vabsq_f32(fractial), epsilon);
+  const uint32x4_t isOne =
+      vcltq_f32(vabsq_f32(vsubq_f32(fractial, one)), epsilon);
+  const uint32x4_t roundsUp =
+      vbicq_u32(vcgeq_f32(fractial, vdupq_n_f32(0.5f)), forceFloor);
+  const uint32x4_t up =
+      vbicq_u32(vorrq_u32(isOne, vorrq_u32(forceCeil, roundsUp)), isZero);
+
+  const float32x4_t roundedValue =
+      vaddq_f32(vsubq_f32(scaledValue, fractial),
+                vreinterpretq_f32_u32(
+                    vandq_u32(up, vreinterpretq_u32_f32(one))));
+  return vdivq_f32(roundedValue, pointScaleFactor);
+}
+#endif
+
+void YGRoundValuesToPixelGrid(float *const values, const uint32_t count,
+                              const float pointScaleFactor,
+                              const bool *const forceCeil,
+                              const bool *const forceFloor) {
+  uint32_t i = 0;
+#if YG_SSE2 || YG_NEON
+  static const bool kNoForce[4] = {false, false, false, false};
+#endif
+#if YG_SSE2
+  const __m128 scale = _mm_set1_ps(pointScaleFactor);
+  for (; i + 4 <= count; i += 4) {
+    const __m128 rounded = YGRoundVectorToPixelGrid(
+        _mm_loadu_ps(values + i), scale,
+        YGLoadForceMask(forceCeil != NULL ? forceCeil + i : kNoForce),
+        YGLoadForceMask(forceFloor != NULL ? forceFloor + i : kNoForce));
+    _mm_storeu_ps(values + i, rounded);
+  }
+#elif YG_NEON
+  const float32x4_t scale = vdupq_n_f32(pointScaleFactor);
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t rounded = YGRoundVectorToPixelGrid(
+        vld1q_f32(values + i), scale,
+        YGLoadForceMask(forceCeil != NULL ? forceCeil + i : kNoForce),
+        YGLoadForceMask(forceFloor != NULL ? forceFloor + i : kNoForce));
+    vst1q_f32(values + i, rounded);
+  }
+#endif
+  for (; i < count; i++) {
+    values[i] = YGRoundValueToPixelGrid(
+        values[i], pointScaleFactor, forceCeil != NULL && forceCeil[i],
+        forceFloor != NULL && forceFloor[i]);
+  }
+}
+
 bool YGNodeCanUseCachedMeasurement(
     const YGMeasureMode widthMode, const float width,
     const YGMeasureMode heightMode, const float height,
@@ -3506,6 +6555,122 @@ bool YGNodeCanUseCachedMeasurement(
   return widthIsCompatible && heightIsCompatible;
 }
 
+static inline uint32_t YGMeasurementCacheFloatKey(const float value) {
+  if (YGFloatIsUndefined(value)) {
+    return 0x7fc00000;
+  }
+  // Adding zero turns a negative zero into a positive one.
+  const float rounded = roundf(value) + 0.0f;
+  uint32_t bits;
+  memcpy(&bits, &rounded, sizeof(bits));
+  return bits;
+}
+
+static inline uint32_t YGMeasurementCacheKey(const YGMeasureMode widthMode,
+                                             const float width,
+                                             const YGMeasureMode heightMode,
+                                             const float height) {
+  uint32_t key = YGMeasurementCacheFloatKey(width) * 0x9e3779b1u;
+  key = (key ^ YGMeasurementCacheFloatKey(height)) * 0x85ebca77u;
+  return key ^ (uint32_t)widthMode ^ ((uint32_t)heightMode << 2);
+}
+
+// Whether |entry| answers a request to measure |node| under the given
+// constraints. Nodes with a measure function accept any compatible
+// constraints; the others only the same ones.
+static inline bool YGCachedMeasurementMatches(
+    const YGNodeRef node, const YGCachedMeasurement *const entry,
+    const float availableWidth, const float availableHeight,
+    const YGMeasureMode widthMeasureMode, const YGMeasureMode heightMeasureMode,
+    const float marginRow, const float marginColumn, const YGConfigRef config) {
+  if (node->measure != NULL) {
+    return YGNodeCanUseCachedMeasurement(
+        widthMeasureMode, availableWidth, heightMeasureMode, availableHeight,
+        entry->widthMeasureMode, entry->availableWidth,
+        entry->heightMeasureMode, entry->availableHeight,
+        entry->computedWidth, entry->computedHeight, marginRow, marginColumn,
+        config);
+  }
+  return YGFloatsEqual(entry->availableWidth, availableWidth) &&
+         YGFloatsEqual(entry->availableHeight, availableHeight) &&
+         entry->widthMeasureMode == widthMeasureMode &&
+         entry->heightMeasureMode == heightMeasureMode;
+}
+
+// Finds a measurement of |node| for the given constraints. The entries are
+// tried in the order they were stored, as several of them may be compatible
+// with the constraints of a node with a measure function and the first one
+// wins. The other nodes only accept the same constraints, so the key rules
+// out most entries without comparing them.
+static YGCachedMeasurement *YGNodeFindCachedMeasurement(
+    const YGNodeRef node, const uint32_t key, const float availableWidth,
+    const float availableHeight, const YGMeasureMode widthMeasureMode,
+    const YGMeasureMode heightMeasureMode, const float marginRow,
+    const float marginColumn, const YGConfigRef config,
+    const uint32_t generationCount) {
+  YGMeasurementCacheEntry *const entries = node->cachedMeasurements;
+  const uint32_t count = node->layout.nextCachedMeasurementsIndex;
+  for (uint32_t i = 0; i < count; i++) {
+    if ((node->measure != NULL || entries[i].key == key) &&
+        YGCachedMeasurementMatches(node, &entries[i].measurement,
+                                   availableWidth, availableHeight,
+                                   widthMeasureMode, heightMeasureMode,
+                                   marginRow, marginColumn, config)) {
+      entries[i].lastUsed = generationCount;
+      return &entries[i].measurement;
+    }
+  }
+  return NULL;
+}
+
+// Called when a request for |node| missed the caches. Round robin starts over
+// once the measurement cache is full, dropping every entry, as soon as any
+// result is stored, including a layout.
+static void YGNodeWillCacheResult(const YGNodeRef node) {
+  if (node->config->measurementCacheEviction == YGCacheEvictionRoundRobin &&
+      node->layout.nextCachedMeasurementsIndex > 0 &&
+      node->layout.nextCachedMeasurementsIndex >=
+          YGNodeMeasurementCacheLimit(node)) {
+    if (gPrintChanges) {
+      printf("Out of cache entries!\n");
+    }
+    node->layout.nextCachedMeasurementsIndex = 0;
+  }
+}
+
+// Returns the entry to store a new measurement of |node| in, or NULL if its
+// config disables the cache. A full cache evicts its least recently used
+// entry; round robin caches were emptied by YGNodeWillCacheResult.
+static YGCachedMeasurement *YGNodeAddCachedMeasurement(
+    const YGNodeRef node, const uint32_t key, const uint32_t generationCount) {
+  YGLayout *const layout = &node->layout;
+  const uint32_t limit = YGNodeMeasurementCacheLimit(node);
+  if (limit == 0) {
+    return NULL;
+  }
+
+  uint32_t index = layout->nextCachedMeasurementsIndex;
+  if (index >= limit) {
+    index = 0;
+    for (uint32_t i = 1; i < layout->nextCachedMeasurementsIndex; i++) {
+      if (node->cachedMeasurements[i].lastUsed <
+          node->cachedMeasurements[index].lastUsed) {
+        index = i;
+      }
+    }
+  } else {
+    if (index == node->cachedMeasurementsCapacity) {
+      YGNodeGrowCachedMeasurements(node, limit);
+    }
+    layout->nextCachedMeasurementsIndex++;
+  }
+
+  YGMeasurementCacheEntry *const entry = &node->cachedMeasurements[index];
+  entry->key = key;
+  entry->lastUsed = generationCount;
+  return &entry->measurement;
+}
+
 //
 // This is a wrapper around the YGNodelayoutImpl function. It determines
 // whether the layout request is redundant and can be skipped.
@@ -3521,15 +6686,47 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
                           const YGMeasureMode heightMeasureMode,
                           const float parentWidth, const float parentHeight,
                           const bool performLayout, const char *reason,
-                          const YGConfigRef config) {
+                          const YGConfigRef config,
+                          YGLayoutContext *const layoutContext) {
   YGLayout *layout = &node->layout;
 
-  gDepth++;
+  layoutContext->depth++;
+  const uint32_t depth = layoutContext->depth;
+  layoutContext->stats.nodesVisited++;
+  if (depth > layoutContext->stats.maxDepth) {
+    layoutContext->stats.maxDepth = depth;
+  }
+
+  const YGTraceFunc traceFunc = config->traceFunc;
+  YGTraceEvent traceEvent;
+  if (traceFunc != NULL) {
+    traceEvent = (YGTraceEvent){
+        .end = false,
+        .node = node,
+        .reason = reason,
+        .depth = depth,
+        .performLayout = performLayout,
+        .availableWidth = availableWidth,
+        .availableHeight = availableHeight,
+        .widthMeasureMode = widthMeasureMode,
+        .heightMeasureMode = heightMeasureMode,
+        .cacheOutcome = YGCacheOutcomeMiss,
+        .measuredWidth = YGUndefined,
+        .measuredHeight = YGUndefined,
+        .time = YGNow(),
+    };
+    traceFunc(&traceEvent, config->traceContext);
+  }
 
   const bool needToVisitNode =
-      (node->isDirty && layout->generationCount != gCurrentGenerationCount) ||
+      (node->isDirty &&
+       layout->generationCount != layoutContext->generationCount) ||
       layout->lastParentDirection != parentDirection;
 
+  if (performLayout) {
+    YGNodeUpdateBaselineReader(node);
+  }
+
   if (needToVisitNode) {
     // Invalidate the cached results.
     layout->nextCachedMeasurementsIndex = 0;
@@ -3540,6 +6737,9 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
   }
 
   YGCachedMeasurement *cachedResults = NULL;
+  const uint32_t key =
+      YGMeasurementCacheKey(widthMeasureMode, availableWidth,
+                            heightMeasureMode, availableHeight);
 
   // Determine whether the results are already cached. We maintain a separate
   // cache for layouts and measurements. A layout operation modifies the
@@ -3572,20 +6772,10 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
       cachedResults = &layout->cachedLayout;
     } else {
       // Try to use the measurement cache.
-      for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
-        if (YGNodeCanUseCachedMeasurement(
-                widthMeasureMode, availableWidth, heightMeasureMode,
-                availableHeight, layout->cachedMeasurements[i].widthMeasureMode,
-                layout->cachedMeasurements[i].availableWidth,
-                layout->cachedMeasurements[i].heightMeasureMode,
-                layout->cachedMeasurements[i].availableHeight,
-                layout->cachedMeasurements[i].computedWidth,
-                layout->cachedMeasurements[i].computedHeight, marginAxisRow,
-                marginAxisColumn, config)) {
-          cachedResults = &layout->cachedMeasurements[i];
-          break;
-        }
-      }
+      cachedResults = YGNodeFindCachedMeasurement(
+          node, key, availableWidth, availableHeight, widthMeasureMode,
+          heightMeasureMode, marginAxisRow, marginAxisColumn, config,
+          layoutContext->generationCount);
     }
   } else if (performLayout) {
     if (YGFloatsEqual(layout->cachedLayout.availableWidth, availableWidth) &&
@@ -3595,27 +6785,29 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
       cachedResults = &layout->cachedLayout;
     }
   } else {
-    for (uint32_t i = 0; i < layout->nextCachedMeasurementsIndex; i++) {
-      if (YGFloatsEqual(layout->cachedMeasurements[i].availableWidth,
-                        availableWidth) &&
-          YGFloatsEqual(layout->cachedMeasurements[i].availableHeight,
-                        availableHeight) &&
-          layout->cachedMeasurements[i].widthMeasureMode == widthMeasureMode &&
-          layout->cachedMeasurements[i].heightMeasureMode ==
-              heightMeasureMode) {
-        cachedResults = &layout->cachedMeasurements[i];
-        break;
-      }
-    }
+    cachedResults = YGNodeFindCachedMeasurement(
+        node, key, availableWidth, availableHeight, widthMeasureMode,
+        heightMeasureMode, 0, 0, config, layoutContext->generationCount);
   }
 
   if (!needToVisitNode && cachedResults != NULL) {
+    if (cachedResults == &layout->cachedLayout) {
+      layoutContext->stats.layoutCacheHits++;
+    } else {
+      layoutContext->stats.measurementCacheHits++;
+    }
+    if (layout->measuredDimensions[YGDimensionWidth] !=
+            cachedResults->computedWidth ||
+        layout->measuredDimensions[YGDimensionHeight] !=
+            cachedResults->computedHeight) {
+      layout->baseline = YGUndefined;
+    }
     layout->measuredDimensions[YGDimensionWidth] = cachedResults->computedWidth;
     layout->measuredDimensions[YGDimensionHeight] =
         cachedResults->computedHeight;
 
     if (gPrintChanges && gPrintSkips) {
-      printf("%s%d.{[skipped] ", YGSpacer(gDepth), gDepth);
+      printf("%s%d.{[skipped] ", YGSpacer(depth), depth);
       if (node->print) {
         node->print(node);
       }
@@ -3627,7 +6819,7 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
     }
   } else {
     if (gPrintChanges) {
-      printf("%s%d.{%s", YGSpacer(gDepth), gDepth, needToVisitNode ? "*" : "");
+      printf("%s%d.{%s", YGSpacer(depth), depth, needToVisitNode ? "*" : "");
       if (node->print) {
         node->print(node);
       }
@@ -3637,12 +6829,13 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
              availableWidth, availableHeight, reason);
     }
 
+    layout->baseline = YGUndefined;
     YGNodelayoutImpl(node, availableWidth, availableHeight, parentDirection,
                      widthMeasureMode, heightMeasureMode, parentWidth,
-                     parentHeight, performLayout, config);
+                     parentHeight, performLayout, config, layoutContext);
 
     if (gPrintChanges) {
-      printf("%s%d.}%s", YGSpacer(gDepth), gDepth, needToVisitNode ? "*" : "");
+      printf("%s%d.}%s", YGSpacer(depth), depth, needToVisitNode ? "*" : "");
       if (node->print) {
         node->print(node);
       }
@@ -3655,25 +6848,18 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
 
     layout->lastParentDirection = parentDirection;
 
+    YGCachedMeasurement *newCacheEntry = NULL;
     if (cachedResults == NULL) {
-      if (layout->nextCachedMeasurementsIndex == YG_MAX_CACHED_RESULT_COUNT) {
-        if (gPrintChanges) {
-          printf("Out of cache entries!\n");
-        }
-        layout->nextCachedMeasurementsIndex = 0;
-      }
-
-      YGCachedMeasurement *newCacheEntry;
+      YGNodeWillCacheResult(node);
       if (performLayout) {
         // Use the single layout cache entry.
         newCacheEntry = &layout->cachedLayout;
       } else {
-        // Allocate a new measurement cache entry.
-        newCacheEntry =
-            &layout->cachedMeasurements[layout->nextCachedMeasurementsIndex];
-        layout->nextCachedMeasurementsIndex++;
+        newCacheEntry = YGNodeAddCachedMeasurement(
+            node, key, layoutContext->generationCount);
       }
-
+    }
+    if (newCacheEntry != NULL) {
       newCacheEntry->availableWidth = availableWidth;
       newCacheEntry->availableHeight = availableHeight;
       newCacheEntry->widthMeasureMode = widthMeasureMode;
@@ -3690,12 +6876,26 @@ bool YGLayoutNodeInternal(const YGNodeRef node, const float availableWidth,
         node->layout.measuredDimensions[YGDimensionWidth];
     node->layout.dimensions[YGDimensionHeight] =
         node->layout.measuredDimensions[YGDimensionHeight];
+    layout->isRelayoutBoundary = YGNodeIsRelayoutBoundary(node);
     node->hasNewLayout = true;
     node->isDirty = false;
   }
 
-  gDepth--;
-  layout->generationCount = gCurrentGenerationCount;
+  if (traceFunc != NULL) {
+    traceEvent.end = true;
+    if (!needToVisitNode && cachedResults != NULL) {
+      traceEvent.cacheOutcome = cachedResults == &layout->cachedLayout
+                                    ? YGCacheOutcomeLayoutCache
+                                    : YGCacheOutcomeMeasurementCache;
+    }
+    traceEvent.measuredWidth = layout->measuredDimensions[YGDimensionWidth];
+    traceEvent.measuredHeight = layout->measuredDimensions[YGDimensionHeight];
+    traceEvent.time = YGNow();
+    traceFunc(&traceEvent, config->traceContext);
+  }
+
+  layoutContext->depth--;
+  layout->generationCount = layoutContext->generationCount;
   return (needToVisitNode || cachedResults == NULL);
 }
 
@@ -3713,13 +6913,93 @@ void YGConfigSetPointScaleFactor(const YGConfigRef config,
   }
 }
 
-static void YGRoundToPixelGrid(const YGNodeRef node,
-                               const float pointScaleFactor,
-                               const float absoluteLeft,
-                               const float absoluteTop) {
-  if (pointScaleFactor == 0.0f) {
+// Order of the values gathered for every node.
+enum {
+  YGPixelGridLeft,
+  YGPixelGridTop,
+  YGPixelGridAbsoluteLeft,
+  YGPixelGridAbsoluteTop,
+  YGPixelGridAbsoluteRight,
+  YGPixelGridAbsoluteBottom,
+};
+
+// The arrays of the buffer share a single allocation, so a pass over a small
+// tree allocates once.
+#define YG_PIXEL_GRID_INITIAL_CAPACITY 256
+
+static void YGPixelGridBufferReserve(YGPixelGridBuffer *const buffer,
+                                     const uint32_t capacity) {
+  if (capacity <= buffer->capacity) {
     return;
   }
+  uint32_t newCapacity = buffer->capacity > 0 ? buffer->capacity * 2
+                                              : YG_PIXEL_GRID_INITIAL_CAPACITY;
+  if (newCapacity < capacity) {
+    newCapacity = capacity;
+  }
+  const size_t valueCount = (size_t)newCapacity * YG_PIXEL_GRID_VALUE_COUNT;
+  char *const block =
+      gYGMalloc(newCapacity * sizeof(YGNodeRef) +
+                valueCount * (sizeof(float) + 2 * sizeof(bool)));
+  YGAssert(block != NULL, "Could not allocate memory for pixel grid rounding");
+
+  YGPixelGridBuffer grown = {
+      .capacity = newCapacity,
+      .count = buffer->count,
+      .nodes = (YGNodeRef *)block,
+  };
+  grown.values = (float *)(grown.nodes + newCapacity);
+  grown.forceCeil = (bool *)(grown.values + valueCount);
+  grown.forceFloor = grown.forceCeil + valueCount;
+
+  const size_t usedValueCount =
+      (size_t)buffer->count * YG_PIXEL_GRID_VALUE_COUNT;
+  if (buffer->count > 0) {
+    memcpy(grown.nodes, buffer->nodes, buffer->count * sizeof(YGNodeRef));
+    memcpy(grown.values, buffer->values, usedValueCount * sizeof(float));
+    memcpy(grown.forceCeil, buffer->forceCeil, usedValueCount * sizeof(bool));
+    memcpy(grown.forceFloor, buffer->forceFloor, usedValueCount * sizeof(bool));
+  }
+  if (buffer->capacity > 0) {
+    gYGFree(buffer->nodes);
+  }
+  *buffer = grown;
+}
+
+static void YGPixelGridBufferFree(YGPixelGridBuffer *const buffer) {
+  if (buffer->capacity > 0) {
+    gYGFree(buffer->nodes);
+  }
+  memset(buffer, 0, sizeof(YGPixelGridBuffer));
+}
+
+// Whether |value| doesn't fall on the pixel grid. Dimensions that are close to
+// a whole number of pixels count as whole, in both directions. Truncation
+// gives the same fraction as fmodf for the values that fit an int32.
+static inline bool YGHasFractionalPixels(const float value,
+                                         const float pointScaleFactor) {
+  const float scaledValue = value * pointScaleFactor;
+  const float fractial = fabsf(scaledValue) < 8388608.0f
+                             ? scaledValue - (float)(int32_t)scaledValue
+                             : fmodf(scaledValue, 1.0);
+  return !YGFloatsEqual(fractial, 0) && !YGFloatsEqual(fractial, 1.0);
+}
+
+// Appends the unrounded edges of |node|, which is at |absoluteNodeLeft| and
+// |absoluteNodeTop| in the tree, and of its subtree to |buffer|.
+static void YGGatherPixelGridValues(YGPixelGridBuffer *const buffer,
+                                    const YGNodeRef node,
+                                    const float pointScaleFactor,
+                                    const float absoluteNodeLeft,
+                                    const float absoluteNodeTop) {
+  YGPixelGridBufferReserve(buffer, buffer->count + 1);
+  const uint32_t index = buffer->count++;
+  float *const values = &buffer->values[index * YG_PIXEL_GRID_VALUE_COUNT];
+  bool *const forceCeil =
+      &buffer->forceCeil[index * YG_PIXEL_GRID_VALUE_COUNT];
+  bool *const forceFloor =
+      &buffer->forceFloor[index * YG_PIXEL_GRID_VALUE_COUNT];
+  buffer->nodes[index] = node;
 
   const float nodeLeft = node->layout.position[YGEdgeLeft];
   const float nodeTop = node->layout.position[YGEdgeTop];
@@ -3727,60 +7007,584 @@ static void YGRoundToPixelGrid(const YGNodeRef node,
   const float nodeWidth = node->layout.dimensions[YGDimensionWidth];
   const float nodeHeight = node->layout.dimensions[YGDimensionHeight];
 
-  const float absoluteNodeLeft = absoluteLeft + nodeLeft;
-  const float absoluteNodeTop = absoluteTop + nodeTop;
+  node->layout.absolutePosition[YGEdgeLeft] = absoluteNodeLeft;
+  node->layout.absolutePosition[YGEdgeTop] = absoluteNodeTop;
 
-  const float absoluteNodeRight = absoluteNodeLeft + nodeWidth;
-  const float absoluteNodeBottom = absoluteNodeTop + nodeHeight;
+  values[YGPixelGridLeft] = nodeLeft;
+  values[YGPixelGridTop] = nodeTop;
+  values[YGPixelGridAbsoluteLeft] = absoluteNodeLeft;
+  values[YGPixelGridAbsoluteTop] = absoluteNodeTop;
+  values[YGPixelGridAbsoluteRight] = absoluteNodeLeft + nodeWidth;
+  values[YGPixelGridAbsoluteBottom] = absoluteNodeTop + nodeHeight;
 
   // If a node has a custom measure function we never want to round down its
   // size as this could lead to unwanted text truncation.
   const bool textRounding = node->nodeType == YGNodeTypeText;
+  memset(forceCeil, 0, YG_PIXEL_GRID_VALUE_COUNT * sizeof(bool));
+  memset(forceFloor, textRounding, YG_PIXEL_GRID_VALUE_COUNT * sizeof(bool));
+  if (textRounding) {
+    const bool hasFractionalWidth =
+        YGHasFractionalPixels(nodeWidth, pointScaleFactor);
+    const bool hasFractionalHeight =
+        YGHasFractionalPixels(nodeHeight, pointScaleFactor);
+    forceCeil[YGPixelGridAbsoluteRight] = hasFractionalWidth;
+    forceFloor[YGPixelGridAbsoluteRight] = !hasFractionalWidth;
+    forceCeil[YGPixelGridAbsoluteBottom] = hasFractionalHeight;
+    forceFloor[YGPixelGridAbsoluteBottom] = !hasFractionalHeight;
+  }
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeGetChild(node, i);
+    YGGatherPixelGridValues(
+        buffer, child, pointScaleFactor,
+        absoluteNodeLeft + child->layout.position[YGEdgeLeft],
+        absoluteNodeTop + child->layout.position[YGEdgeTop]);
+  }
+}
+
+// Rounds the layout of the subtree of |root|, which is at |absoluteLeft| and
+// |absoluteTop| in the tree, in three steps: gather the edges of every node,
+// round them all at once and write the resulting frames back.
+static void YGRoundToPixelGrid(const YGNodeRef root,
+                               const float pointScaleFactor,
+                               const float absoluteLeft,
+                               const float absoluteTop,
+                               YGPixelGridBuffer *const buffer) {
+  if (pointScaleFactor == 0.0f) {
+    return;
+  }
+
+  buffer->count = 0;
+  YGGatherPixelGridValues(buffer, root, pointScaleFactor, absoluteLeft,
+                          absoluteTop);
+
+  YGRoundValuesToPixelGrid(buffer->values,
+                           buffer->count * YG_PIXEL_GRID_VALUE_COUNT,
+                           pointScaleFactor, buffer->forceCeil,
+                           buffer->forceFloor);
+
+  for (uint32_t i = 0; i < buffer->count; i++) {
+    const YGNodeRef node = buffer->nodes[i];
+    const float *const values = &buffer->values[i * YG_PIXEL_GRID_VALUE_COUNT];
+    node->layout.position[YGEdgeLeft] = values[YGPixelGridLeft];
+    if (node->layout.position[YGEdgeTop] != values[YGPixelGridTop]) {
+      YGNodeInvalidateBaselines(node->parent);
+    }
+    node->layout.position[YGEdgeTop] = values[YGPixelGridTop];
+    node->layout.dimensions[YGDimensionWidth] =
+        values[YGPixelGridAbsoluteRight] - values[YGPixelGridAbsoluteLeft];
+    node->layout.dimensions[YGDimensionHeight] =
+        values[YGPixelGridAbsoluteBottom] - values[YGPixelGridAbsoluteTop];
+  }
+}
+
+// Persisted layouts
+
+// "YGLC" in memory on little endian machines. Data written with the other byte
+// order has a different magic and is rejected.
+#define YG_PERSISTED_LAYOUT_MAGIC 0x434c4759u
+// Bump whenever the header, the records or what the tree hash covers change.
+#define YG_PERSISTED_LAYOUT_VERSION 1u
+
+typedef struct YGPersistedLayoutHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t nodeCount;
+  // Hash of everything the layout depends on, see YGPersistedLayoutTreeHash.
+  uint64_t treeHash;
+  // Hash of the records following the header, which catches truncated or
+  // corrupt data the tree hash can't.
+  uint64_t checksum;
+} YGPersistedLayoutHeader;
+
+// Layout of a node as persisted, one record per node in depth-first order.
+// Besides the frames it keeps the cached layout of the node, so that the next
+// pass under the same constraints is a cache hit.
+typedef struct YGPersistedNodeLayout {
+  float position[4];
+  float dimensions[2];
+  float margin[6];
+  float border[6];
+  float padding[6];
+  float measuredDimensions[2];
+  float computedFlexBasis;
+  float cachedAvailableWidth;
+  float cachedAvailableHeight;
+  float cachedComputedWidth;
+  float cachedComputedHeight;
+  int8_t cachedWidthMeasureMode;
+  int8_t cachedHeightMeasureMode;
+  uint8_t direction;
+  uint8_t lastParentDirection;
+  uint8_t hadOverflow;
+  uint8_t reserved[3];
+} YGPersistedNodeLayout;
+
+#define YG_PERSISTED_LAYOUT_HASH_SEED 0xcbf29ce484222325ull
+
+// FNV-1a. Persisted hashes must not depend on addresses, which change from
+// one run to the next.
+static uint64_t YGHashBytes(uint64_t hash, const void *const bytes,
+                            const size_t size) {
+  const uint8_t *const data = bytes;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Hashes the style, measure key and structure of the subtree of |node|, and
+// counts its nodes. Fails if a node is measured, or has a baseline, without a
+// measure key: nothing then tells its content apart from another one.
+static bool YGPersistedLayoutHashNode(const YGNodeRef node,
+                                      uint64_t *const hash,
+                                      uint32_t *const nodeCount) {
+  const uint64_t measureKey =
+      node->measureKey != NULL ? node->measureKey(node) : 0;
+  if ((node->measure != NULL || node->baseline != NULL) && measureKey == 0) {
+    return false;
+  }
+  const YGStyleEdges *const edges = &node->style.edges;
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  const uint8_t flags = (uint8_t)node->nodeType |
+                        (node->measure != NULL) << 4 |
+                        (node->baseline != NULL) << 5;
+  *hash = YGHashBytes(*hash, &node->style, offsetof(YGStyle, edges));
+  *hash = YGHashBytes(*hash, &edges->setEdges, sizeof(edges->setEdges));
+  *hash = YGHashBytes(*hash, &edges->values[YG_EDGE_VALUE_FIRST],
+                      edges->count * sizeof(YGValue));
+  *hash = YGHashBytes(*hash, &measureKey, sizeof(measureKey));
+  *hash = YGHashBytes(*hash, &flags, sizeof(flags));
+  *hash = YGHashBytes(*hash, &childCount, sizeof(childCount));
+  (*nodeCount)++;
+  for (uint32_t i = 0; i < childCount; i++) {
+    if (!YGPersistedLayoutHashNode(YGNodeListGet(&node->children, i), hash,
+                                   nodeCount)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Hashes the tree of |root|, its config and the constraints of the pass.
+static bool YGPersistedLayoutTreeHash(const YGNodeRef root,
+                                      const float parentWidth,
+                                      const float parentHeight,
+                                      const YGDirection parentDirection,
+                                      uint64_t *const hash,
+                                      uint32_t *const nodeCount) {
+  const YGConfigRef config = root->config;
+  const uint32_t constraints[3] = {
+      YGSharedMeasureConstraint(parentWidth),
+      YGSharedMeasureConstraint(parentHeight),
+      (uint32_t)parentDirection,
+  };
+  *hash = YG_PERSISTED_LAYOUT_HASH_SEED;
+  *hash = YGHashBytes(*hash, constraints, sizeof(constraints));
+  *hash = YGHashBytes(*hash, config->experimentalFeatures,
+                      sizeof(config->experimentalFeatures));
+  *hash = YGHashBytes(*hash, &config->useWebDefaults, sizeof(bool));
+  *hash = YGHashBytes(*hash, &config->useLegacyStretchBehaviour, sizeof(bool));
+  *hash = YGHashBytes(*hash, &config->pointScaleFactor, sizeof(float));
+  *nodeCount = 0;
+  return YGPersistedLayoutHashNode(root, hash, nodeCount);
+}
+
+static void YGPersistedLayoutWriteNode(const YGNodeRef node,
+                                       uint8_t **const cursor) {
+  const YGLayout *const layout = &node->layout;
+  YGPersistedNodeLayout record;
+  memset(&record, 0, sizeof(record));
+  memcpy(record.position, layout->position, sizeof(record.position));
+  memcpy(record.dimensions, layout->dimensions, sizeof(record.dimensions));
+  memcpy(record.margin, layout->margin, sizeof(record.margin));
+  memcpy(record.border, layout->border, sizeof(record.border));
+  memcpy(record.padding, layout->padding, sizeof(record.padding));
+  memcpy(record.measuredDimensions, layout->measuredDimensions,
+         sizeof(record.measuredDimensions));
+  record.computedFlexBasis = layout->computedFlexBasis;
+  record.cachedAvailableWidth = layout->cachedLayout.availableWidth;
+  record.cachedAvailableHeight = layout->cachedLayout.availableHeight;
+  record.cachedComputedWidth = layout->cachedLayout.computedWidth;
+  record.cachedComputedHeight = layout->cachedLayout.computedHeight;
+  record.cachedWidthMeasureMode = (int8_t)layout->cachedLayout.widthMeasureMode;
+  record.cachedHeightMeasureMode =
+      (int8_t)layout->cachedLayout.heightMeasureMode;
+  record.direction = (uint8_t)layout->direction;
+  record.lastParentDirection = (uint8_t)layout->lastParentDirection;
+  record.hadOverflow = layout->hadOverflow;
+  memcpy(*cursor, &record, sizeof(record));
+  *cursor += sizeof(record);
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGPersistedLayoutWriteNode(YGNodeListGet(&node->children, i), cursor);
+  }
+}
+
+static void YGPersistedLayoutReadNode(const YGNodeRef node,
+                                      const uint8_t **const cursor,
+                                      const uint32_t generationCount) {
+  YGPersistedNodeLayout record;
+  memcpy(&record, *cursor, sizeof(record));
+  *cursor += sizeof(record);
+
+  YGLayout *const layout = &node->layout;
+  memcpy(layout->position, record.position, sizeof(record.position));
+  memcpy(layout->dimensions, record.dimensions, sizeof(record.dimensions));
+  memcpy(layout->margin, record.margin, sizeof(record.margin));
+  memcpy(layout->border, record.border, sizeof(record.border));
+  memcpy(layout->padding, record.padding, sizeof(record.padding));
+  memcpy(layout->measuredDimensions, record.measuredDimensions,
+         sizeof(record.measuredDimensions));
+  layout->computedFlexBasis = record.computedFlexBasis;
+  layout->computedFlexBasisGeneration = generationCount;
+  layout->cachedLayout = (YGCachedMeasurement){
+      .availableWidth = record.cachedAvailableWidth,
+      .availableHeight = record.cachedAvailableHeight,
+      .widthMeasureMode = (YGMeasureMode)record.cachedWidthMeasureMode,
+      .heightMeasureMode = (YGMeasureMode)record.cachedHeightMeasureMode,
+      .computedWidth = record.cachedComputedWidth,
+      .computedHeight = record.cachedComputedHeight,
+  };
+  layout->direction = (YGDirection)record.direction;
+  layout->lastParentDirection = (YGDirection)record.lastParentDirection;
+  layout->hadOverflow = record.hadOverflow;
+  layout->generationCount = generationCount;
+  layout->nextCachedMeasurementsIndex = 0;
+  layout->baseline = YGUndefined;
+  node->isDirty = false;
+  node->hasNewLayout = true;
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    YGPersistedLayoutReadNode(YGNodeListGet(&node->children, i), cursor,
+                              generationCount);
+  }
+}
+
+size_t YGNodeWritePersistedLayout(const YGNodeRef root,
+                                  const float parentWidth,
+                                  const float parentHeight,
+                                  const YGDirection parentDirection,
+                                  void *const buffer, const size_t size) {
+  uint64_t treeHash;
+  uint32_t nodeCount;
+  if (root->isDirty || root->hasDirtyBoundary ||
+      root->layout.generationCount == 0 ||
+      !YGPersistedLayoutTreeHash(root, parentWidth, parentHeight,
+                                 parentDirection, &treeHash, &nodeCount)) {
+    return 0;
+  }
+  const size_t recordsSize = nodeCount * sizeof(YGPersistedNodeLayout);
+  const size_t requiredSize = sizeof(YGPersistedLayoutHeader) + recordsSize;
+  if (buffer == NULL || size < requiredSize) {
+    return requiredSize;
+  }
+
+  uint8_t *const records = (uint8_t *)buffer + sizeof(YGPersistedLayoutHeader);
+  uint8_t *cursor = records;
+  YGPersistedLayoutWriteNode(root, &cursor);
+  const YGPersistedLayoutHeader header = {
+      .magic = YG_PERSISTED_LAYOUT_MAGIC,
+      .version = YG_PERSISTED_LAYOUT_VERSION,
+      .recordSize = sizeof(YGPersistedNodeLayout),
+      .nodeCount = nodeCount,
+      .treeHash = treeHash,
+      .checksum =
+          YGHashBytes(YG_PERSISTED_LAYOUT_HASH_SEED, records, recordsSize),
+  };
+  memcpy(buffer, &header, sizeof(header));
+  return requiredSize;
+}
+
+bool YGNodeRestorePersistedLayout(const YGNodeRef root,
+                                  const float parentWidth,
+                                  const float parentHeight,
+                                  const YGDirection parentDirection,
+                                  const void *const data, const size_t size) {
+  YGPersistedLayoutHeader header;
+  if (data == NULL || size < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != YG_PERSISTED_LAYOUT_MAGIC ||
+      header.version != YG_PERSISTED_LAYOUT_VERSION ||
+      header.recordSize != sizeof(YGPersistedNodeLayout) ||
+      header.nodeCount > (size - sizeof(header)) / header.recordSize) {
+    return false;
+  }
+
+  uint64_t treeHash;
+  uint32_t nodeCount;
+  if (!YGPersistedLayoutTreeHash(root, parentWidth, parentHeight,
+                                 parentDirection, &treeHash, &nodeCount) ||
+      treeHash != header.treeHash || nodeCount != header.nodeCount) {
+    return false;
+  }
+  const uint8_t *cursor = (const uint8_t *)data + sizeof(header);
+  if (YGHashBytes(YG_PERSISTED_LAYOUT_HASH_SEED, cursor,
+                  nodeCount * sizeof(YGPersistedNodeLayout)) !=
+      header.checksum) {
+    return false;
+  }
+
+  // Stamp the nodes as if a pass had laid them out, so that they are told
+  // apart from nodes never laid out.
+  const uint32_t generationCount =
+      YG_ATOMIC_INCREMENT(&gCurrentGenerationCount);
+  YGPersistedLayoutReadNode(root, &cursor, generationCount);
+  return true;
+}
+
+YGLayoutContextRef YGLayoutContextNew(void) {
+  const YGLayoutContextRef layoutContext = gYGMalloc(sizeof(YGLayoutContext));
+  YGAssert(layoutContext != NULL,
+           "Could not allocate memory for layout context");
+
+  memset(layoutContext, 0, sizeof(YGLayoutContext));
+  return layoutContext;
+}
+
+void YGLayoutContextFree(const YGLayoutContextRef layoutContext) {
+  YGPixelGridBufferFree(&layoutContext->pixelGrid);
+  YGScratchStackFree(&layoutContext->scratch);
+  gYGFree(layoutContext);
+}
+
+void YGLayoutContextSetJournal(const YGLayoutContextRef layoutContext,
+                               const YGLayoutJournalRef journal) {
+  layoutContext->journal = journal;
+}
+
+// Layout journal
+
+YGLayoutJournalRef YGLayoutJournalNew(void) {
+  const YGLayoutJournalRef journal = gYGMalloc(sizeof(YGLayoutJournal));
+  YGAssert(journal != NULL, "Could not allocate memory for layout journal");
+  journal->nodes = NULL;
+  journal->count = 0;
+  journal->capacity = 0;
+  return journal;
+}
+
+void YGLayoutJournalFree(const YGLayoutJournalRef journal) {
+  gYGFree(journal->nodes);
+  gYGFree(journal);
+}
+
+uint32_t YGLayoutJournalGetCount(const YGLayoutJournalRef journal) {
+  return journal->count;
+}
+
+YGNodeRef YGLayoutJournalGetNode(const YGLayoutJournalRef journal,
+                                 const uint32_t index) {
+  YGAssert(index < journal->count, "Journal index out of bounds");
+  return journal->nodes[index];
+}
+
+// Frames compare exactly, and an undefined value equals another one.
+static inline bool YGFrameValueEqual(const float a, const float b) {
+  return a == b || (YGFloatIsUndefined(a) && YGFloatIsUndefined(b));
+}
+
+static void YGLayoutJournalAppend(const YGLayoutJournalRef journal,
+                                  const YGNodeRef node) {
+  if (journal->count == journal->capacity) {
+    const uint32_t capacity =
+        journal->capacity > 0 ? journal->capacity * 2 : 64;
+    YGNodeRef *const nodes =
+        gYGRealloc(journal->nodes, sizeof(YGNodeRef) * capacity);
+    YGAssert(nodes != NULL, "Could not allocate memory for layout journal");
+    journal->nodes = nodes;
+    journal->capacity = capacity;
+  }
+  journal->nodes[journal->count++] = node;
+}
 
-  node->layout.position[YGEdgeLeft] =
-      YGRoundValueToPixelGrid(nodeLeft, pointScaleFactor, false, textRounding);
-  node->layout.position[YGEdgeTop] =
-      YGRoundValueToPixelGrid(nodeTop, pointScaleFactor, false, textRounding);
-
-  // We multiply dimension by scale factor and if the result is close to the
-  // whole number, we don't have any fraction To verify if the result is close
-  // to whole number we want to check both floor and ceil numbers
-  const bool hasFractionalWidth =
-      !YGFloatsEqual(fmodf(nodeWidth * pointScaleFactor, 1.0), 0) &&
-      !YGFloatsEqual(fmodf(nodeWidth * pointScaleFactor, 1.0), 1.0);
-  const bool hasFractionalHeight =
-      !YGFloatsEqual(fmodf(nodeHeight * pointScaleFactor, 1.0), 0) &&
-      !YGFloatsEqual(fmodf(nodeHeight * pointScaleFactor, 1.0), 1.0);
-
-  node->layout.dimensions[YGDimensionWidth] =
-      YGRoundValueToPixelGrid(absoluteNodeRight, pointScaleFactor,
-                              (textRounding && hasFractionalWidth),
-                              (textRounding && !hasFractionalWidth)) -
-      YGRoundValueToPixelGrid(absoluteNodeLeft, pointScaleFactor, false,
-                              textRounding);
-  node->layout.dimensions[YGDimensionHeight] =
-      YGRoundValueToPixelGrid(absoluteNodeBottom, pointScaleFactor,
-                              (textRounding && hasFractionalHeight),
-                              (textRounding && !hasFractionalHeight)) -
-      YGRoundValueToPixelGrid(absoluteNodeTop, pointScaleFactor, false,
-                              textRounding);
-
-  const uint32_t childCount = YGNodeListCount(node->children);
+// Every node is compared, not only the ones the pass visited: passes run
+// without the journal may have moved the others, and a comparison costs far
+// less than the frame update it saves.
+static void YGLayoutJournalCollect(const YGLayoutJournalRef journal,
+                                   const YGNodeRef node) {
+  const float frame[4] = {
+      node->layout.position[YGEdgeLeft],
+      node->layout.position[YGEdgeTop],
+      node->layout.dimensions[YGDimensionWidth],
+      node->layout.dimensions[YGDimensionHeight],
+  };
+  bool changed = false;
+  for (uint32_t i = 0; i < 4; i++) {
+    if (!YGFrameValueEqual(frame[i], node->journaledFrame[i])) {
+      node->journaledFrame[i] = frame[i];
+      changed = true;
+    }
+  }
+  if (changed) {
+    YGLayoutJournalAppend(journal, node);
+  }
+
+  const uint32_t childCount = YGNodeListCount(&node->children);
   for (uint32_t i = 0; i < childCount; i++) {
-    YGRoundToPixelGrid(YGNodeGetChild(node, i), pointScaleFactor,
-                       absoluteNodeLeft, absoluteNodeTop);
+    YGLayoutJournalCollect(journal, YGNodeListGet(&node->children, i));
   }
 }
 
-void YGNodeCalculateLayout(const YGNodeRef node, const float parentWidth,
-                           const float parentHeight,
-                           const YGDirection parentDirection) {
-  // Increment the generation count. This will force the recursive routine to
-  // visit
+// Monotonic clock used to time layout passes, in nanoseconds.
+static uint64_t YGNow(void) {
+  struct timespec now;
+#ifdef _MSC_VER
+  timespec_get(&now, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+  return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static void YGLayoutContextBeginPass(YGLayoutContext *const layoutContext) {
+  // Take a fresh generation id. This will force the recursive routine to visit
   // all dirty nodes at least once. Subsequent visits will be skipped if the
-  // input
-  // parameters don't change.
-  gCurrentGenerationCount++;
+  // input parameters don't change. The id is unique across threads, so a node
+  // never mistakes a concurrent pass on another tree for its own.
+  layoutContext->generationCount =
+      YG_ATOMIC_INCREMENT(&gCurrentGenerationCount);
+  layoutContext->depth = 0;
+  memset(&layoutContext->stats, 0, sizeof(YGLayoutStats));
+}
+
+// Whether the root |node| would be placed elsewhere than in its last pass in a
+// parent of the given size.
+static bool YGNodeRootMoves(const YGNodeRef node, const float parentWidth,
+                            const float parentHeight) {
+  YGLayout *const layout = &node->layout;
+  float position[4];
+  memcpy(position, layout->position, sizeof(position));
+  YGNodeSetPosition(node, layout->direction, parentWidth, parentHeight,
+                    parentWidth);
+  const bool moves =
+      !YGFloatsEqual(layout->position[YGEdgeLeft],
+                     layout->absolutePosition[YGEdgeLeft]) ||
+      !YGFloatsEqual(layout->position[YGEdgeTop],
+                     layout->absolutePosition[YGEdgeTop]) ||
+      !YGFloatsEqual(layout->position[YGEdgeRight], position[YGEdgeRight]) ||
+      !YGFloatsEqual(layout->position[YGEdgeBottom], position[YGEdgeBottom]);
+  memcpy(layout->position, position, sizeof(position));
+  return moves;
+}
+
+// Lays out the relayout boundary |node| again at the constraints of its last
+// layout and rounds its subtree from where the node was before the last
+// rounding, so that its frames are those a pass from the root would give. A
+// node that is no longer a boundary, or whose overflow changed, dirties its
+// ancestors for the pass from the root instead.
+static void YGLayoutRelayoutBoundary(const YGNodeRef node,
+                                     YGLayoutContext *const layoutContext) {
+  YGLayout *const layout = &node->layout;
+  if (!layout->isRelayoutBoundary) {
+    YGNodeMarkAncestorsDirty(node);
+    return;
+  }
+  const bool hadOverflow = layout->hadOverflow;
+  YGLayoutNodeInternal(node, layout->cachedLayout.availableWidth,
+                       layout->cachedLayout.availableHeight,
+                       layout->lastParentDirection, YGMeasureModeExactly,
+                       YGMeasureModeExactly, YGUndefined, YGUndefined, true,
+                       "boundary", node->config, layoutContext);
+  layoutContext->stats.relayoutBoundaries++;
+  YGNodeInvalidateBaselines(node->parent);
+  if (layout->hadOverflow != hadOverflow) {
+    YGNodeMarkAncestorsDirty(node);
+    return;
+  }
+  YGRoundToPixelGrid(node, node->config->pointScaleFactor,
+                     layout->absolutePosition[YGEdgeLeft],
+                     layout->absolutePosition[YGEdgeTop],
+                     &layoutContext->pixelGrid);
+}
+
+// Lays out the dirty relayout boundaries below |node| and clears the flags
+// leading to them. A dirty child of a dirty node is left to the pass from the root.
+// So are all of them if |fromRoot| is set, their ancestors are dirtied instead.
+// The clean nodes on the way get the generation of the pass, as if it had
+// visited them, so that YGSnapshotCommit finds the boundaries.
+static void YGLayoutDirtyBoundaries(const YGNodeRef node, const bool fromRoot,
+                                    YGLayoutContext *const layoutContext) {
+  node->hasDirtyBoundary = false;
+  const uint32_t childCount = YGNodeListCount(&node->children);
+  for (uint32_t i = 0; i < childCount; i++) {
+    const YGNodeRef child = YGNodeListGet(&node->children, i);
+    if (child->isDirty && fromRoot) {
+      YGNodeMarkAncestorsDirty(child);
+    } else if (child->isDirty && !node->isDirty) {
+      YGLayoutRelayoutBoundary(child, layoutContext);
+    }
+    if (child->hasDirtyBoundary) {
+      YGLayoutDirtyBoundaries(child, fromRoot, layoutContext);
+    }
+  }
+  if (!node->isDirty) {
+    node->layout.generationCount = layoutContext->generationCount;
+    node->hasNewLayout = true;
+  }
+}
+
+YGLayoutStats YGNodeCalculateLayout(const YGNodeRef node,
+                                    const float parentWidth,
+                                    const float parentHeight,
+                                    const YGDirection parentDirection) {
+  return YGNodeCalculateLayoutWithContext(node, parentWidth, parentHeight,
+                                          parentDirection, NULL);
+}
+
+YGLayoutStats YGNodeCalculateLayoutWithContext(
+    const YGNodeRef node, const float parentWidth, const float parentHeight,
+    const YGDirection parentDirection, const YGLayoutContextRef context) {
+  const uint64_t start = YGNow();
+  YGLayoutContext localContext;
+  YGScratchInlineBlock inlineScratch;
+  if (context == NULL) {
+    memset(&localContext, 0, sizeof(YGLayoutContext));
+    YGScratchStackInit(&localContext.scratch, &inlineScratch);
+  }
+  YGLayoutContext *const layoutContext =
+      context != NULL ? context : &localContext;
+  YGLayoutContextBeginPass(layoutContext);
+
+  // The first pass over a root may be answered by a persisted layout.
+  const YGConfigRef config = node->config;
+  if (config->persistedLayout != NULL && node->layout.generationCount == 0 &&
+      YGNodeRestorePersistedLayout(node, parentWidth, parentHeight,
+                                   parentDirection, config->persistedLayout,
+                                   config->persistedLayoutSize)) {
+    if (layoutContext->journal != NULL) {
+      layoutContext->journal->count = 0;
+      YGLayoutJournalCollect(layoutContext->journal, node);
+    }
+    layoutContext->stats.time = YGNow() - start;
+    return layoutContext->stats;
+  }
+
+  // The layout cache does not look at the size of the parent, which the
+  // margins and position of the root may be relative to. A root that moves is
+  // laid out again, with the nodes above its dirty relayout boundaries, so
+  // that its subtree is rounded from where it is now.
+  const bool rootMoves = node->layout.generationCount != 0 &&
+                         YGNodeRootMoves(node, parentWidth, parentHeight);
+  if (rootMoves) {
+    node->isDirty = true;
+  }
+
+  // Relayout boundaries whose content changed are laid out on their own, the
+  // nodes above them are only laid out if something else changed. The pass
+  // from the root takes a generation of its own, as it may lay the boundaries
+  // out again at other constraints.
+  if (node->hasDirtyBoundary) {
+    YGLayoutDirtyBoundaries(node, rootMoves, layoutContext);
+    layoutContext->generationCount =
+        YG_ATOMIC_INCREMENT(&gCurrentGenerationCount);
+  }
 
   YGResolveDimensions(node);
 
@@ -3821,18 +7625,111 @@ void YGNodeCalculateLayout(const YGNodeRef node, const float parentWidth,
                                                    : YGMeasureModeExactly;
   }
 
+  const float rootWidth = node->layout.dimensions[YGDimensionWidth];
+  const float rootHeight = node->layout.dimensions[YGDimensionHeight];
   if (YGLayoutNodeInternal(node, width, height, parentDirection,
                            widthMeasureMode, heightMeasureMode, parentWidth,
-                           parentHeight, true, "initial", node->config)) {
+                           parentHeight, true, "initial", node->config,
+                           layoutContext)) {
     YGNodeSetPosition(node, node->layout.direction, parentWidth, parentHeight,
                       parentWidth);
-    YGRoundToPixelGrid(node, node->config->pointScaleFactor, 0.0f, 0.0f);
+    YGRoundToPixelGrid(node, node->config->pointScaleFactor,
+                       node->layout.position[YGEdgeLeft],
+                       node->layout.position[YGEdgeTop],
+                       &layoutContext->pixelGrid);
 
     if (gPrintTree) {
       YGNodePrint(node, YGPrintOptionsLayout | YGPrintOptionsChildren |
                             YGPrintOptionsStyle);
     }
+  } else {
+    // A root answered by its layout cache keeps the frame it was rounded to,
+    // as nothing below it is rounded again.
+    node->layout.dimensions[YGDimensionWidth] = rootWidth;
+    node->layout.dimensions[YGDimensionHeight] = rootHeight;
+  }
+
+  if (layoutContext->journal != NULL) {
+    layoutContext->journal->count = 0;
+    YGLayoutJournalCollect(layoutContext->journal, node);
+  }
+  if (context == NULL) {
+    YGPixelGridBufferFree(&localContext.pixelGrid);
+    YGScratchStackFree(&localContext.scratch);
   }
+  layoutContext->stats.time = YGNow() - start;
+  return layoutContext->stats;
+}
+
+// Roots are laid out in chunks sharing a context, so that the pixel grid buffer
+// is allocated once per chunk rather than once per root.
+#define YG_LAYOUT_BATCH_CHUNK_SIZE 16
+
+typedef struct YGLayoutBatch {
+  const YGNodeRef *roots;
+  const YGLayoutConstraints *constraints;
+  YGSize *sizes;
+  uint32_t count;
+  // Counters of every chunk, summed in order once the batch is done.
+  YGLayoutStats *chunkStats;
+} YGLayoutBatch;
+
+static void YGLayoutBatchLayoutChunk(void *userData, const uint32_t chunk) {
+  const YGLayoutBatch *const batch = userData;
+  YGLayoutStats *const stats = &batch->chunkStats[chunk];
+  memset(stats, 0, sizeof(YGLayoutStats));
+  YGLayoutContext layoutContext;
+  memset(&layoutContext, 0, sizeof(YGLayoutContext));
+
+  const uint32_t begin = chunk * YG_LAYOUT_BATCH_CHUNK_SIZE;
+  const uint32_t end = batch->count - begin > YG_LAYOUT_BATCH_CHUNK_SIZE
+                           ? begin + YG_LAYOUT_BATCH_CHUNK_SIZE
+                           : batch->count;
+  for (uint32_t i = begin; i < end; i++) {
+    const YGNodeRef root = batch->roots[i];
+    const YGLayoutConstraints *const constraints = &batch->constraints[i];
+    const YGLayoutStats rootStats = YGNodeCalculateLayoutWithContext(
+        root, constraints->availableWidth, constraints->availableHeight,
+        constraints->direction, &layoutContext);
+    YGLayoutStatsAdd(stats, &rootStats);
+    batch->sizes[i] = (YGSize){
+        .width = root->layout.dimensions[YGDimensionWidth],
+        .height = root->layout.dimensions[YGDimensionHeight],
+    };
+  }
+  YGPixelGridBufferFree(&layoutContext.pixelGrid);
+  YGScratchStackFree(&layoutContext.scratch);
+}
+
+YGLayoutStats YGNodeCalculateLayoutBatch(const YGNodeRef *roots,
+                                         const YGLayoutConstraints *constraints,
+                                         YGSize *sizes, const uint32_t count) {
+  const uint64_t start = YGNow();
+  YGLayoutStats stats;
+  memset(&stats, 0, sizeof(YGLayoutStats));
+  if (count == 0) {
+    return stats;
+  }
+
+  const uint32_t chunkCount =
+      (count + YG_LAYOUT_BATCH_CHUNK_SIZE - 1) / YG_LAYOUT_BATCH_CHUNK_SIZE;
+  YGLayoutBatch batch = {
+      .roots = roots,
+      .constraints = constraints,
+      .sizes = sizes,
+      .count = count,
+      .chunkStats = gYGMalloc(sizeof(YGLayoutStats) * chunkCount),
+  };
+  YGAssert(batch.chunkStats != NULL,
+           "Could not allocate memory for batch layout");
+  YGParallelFor(chunkCount, 1, YGLayoutBatchLayoutChunk, &batch);
+
+  for (uint32_t i = 0; i < chunkCount; i++) {
+    YGLayoutStatsAdd(&stats, &batch.chunkStats[i]);
+  }
+  gYGFree(batch.chunkStats);
+  stats.time = YGNow() - start;
+  return stats;
 }
 
 void YGConfigSetLogger(const YGConfigRef config, YGLogger logger) {
@@ -3916,6 +7813,147 @@ bool YGConfigGetUseWebDefaults(const YGConfigRef config) {
   return config->useWebDefaults;
 }
 
+void YGConfigSetParallelLayoutEnabled(const YGConfigRef config,
+                                      const bool enabled) {
+  config->parallelLayout = enabled;
+}
+
+bool YGConfigIsParallelLayoutEnabled(const YGConfigRef config) {
+  return config->parallelLayout;
+}
+
+void YGConfigSetParallelLayoutGrainSize(const YGConfigRef config,
+                                        const uint32_t grainSize) {
+  YGAssertWithConfig(config, grainSize > 0,
+                     "Parallel layout grain size must be at least 1");
+  config->parallelLayoutGrainSize = grainSize;
+}
+
+void YGConfigSetMeasurementCacheCapacity(const YGConfigRef config,
+                                         const uint32_t leafCapacity,
+                                         const uint32_t containerCapacity) {
+  YGAssertWithConfig(config,
+                     leafCapacity <= YG_MAX_CACHED_RESULT_COUNT &&
+                         containerCapacity <= YG_MAX_CACHED_RESULT_COUNT,
+                     "Measurement cache capacity must be at most 256");
+  config->leafMeasurementCacheCapacity = leafCapacity;
+  config->containerMeasurementCacheCapacity = containerCapacity;
+}
+
+void YGConfigSetMeasurementCacheEviction(const YGConfigRef config,
+                                         const YGCacheEviction eviction) {
+  config->measurementCacheEviction = eviction;
+}
+
+YGCacheEviction YGConfigGetMeasurementCacheEviction(const YGConfigRef config) {
+  return config->measurementCacheEviction;
+}
+
+void YGConfigSetPersistedLayout(const YGConfigRef config, const void *data,
+                                const size_t size) {
+  config->persistedLayout = data;
+  config->persistedLayoutSize = size;
+}
+
+void YGConfigSetTraceFunc(const YGConfigRef config, YGTraceFunc traceFunc,
+                          void *context) {
+  config->traceFunc = traceFunc;
+  config->traceContext = context;
+}
+
+// Chrome trace writer
+
+typedef struct YGChromeTraceWriter {
+  FILE *file;
+  // Timestamps are written relative to the creation of the writer.
+  uint64_t start;
+  bool hasEvents;
+#ifdef YG_PARALLEL_LAYOUT
+  pthread_mutex_t lock;
+#endif
+} YGChromeTraceWriter;
+
+#ifdef YG_PARALLEL_LAYOUT
+static uint32_t gYGChromeTraceThreadCount = 0;
+static __thread uint32_t gYGChromeTraceThreadId = 0;
+
+// Numbers the threads in the order they first trace, so each gets a track.
+static uint32_t YGChromeTraceThreadId(void) {
+  if (gYGChromeTraceThreadId == 0) {
+    gYGChromeTraceThreadId = YG_ATOMIC_INCREMENT(&gYGChromeTraceThreadCount);
+  }
+  return gYGChromeTraceThreadId;
+}
+#else
+static uint32_t YGChromeTraceThreadId(void) { return 1; }
+#endif
+
+YGChromeTraceWriterRef YGChromeTraceWriterNew(FILE *file) {
+  const YGChromeTraceWriterRef writer = gYGMalloc(sizeof(YGChromeTraceWriter));
+  YGAssert(writer != NULL, "Could not allocate memory for trace writer");
+  writer->file = file;
+  writer->start = YGNow();
+  writer->hasEvents = false;
+#ifdef YG_PARALLEL_LAYOUT
+  pthread_mutex_init(&writer->lock, NULL);
+#endif
+  fprintf(file, "{\"traceEvents\":[");
+  return writer;
+}
+
+void YGChromeTraceWriterFree(const YGChromeTraceWriterRef writer) {
+  fprintf(writer->file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+  fflush(writer->file);
+#ifdef YG_PARALLEL_LAYOUT
+  pthread_mutex_destroy(&writer->lock);
+#endif
+  gYGFree(writer);
+}
+
+// JSON has no NaN, undefined sizes are written as null.
+static void YGChromeTraceWriteFloat(FILE *const file, const char *const key,
+                                    const float value) {
+  if (isfinite(value)) {
+    fprintf(file, ",\"%s\":%g", key, value);
+  } else {
+    fprintf(file, ",\"%s\":null", key);
+  }
+}
+
+void YGChromeTraceWriterTrace(const YGTraceEvent *event, void *context) {
+  const YGChromeTraceWriterRef writer = context;
+  const uint32_t thread = YGChromeTraceThreadId();
+  const double timestamp = (double)(event->time - writer->start) / 1000.0;
+#ifdef YG_PARALLEL_LAYOUT
+  pthread_mutex_lock(&writer->lock);
+#endif
+  FILE *const file = writer->file;
+  fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"yoga\",\"ph\":\"%s\",",
+          writer->hasEvents ? "," : "", event->reason, event->end ? "E" : "B");
+  fprintf(file, "\"ts\":%.3f,\"pid\":1,\"tid\":%u,", timestamp, thread);
+  fprintf(file, "\"args\":{\"node\":\"%p\",\"depth\":%u", (void *)event->node,
+          event->depth);
+  if (event->end) {
+    fprintf(file, ",\"cache\":\"%s\"",
+            YGCacheOutcomeToString(event->cacheOutcome));
+    YGChromeTraceWriteFloat(file, "measuredWidth", event->measuredWidth);
+    YGChromeTraceWriteFloat(file, "measuredHeight", event->measuredHeight);
+  } else {
+    fprintf(file, ",\"performLayout\":%s",
+            event->performLayout ? "true" : "false");
+    YGChromeTraceWriteFloat(file, "availableWidth", event->availableWidth);
+    YGChromeTraceWriteFloat(file, "availableHeight", event->availableHeight);
+    fprintf(file, ",\"widthMode\":\"%s\",\"heightMode\":\"%s\"",
+            YGMeasureModeToString(event->widthMeasureMode),
+            YGMeasureModeToString(event->heightMeasureMode));
+  }
+  fprintf(file, "}}");
+  writer->hasEvents = true;
+#ifdef YG_PARALLEL_LAYOUT
+  pthread_mutex_unlock(&writer->lock);
+#endif
+}
+
 void YGConfigSetContext(const YGConfigRef config, void *context) {
   config->context = context;
 }
@@ -3976,6 +8014,28 @@ const char *YGAlignToString(const YGAlign value) {
   return "unknown";
 }
 
+const char *YGCacheEvictionToString(const YGCacheEviction value) {
+  switch (value) {
+    case YGCacheEvictionRoundRobin:
+      return "round-robin";
+    case YGCacheEvictionLeastRecentlyUsed:
+      return "least-recently-used";
+  }
+  return "unknown";
+}
+
+const char *YGCacheOutcomeToString(const YGCacheOutcome value) {
+  switch (value) {
+    case YGCacheOutcomeMiss:
+      return "miss";
+    case YGCacheOutcomeLayoutCache:
+      return "layout-cache";
+    case YGCacheOutcomeMeasurementCache:
+      return "measurement-cache";
+  }
+  return "unknown";
+}
+
 const char *YGDimensionToString(const YGDimension value) {
   switch (value) {
     case YGDimensionWidth:
@@ -4036,6 +8096,8 @@ const char *YGExperimentalFeatureToString(const YGExperimentalFeature value) {
   switch (value) {
     case YGExperimentalFeatureWebFlexBasis:
       return "web-flex-basis";
+    case YGExperimentalFeatureSpecFlexibleLengths:
+      return "spec-flexible-lengths";
   }
   return "unknown";
 }
@@ -4169,128 +8231,3 @@ const char *YGWrapToString(const YGWrap value) {
   }
   return "unknown";
 }
-
-// YGNodeList
-
-#include <string.h>
-
-extern YGMalloc gYGMalloc;
-extern YGRealloc gYGRealloc;
-extern YGFree gYGFree;
-
-struct YGNodeList {
-  uint32_t capacity;
-  uint32_t count;
-  YGNodeRef *items;
-};
-
-YGNodeListRef YGNodeListNew(const uint32_t initialCapacity) {
-  const YGNodeListRef list = gYGMalloc(sizeof(struct YGNodeList));
-  YGAssert(list != NULL, "Could not allocate memory for list");
-
-  list->capacity = initialCapacity;
-  list->count = 0;
-  list->items = gYGMalloc(sizeof(YGNodeRef) * list->capacity);
-  YGAssert(list->items != NULL, "Could not allocate memory for items");
-
-  return list;
-}
-
-void YGNodeListFree(const YGNodeListRef list) {
-  if (list) {
-    gYGFree(list->items);
-    gYGFree(list);
-  }
-}
-
-uint32_t YGNodeListCount(const YGNodeListRef list) {
-  if (list) {
-    return list->count;
-  }
-  return 0;
-}
-
-void YGNodeListAdd(YGNodeListRef *listp, const YGNodeRef node) {
-  if (!*listp) {
-    *listp = YGNodeListNew(4);
-  }
-  YGNodeListInsert(listp, node, (*listp)->count);
-}
-
-void YGNodeListInsert(YGNodeListRef *listp, const YGNodeRef node,
-                      const uint32_t index) {
-  if (!*listp) {
-    *listp = YGNodeListNew(4);
-  }
-  YGNodeListRef list = *listp;
-
-  if (list->count == list->capacity) {
-    list->capacity *= 2;
-    list->items = gYGRealloc(list->items, sizeof(YGNodeRef) * list->capacity);
-    YGAssert(list->items != NULL, "Could not extend allocation for items");
-  }
-
-  for (uint32_t i = list->count; i > index; i--) {
-    list->items[i] = list->items[i - 1];
-  }
-
-  list->count++;
-  list->items[index] = node;
-}
-
-void YGNodeListReplace(YGNodeListRef list, const uint32_t index,
-                       const YGNodeRef newNode) {
-  list->items[index] = newNode;
-}
-
-void YGNodeListRemoveAll(const YGNodeListRef list) {
-  for (uint32_t i = 0; i < list->count; i++) {
-    list->items[i] = NULL;
-  }
-  list->count = 0;
-}
-
-YGNodeRef YGNodeListRemove(const YGNodeListRef list, const uint32_t index) {
-  const YGNodeRef removed = list->items[index];
-  list->items[index] = NULL;
-
-  for (uint32_t i = index; i < list->count - 1; i++) {
-    list->items[i] = list->items[i + 1];
-    list->items[i + 1] = NULL;
-  }
-
-  list->count--;
-  return removed;
-}
-
-YGNodeRef YGNodeListDelete(const YGNodeListRef list, const YGNodeRef node) {
-  for (uint32_t i = 0; i < list->count; i++) {
-    if (list->items[i] == node) {
-      return YGNodeListRemove(list, i);
-    }
-  }
-
-  return NULL;
-}
-
-YGNodeRef YGNodeListGet(const YGNodeListRef list, const uint32_t index) {
-  if (YGNodeListCount(list) > 0) {
-    return list->items[index];
-  }
-
-  return NULL;
-}
-
-YGNodeListRef YGNodeListClone(const YGNodeListRef oldList) {
-  if (!oldList) {
-    return NULL;
-  }
-  const uint32_t count = oldList->count;
-  if (count == 0) {
-    return NULL;
-  }
-  const YGNodeListRef newList = YGNodeListNew(count);
-  memcpy(newList->items, oldList->items, sizeof(YGNodeRef) * count);
-  newList->count = count;
-  return newList;
-}
@@ -57,6 +57,21 @@ typedef YG_ENUM_BEGIN(YGAlign){
 } YG_ENUM_END(YGAlign);
 WIN_EXPORT const char *YGAlignToString(const YGAlign value);
 
+#define YGCacheEvictionCount 2
+typedef YG_ENUM_BEGIN(YGCacheEviction){
+    YGCacheEvictionRoundRobin,
+    YGCacheEvictionLeastRecentlyUsed,
+} YG_ENUM_END(YGCacheEviction);
+WIN_EXPORT const char *YGCacheEvictionToString(const YGCacheEviction value);
+
+#define YGCacheOutcomeCount 3
+typedef YG_ENUM_BEGIN(YGCacheOutcome){
+    YGCacheOutcomeMiss,
+    YGCacheOutcomeLayoutCache,
+    YGCacheOutcomeMeasurementCache,
+} YG_ENUM_END(YGCacheOutcome);
+WIN_EXPORT const char *YGCacheOutcomeToString(const YGCacheOutcome value);
+
 #define YGDimensionCount 2
 typedef YG_ENUM_BEGIN(YGDimension){
     YGDimensionWidth,
@@ -86,9 +101,10 @@ typedef YG_ENUM_BEGIN(YGEdge){
 } YG_ENUM_END(YGEdge);
 WIN_EXPORT const char *YGEdgeToString(const YGEdge value);
 
-#define YGExperimentalFeatureCount 1
+#define YGExperimentalFeatureCount 2
 typedef YG_ENUM_BEGIN(YGExperimentalFeature){
     YGExperimentalFeatureWebFlexBasis,
+    YGExperimentalFeatureSpecFlexibleLengths,
 } YG_ENUM_END(YGExperimentalFeature);
 WIN_EXPORT const char *YGExperimentalFeatureToString(const YGExperimentalFeature value);
 
@@ -212,9 +228,14 @@ static const YGValue YGValueAuto = {YGUndefined, YGUnitAuto};
 
 typedef struct YGConfig *YGConfigRef;
 typedef struct YGNode *YGNodeRef;
+typedef struct YGLayoutContext *YGLayoutContextRef;
+typedef struct YGArena *YGArenaRef;
+typedef struct YGSnapshot *YGSnapshotRef;
+typedef struct YGLayoutJournal *YGLayoutJournalRef;
 typedef YGSize (*YGMeasureFunc)(YGNodeRef node, float width, YGMeasureMode widthMode, float height,
                                 YGMeasureMode heightMode);
 typedef float (*YGBaselineFunc)(YGNodeRef node, const float width, const float height);
+typedef uint64_t (*YGMeasureKeyFunc)(YGNodeRef node);
 typedef void (*YGPrintFunc)(YGNodeRef node);
 typedef int (*YGLogger)(const YGConfigRef config, const YGNodeRef node, YGLogLevel level,
                         const char *format, va_list args);
@@ -235,6 +256,34 @@ WIN_EXPORT void YGNodeFreeRecursive(const YGNodeRef node);
 WIN_EXPORT void YGNodeReset(const YGNodeRef node);
 WIN_EXPORT int32_t YGNodeGetInstanceCount(void);
 
+// YGArena
+// Allocates nodes and their child lists contiguously, in creation order (depth-first when a tree
+// is built top-down), and releases all of them at once. YGNodeFree on an arena node detaches it
+// but keeps its memory until YGArenaFree, after which every node of the arena is invalid. An arena
+// is not thread safe; nodeCapacity is a hint for the size of its blocks.
+WIN_EXPORT YGArenaRef YGArenaNew(const uint32_t nodeCapacity);
+WIN_EXPORT void YGArenaFree(const YGArenaRef arena);
+WIN_EXPORT YGNodeRef YGNodeNewInArena(const YGArenaRef arena, const YGConfigRef config);
+
+// YGSnapshot
+// Lets a tree be laid out on another thread while it keeps being edited. YGSnapshotCapture freezes
+// the state of the tree into a version that may be laid out with YGNodeCalculateLayout on any
+// thread, and YGSnapshotCommit copies the frames of that version back into the tree in one go.
+// Versions are copy-on-write: a capture clones the nodes edited since the previous capture and
+// the spine above them, and shares every other node with the previous version, which it frees.
+// Only the first capture clones the whole tree.
+//
+// Capture, commit and edit the tree on one thread, and never capture or commit while a version is
+// being laid out. Measure and baseline functions are called on the thread that lays the version
+// out, with the context the node had when it was last edited. A snapshotted tree must only be laid
+// out through its snapshot. Nodes edited after a capture are committed the frames of the captured
+// state and stay dirty until the next capture. YGSnapshotFree marks the edits that were captured
+// but not committed dirty again.
+WIN_EXPORT YGSnapshotRef YGSnapshotNew(const YGNodeRef root);
+WIN_EXPORT void YGSnapshotFree(const YGSnapshotRef snapshot);
+WIN_EXPORT YGNodeRef YGSnapshotCapture(const YGSnapshotRef snapshot);
+WIN_EXPORT void YGSnapshotCommit(const YGSnapshotRef snapshot);
+
 WIN_EXPORT void YGNodeInsertChild(const YGNodeRef node, const YGNodeRef child,
                                   const uint32_t index);
 WIN_EXPORT void YGNodeRemoveChild(const YGNodeRef node, const YGNodeRef child);
@@ -243,9 +292,114 @@ WIN_EXPORT YGNodeRef YGNodeGetChild(const YGNodeRef node, const uint32_t index);
 WIN_EXPORT YGNodeRef YGNodeGetParent(const YGNodeRef node);
 WIN_EXPORT uint32_t YGNodeGetChildCount(const YGNodeRef node);
 
-WIN_EXPORT void YGNodeCalculateLayout(const YGNodeRef node, const float availableWidth,
-                                      const float availableHeight,
-                                      const YGDirection parentDirection);
+// Counters of a single layout pass. Nodes visited counts every request to lay out or measure a
+// node, including the ones answered by its layout or measurement cache; measure calls only count
+// the measure functions actually run. A container whose children are identical leaves with a fixed
+// size, such as a photo grid, only asks for the layout of its first child and gives it to the
+// others, which are not visited. Stretch layouts avoided counts the children aligned with stretch
+// that were laid out at their stretched cross size right away, instead of being measured first and
+// laid out again. Relayout boundaries counts the nodes with a fixed size that were laid out on
+// their own because only their content changed, see YGNodeIsDirty. Time is the duration of the
+// whole pass, in nanoseconds.
+typedef struct YGLayoutStats {
+  uint32_t nodesVisited;
+  uint32_t layoutCacheHits;
+  uint32_t measurementCacheHits;
+  uint32_t measureCalls;
+  uint32_t stretchLayoutsAvoided;
+  uint32_t relayoutBoundaries;
+  uint32_t maxDepth;
+  uint64_t time;
+} YGLayoutStats;
+
+WIN_EXPORT YGLayoutStats YGNodeCalculateLayout(const YGNodeRef node, const float availableWidth,
+                                               const float availableHeight,
+                                               const YGDirection parentDirection);
+
+// Layout passes are re-entrant: every pass keeps its generation and depth in a
+// YGLayoutContext instead of process-wide globals, so unrelated trees can be
+// laid out concurrently on different threads. A context must not be shared by
+// two passes running at the same time, and the trees must not share nodes.
+// Passing NULL uses a context private to the call, which is what
+// YGNodeCalculateLayout does.
+WIN_EXPORT YGLayoutContextRef YGLayoutContextNew(void);
+WIN_EXPORT void YGLayoutContextFree(const YGLayoutContextRef context);
+WIN_EXPORT YGLayoutStats YGNodeCalculateLayoutWithContext(const YGNodeRef node,
+                                                          const float availableWidth,
+                                                          const float availableHeight,
+                                                          const YGDirection parentDirection,
+                                                          const YGLayoutContextRef context);
+
+// Layout journal
+// Lists the nodes whose frame (left, top, width and height) differs at the end of a pass from
+// what it was at the end of the previous pass run with a journal, so that only their frames need
+// to be applied or animated. Nodes are listed parent first, and a node new to the tree is listed
+// the first time. Attach a journal to the context of the passes to track: each pass run with the
+// context starts it over. Passes run without a journal in between are not lost, their changes are
+// reported by the next journaled pass. Filling the journal costs a comparison per node of the tree.
+WIN_EXPORT YGLayoutJournalRef YGLayoutJournalNew(void);
+WIN_EXPORT void YGLayoutJournalFree(const YGLayoutJournalRef journal);
+WIN_EXPORT uint32_t YGLayoutJournalGetCount(const YGLayoutJournalRef journal);
+WIN_EXPORT YGNodeRef YGLayoutJournalGetNode(const YGLayoutJournalRef journal,
+                                            const uint32_t index);
+WIN_EXPORT void YGLayoutContextSetJournal(const YGLayoutContextRef context,
+                                          const YGLayoutJournalRef journal);
+
+// Lays out |count| independent roots in one call, spread over the worker threads of the parallel
+// layout pool, and writes the size of every root to |sizes|, in order. Each root is laid out as by
+// YGNodeCalculateLayout with its own constraints. The roots must not share nodes, and their
+// measure, baseline and trace functions are called from worker threads, so they must be thread
+// safe. Returns the counters of all the passes summed, and the duration of the whole batch.
+typedef struct YGLayoutConstraints {
+  float availableWidth;
+  float availableHeight;
+  YGDirection direction;
+} YGLayoutConstraints;
+
+WIN_EXPORT YGLayoutStats YGNodeCalculateLayoutBatch(const YGNodeRef *roots,
+                                                    const YGLayoutConstraints *constraints,
+                                                    YGSize *sizes, const uint32_t count);
+
+// Tracing
+// A trace function set on a config is called when each request of a pass to lay out or measure
+// one of its nodes begins and when it ends, including the requests answered by a cache. Requests
+// nest like the calls making them: the ones made while a node is laid out end before it does. The
+// end event repeats the arguments of the begin event and adds the cache outcome and the measured
+// size. Time is read from a monotonic clock, in nanoseconds. Reason names what asked for the
+// request, e.g. "measure", "stretch", "flex" or "abs-layout", and is a static string. With parallel
+// layout the function is called from the worker threads too, each seeing its requests properly
+// nested. A config without a trace function costs a single test per request.
+typedef struct YGTraceEvent {
+  bool end;
+  YGNodeRef node;
+  const char *reason;
+  uint32_t depth;
+  bool performLayout;
+  float availableWidth;
+  float availableHeight;
+  YGMeasureMode widthMeasureMode;
+  YGMeasureMode heightMeasureMode;
+  YGCacheOutcome cacheOutcome;
+  float measuredWidth;
+  float measuredHeight;
+  uint64_t time;
+} YGTraceEvent;
+
+typedef void (*YGTraceFunc)(const YGTraceEvent *event, void *context);
+
+WIN_EXPORT void YGConfigSetTraceFunc(const YGConfigRef config, YGTraceFunc traceFunc,
+                                     void *context);
+
+// Writes trace events to |file| as Chrome trace JSON, which chrome://tracing, Perfetto and other
+// trace viewers open. Every request becomes a slice named after its reason, with the node,
+// constraints, cache outcome and size as arguments, on a track per thread. Trace a pass with
+// YGConfigSetTraceFunc(config, YGChromeTraceWriterTrace, writer). The writer is thread safe;
+// YGChromeTraceWriterFree completes the JSON and leaves the file open.
+typedef struct YGChromeTraceWriter *YGChromeTraceWriterRef;
+
+WIN_EXPORT YGChromeTraceWriterRef YGChromeTraceWriterNew(FILE *file);
+WIN_EXPORT void YGChromeTraceWriterFree(const YGChromeTraceWriterRef writer);
+WIN_EXPORT void YGChromeTraceWriterTrace(const YGTraceEvent *event, void *writer);
 
 // Mark a node as dirty. Only valid for nodes with a custom measure function
 // set.
@@ -254,6 +408,11 @@ WIN_EXPORT void YGNodeCalculateLayout(const YGNodeRef node, const float availabl
 // depends on information not known to YG they must perform this dirty
 // marking manually.
 WIN_EXPORT void YGNodeMarkDirty(const YGNodeRef node);
+// A node is dirty when it must be laid out again. Edits dirty every ancestor of the edited node up
+// to a relayout boundary: a node laid out at an exact width and height set in points, without
+// percentage edges or bounds, whose baseline no ancestor reads. Such a node keeps its size whatever
+// its content, so its ancestors stay clean and the next layout pass only lays out its subtree, at
+// the constraints of its last layout. Changing the style of a boundary still dirties its ancestors.
 WIN_EXPORT bool YGNodeIsDirty(const YGNodeRef node);
 
 WIN_EXPORT void YGNodePrint(const YGNodeRef node, const YGPrintOptions options);
@@ -271,6 +430,13 @@ WIN_EXPORT bool YGNodeCanUseCachedMeasurement(const YGMeasureMode widthMode, con
 
 WIN_EXPORT void YGNodeCopyStyle(const YGNodeRef dstNode, const YGNodeRef srcNode);
 
+// Groups style changes. Between the two calls the style setters only write their value; the end
+// call compares the whole style with the one at the beginning and marks the node dirty once, only
+// if it differs, so a value changed and then set back leaves the layout untouched. Updates nest;
+// the outermost end call returns whether the node was marked dirty.
+WIN_EXPORT void YGNodeStyleBeginUpdate(const YGNodeRef node);
+WIN_EXPORT bool YGNodeStyleEndUpdate(const YGNodeRef node);
+
 #define YG_NODE_PROPERTY(type, name, paramName)                          \
   WIN_EXPORT void YGNodeSet##name(const YGNodeRef node, type paramName); \
   WIN_EXPORT type YGNodeGet##name(const YGNodeRef node);
@@ -311,6 +477,7 @@ WIN_EXPORT void YGNodeCopyStyle(const YGNodeRef dstNode, const YGNodeRef srcNode
 
 YG_NODE_PROPERTY(void *, Context, context);
 YG_NODE_PROPERTY(YGMeasureFunc, MeasureFunc, measureFunc);
+YG_NODE_PROPERTY(YGMeasureKeyFunc, MeasureKeyFunc, measureKeyFunc);
 YG_NODE_PROPERTY(YGBaselineFunc, BaselineFunc, baselineFunc)
 YG_NODE_PROPERTY(YGPrintFunc, PrintFunc, printFunc);
 YG_NODE_PROPERTY(bool, HasNewLayout, hasNewLayout);
@@ -416,9 +583,62 @@ WIN_EXPORT bool YGConfigIsExperimentalFeatureEnabled(const YGConfigRef config,
 WIN_EXPORT void YGConfigSetUseWebDefaults(const YGConfigRef config, const bool enabled);
 WIN_EXPORT bool YGConfigGetUseWebDefaults(const YGConfigRef config);
 
+// Lets wide containers (more children than the grain size, 16 by default) measure and lay out
+// their children on a process-wide work-stealing thread pool. The result is identical to the
+// serial layout. Measure and baseline functions are then called from worker threads and must be
+// thread safe. Ignored when a node cloned callback is set.
+WIN_EXPORT void YGConfigSetParallelLayoutEnabled(const YGConfigRef config, const bool enabled);
+WIN_EXPORT bool YGConfigIsParallelLayoutEnabled(const YGConfigRef config);
+WIN_EXPORT void YGConfigSetParallelLayoutGrainSize(const YGConfigRef config,
+                                                   const uint32_t grainSize);
+
+// Every node remembers the sizes it was measured at under the constraints of the last passes, 16
+// of them by default. Nodes with a measure function use the leaf capacity, the others the
+// container capacity; 0 disables the cache and the maximum is 256. Once full, round robin starts
+// over from the first entry and forgets the others, least recently used replaces the entry that
+// went unused the longest, which suits windows resized back and forth. Larger caches call measure
+// functions less often but take longer to search on a miss. The default policy lays out exactly
+// as before; like any change to what is cached, the others may resolve a few edge cases, such as
+// measure functions that are not monotonic, differently.
+WIN_EXPORT void YGConfigSetMeasurementCacheCapacity(const YGConfigRef config,
+                                                    const uint32_t leafCapacity,
+                                                    const uint32_t containerCapacity);
+WIN_EXPORT void YGConfigSetMeasurementCacheEviction(const YGConfigRef config,
+                                                    const YGCacheEviction eviction);
+WIN_EXPORT YGCacheEviction YGConfigGetMeasurementCacheEviction(const YGConfigRef config);
+
 WIN_EXPORT void YGConfigSetNodeClonedFunc(const YGConfigRef config,
                                           const YGNodeClonedFunc callback);
 
+// Persisted layouts
+// Saves the layout of a tree so that a later run, e.g. the next cold start, can restore it instead
+// of laying the tree out again. The data has a fixed binary layout, is read in place and needs no
+// alignment, so it can be memory mapped straight from a file. It is keyed by a hash of the
+// structure and style of the tree, the measure keys of its nodes, the config and the constraints
+// of the pass: every node with a measure or baseline function needs a measure key function, with
+// keys stable from one run to the next, or the tree cannot be persisted.
+//
+// YGNodeWritePersistedLayout takes the arguments of the YGNodeCalculateLayout call that laid the
+// tree out. It returns the size of the data, written only if it fits in |buffer|, or 0 if the tree
+// is dirty or cannot be persisted. YGNodeRestorePersistedLayout gives the tree the persisted
+// layout, as if laid out with the same arguments, and marks it clean. It returns false and leaves
+// the tree untouched if the data is truncated, corrupt, of another version of the format, or was
+// written for a tree or constraints that differ in anything the hash covers.
+WIN_EXPORT size_t YGNodeWritePersistedLayout(const YGNodeRef root, const float parentWidth,
+                                             const float parentHeight,
+                                             const YGDirection parentDirection, void *buffer,
+                                             const size_t size);
+WIN_EXPORT bool YGNodeRestorePersistedLayout(const YGNodeRef root, const float parentWidth,
+                                             const float parentHeight,
+                                             const YGDirection parentDirection, const void *data,
+                                             const size_t size);
+
+// Lets the first YGNodeCalculateLayout call on any root using |config| restore the layout from
+// |data| when it matches, instead of laying the tree out. The data must stay valid while set; pass
+// NULL to stop.
+WIN_EXPORT void YGConfigSetPersistedLayout(const YGConfigRef config, const void *data,
+                                           const size_t size);
+
 // Export only for C#
 WIN_EXPORT YGConfigRef YGConfigGetDefault(void);
 
@@ -428,34 +648,33 @@ WIN_EXPORT void *YGConfigGetContext(const YGConfigRef config);
 WIN_EXPORT void YGSetMemoryFuncs(YGMalloc ygmalloc, YGCalloc yccalloc, YGRealloc ygrealloc,
                                  YGFree ygfree);
 
+// Shared measurement cache
+// A node with a measure key function reports a hash of the content it measures, e.g. its text and
+// font. Nodes reporting the same non-zero key under the same measure function and constraints
+// share a single measurement, kept in a process-wide cache bounded to |capacity| entries (1024 by
+// default) and evicted least recently used first. Return 0 to measure the node as usual. Keys
+// must change whenever the measured content does. Setting the capacity or clearing the cache must
+// not race with a layout pass.
+typedef struct YGMeasureCacheStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint32_t count;
+  uint32_t capacity;
+} YGMeasureCacheStats;
+
+WIN_EXPORT void YGSharedMeasureCacheSetCapacity(const uint32_t capacity);
+WIN_EXPORT void YGSharedMeasureCacheClear(void);
+WIN_EXPORT YGMeasureCacheStats YGSharedMeasureCacheGetStats(void);
+
 WIN_EXPORT float YGRoundValueToPixelGrid(const float value, const float pointScaleFactor,
                                          const bool forceCeil, const bool forceFloor);
 
-YG_EXTERN_C_END
-
-#pragma once
-
-#include <assert.h>
-#include <stdint.h>
-#include <stdio.h>
-#include <stdlib.h>
-
-#include "Yoga.h"
-
-YG_EXTERN_C_BEGIN
-
-typedef struct YGNodeList *YGNodeListRef;
-
-YGNodeListRef YGNodeListNew(const uint32_t initialCapacity);
-void YGNodeListFree(const YGNodeListRef list);
-uint32_t YGNodeListCount(const YGNodeListRef list);
-void YGNodeListAdd(YGNodeListRef *listp, const YGNodeRef node);
-void YGNodeListInsert(YGNodeListRef *listp, const YGNodeRef node, const uint32_t index);
-void YGNodeListReplace(const YGNodeListRef list, const uint32_t index, const YGNodeRef newNode);
-void YGNodeListRemoveAll(const YGNodeListRef list);
-YGNodeRef YGNodeListRemove(const YGNodeListRef list, const uint32_t index);
-YGNodeRef YGNodeListDelete(const YGNodeListRef list, const YGNodeRef node);
-YGNodeRef YGNodeListGet(const YGNodeListRef list, const uint32_t index);
-YGNodeListRef YGNodeListClone(YGNodeListRef list);
+// Rounds |count| values in place, vectorised where SSE2 or NEON is available. The result is bit
+// for bit the one of YGRoundValueToPixelGrid. |forceCeil| and |forceFloor| hold one flag per value
+// and may be NULL when no value is forced.
+WIN_EXPORT void YGRoundValuesToPixelGrid(float *values, const uint32_t count,
+                                         const float pointScaleFactor, const bool *forceCeil,
+                                         const bool *forceFloor);
 
 YG_EXTERN_C_END
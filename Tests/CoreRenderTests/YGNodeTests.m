@@ -0,0 +1,985 @@
+@import CoreRender;
+@import XCTest;
+
+@interface YGNodeTests : XCTestCase
+@end
+
+static YGSize YGTestMeasureText(YGNodeRef node, float width, YGMeasureMode widthMode, float height,
+                                YGMeasureMode heightMode) {
+  const auto length = (float)(intptr_t)YGNodeGetContext(node);
+  auto measuredWidth = length * 7.5f;
+  auto lines = 1.0f;
+  if (widthMode != YGMeasureModeUndefined && measuredWidth > width) {
+    lines = floorf(measuredWidth / width) + 1;
+    measuredWidth = width;
+  }
+  return (YGSize){.width = measuredWidth, .height = lines * 17.0f};
+}
+
+// A text of |context| words of three 7.5 point characters, wrapped between words, so that a
+// wrapped text can be narrower than the width it was given.
+static YGSize YGTestMeasureWords(YGNodeRef node, float width, YGMeasureMode widthMode, float height,
+                                 YGMeasureMode heightMode) {
+  const auto words = (intptr_t)YGNodeGetContext(node);
+  const auto maxWidth = widthMode == YGMeasureModeUndefined ? INFINITY : width;
+  auto lineWidth = 0.0f;
+  auto measuredWidth = 0.0f;
+  auto lines = 1.0f;
+  for (intptr_t i = 0; i < words; i++) {
+    if (lineWidth > 0 && lineWidth + 30 > maxWidth) {
+      lines++;
+      lineWidth = 22.5f;
+    } else {
+      lineWidth += lineWidth > 0 ? 30 : 22.5f;
+    }
+    measuredWidth = fmaxf(measuredWidth, lineWidth);
+  }
+  if (widthMode == YGMeasureModeExactly) {
+    measuredWidth = width;
+  } else if (widthMode == YGMeasureModeAtMost) {
+    measuredWidth = fminf(measuredWidth, width);
+  }
+  return (YGSize){.width = measuredWidth, .height = lines * 17.0f};
+}
+
+// A row holding a row of two shrinking texts of |words| and |otherWords| words.
+static YGNodeRef YGTestNewWordsRow(YGConfigRef config, intptr_t words, intptr_t otherWords) {
+  const auto root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  const auto row = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+  const auto text = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexShrink(text, 1);
+  YGNodeSetContext(text, (void *)words);
+  YGNodeSetMeasureFunc(text, YGTestMeasureWords);
+  YGNodeInsertChild(row, text, 0);
+  const auto otherText = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexShrink(otherText, 1);
+  YGNodeStyleSetPadding(otherText, YGEdgeAll, 0.25f);
+  YGNodeSetContext(otherText, (void *)otherWords);
+  YGNodeSetMeasureFunc(otherText, YGTestMeasureWords);
+  YGNodeInsertChild(row, otherText, 1);
+  YGNodeInsertChild(root, row, 0);
+  return root;
+}
+
+static uint64_t YGTestMeasureKey(YGNodeRef node) {
+  return (uint64_t)(intptr_t)YGNodeGetContext(node);
+}
+
+// A header above a fixed-size card holding a text of |length| characters, all at fractional
+// offsets.
+static YGNodeRef YGTestNewCardTree(YGConfigRef config, intptr_t length) {
+  const auto root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetPadding(root, YGEdgeAll, 0.2f);
+  const auto header = YGNodeNewWithConfig(config);
+  YGNodeStyleSetHeight(header, 10.2f);
+  YGNodeInsertChild(root, header, 0);
+  const auto card = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(card, YGFlexDirectionRow);
+  YGNodeStyleSetWidth(card, 200);
+  YGNodeStyleSetHeight(card, 60);
+  YGNodeStyleSetPadding(card, YGEdgeAll, 8.2f);
+  const auto text = YGNodeNewWithConfig(config);
+  YGNodeSetContext(text, (void *)length);
+  YGNodeSetMeasureFunc(text, YGTestMeasureText);
+  YGNodeStyleSetFlexShrink(text, 1);
+  YGNodeInsertChild(card, text, 0);
+  YGNodeInsertChild(root, card, 1);
+  return root;
+}
+
+static int gYGTestBaselineCalls;
+
+static float YGTestMiddleBaseline(YGNodeRef node, float width, float height) {
+  gYGTestBaselineCalls++;
+  return height / 2;
+}
+
+static float YGTestBottomBaseline(YGNodeRef node, float width, float height) {
+  gYGTestBaselineCalls++;
+  return height;
+}
+
+typedef struct YGTestTrace {
+  uint32_t begins;
+  uint32_t openRequests;
+  uint32_t unbalancedEvents;
+  uint32_t cacheHits;
+} YGTestTrace;
+
+static void YGTestRecordTraceEvent(const YGTraceEvent *event, void *context) {
+  const auto trace = (YGTestTrace *)context;
+  if (!event->end) {
+    trace->begins++;
+    trace->openRequests++;
+  }
+  if (event->depth != trace->openRequests) {
+    trace->unbalancedEvents++;
+  }
+  if (event->end) {
+    trace->openRequests--;
+    trace->cacheHits += event->cacheOutcome != YGCacheOutcomeMiss;
+  }
+}
+
+@implementation YGNodeTests
+
+- (YGNodeRef)buildTreeWithConfig:(YGConfigRef)config {
+  return [self buildTreeWithConfig:config arena:NULL];
+}
+
+- (YGNodeRef)buildTreeWithConfig:(YGConfigRef)config arena:(YGArenaRef)arena {
+  YGNodeRef (^newNode)(void) = ^{
+    return arena != NULL ? YGNodeNewInArena(arena, config) : YGNodeNewWithConfig(config);
+  };
+  const auto root = newNode();
+  for (uint32_t i = 0; i < 50; i++) {
+    const auto row = newNode();
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetPadding(row, YGEdgeAll, 8);
+    const auto text = newNode();
+    YGNodeSetContext(text, (void *)(intptr_t)(10 + i * 7));
+    YGNodeSetMeasureFunc(text, YGTestMeasureText);
+    YGNodeStyleSetFlexShrink(text, 1);
+    YGNodeInsertChild(row, text, 0);
+    YGNodeInsertChild(root, row, i);
+  }
+  return root;
+}
+
+- (void)testConcurrentLayoutOfIndependentTreesMatchesSerialLayout {
+  const auto config = YGConfigNew();
+  const auto reference = [self buildTreeWithConfig:config];
+  YGNodeCalculateLayout(reference, 320, YGUndefined, YGDirectionLTR);
+  const auto expectedHeight = YGNodeLayoutGetHeight(reference);
+  YGNodeFreeRecursive(reference);
+
+  const size_t count = 16;
+  const auto heights = (float *)calloc(count, sizeof(float));
+  dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+    const auto root = [self buildTreeWithConfig:config];
+    const auto context = YGLayoutContextNew();
+    for (int pass = 0; pass < 20; pass++) {
+      YGNodeCalculateLayoutWithContext(root, pass % 2 ? 320 : 375, YGUndefined, YGDirectionLTR,
+                                       context);
+    }
+    heights[i] = YGNodeLayoutGetHeight(root);
+    YGLayoutContextFree(context);
+    YGNodeFreeRecursive(root);
+  });
+  for (size_t i = 0; i < count; i++) {
+    XCTAssertEqual(heights[i], expectedHeight);
+  }
+  free(heights);
+  YGConfigFree(config);
+}
+
+- (void)testArenaAllocatedTreeMatchesHeapTreeAndIsFreedAtOnce {
+  const auto config = YGConfigNew();
+  const auto instanceCount = YGNodeGetInstanceCount();
+  const auto heapRoot = [self buildTreeWithConfig:config];
+  YGNodeCalculateLayout(heapRoot, 320, YGUndefined, YGDirectionLTR);
+
+  const auto arena = YGArenaNew(101);
+  const auto arenaRoot = [self buildTreeWithConfig:config arena:arena];
+  YGNodeCalculateLayout(arenaRoot, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetHeight(arenaRoot), YGNodeLayoutGetHeight(heapRoot));
+
+  YGArenaFree(arena);
+  YGNodeFreeRecursive(heapRoot);
+  XCTAssertEqual(YGNodeGetInstanceCount(), instanceCount);
+  YGConfigFree(config);
+}
+
+- (void)testOutOfLineStyleIsCopiedAndOwnedPerNode {
+  const auto node = YGNodeNew();
+  YGNodeStyleSetBorder(node, YGEdgeLeft, 2);
+  YGNodeStyleSetPosition(node, YGEdgeTop, 10);
+
+  const auto clone = YGNodeClone(node);
+  YGNodeStyleSetPosition(clone, YGEdgeTop, 20);
+  XCTAssertEqual(YGNodeStyleGetPosition(node, YGEdgeTop).value, 10);
+  XCTAssertEqual(YGNodeStyleGetBorder(clone, YGEdgeLeft), 2);
+
+  const auto copy = YGNodeNew();
+  YGNodeCopyStyle(copy, node);
+  XCTAssertTrue(YGNodeIsDirty(copy));
+  XCTAssertEqual(YGNodeStyleGetBorder(copy, YGEdgeLeft), 2);
+  YGNodeReset(copy);
+  XCTAssertTrue(isnan(YGNodeStyleGetBorder(copy, YGEdgeLeft)));
+
+  YGNodeFree(copy);
+  YGNodeFree(clone);
+  YGNodeFree(node);
+}
+
+- (void)testEdgeShorthandsApplyUntilAnEdgeIsSetOrUnset {
+  const auto root = YGNodeNew();
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  const auto child = YGNodeNew();
+  YGNodeInsertChild(root, child, 0);
+  YGNodeStyleSetMargin(child, YGEdgeAll, 10);
+  YGNodeStyleSetMargin(child, YGEdgeHorizontal, 20);
+  YGNodeStyleSetMargin(child, YGEdgeStart, 30);
+
+  YGNodeCalculateLayout(root, 200, 100, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetLeft(child), 30);
+  XCTAssertEqual(YGNodeLayoutGetTop(child), 10);
+  XCTAssertEqual(YGNodeLayoutGetWidth(child), 0);
+
+  YGNodeStyleSetMargin(child, YGEdgeStart, YGUndefined);
+  YGNodeCalculateLayout(root, 200, 100, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetLeft(child), 20);
+  XCTAssertEqual(YGNodeStyleGetMargin(child, YGEdgeStart).unit, YGUnitUndefined);
+
+  YGNodeFreeRecursive(root);
+}
+
+- (void)testBatchedPixelGridRoundingMatchesScalarRounding {
+  float values[] = {0, 0.3f, 0.5f, 1.0f / 3, 2.0f / 3, -7.25f, 99.99995f, 1e9f, NAN, 10.1f, 3};
+  const uint32_t count = sizeof(values) / sizeof(values[0]);
+  const bool forceCeil[] = {false, false, false, true, false, true,
+                            false, false, false, false, false};
+  const bool forceFloor[] = {false, true,  false, false, true, false,
+                             false, false, false, true,  false};
+  float expected[sizeof(values) / sizeof(values[0])];
+  for (uint32_t i = 0; i < count; i++) {
+    expected[i] = YGRoundValueToPixelGrid(values[i], 3, forceCeil[i], forceFloor[i]);
+  }
+  YGRoundValuesToPixelGrid(values, count, 3, forceCeil, forceFloor);
+  XCTAssertEqual(memcmp(values, expected, sizeof(values)), 0);
+}
+
+- (void)testNodesWithTheSameMeasureKeyShareMeasurements {
+  const auto config = YGConfigNew();
+  const auto reference = [self buildTreeWithConfig:config];
+  YGNodeCalculateLayout(reference, 320, YGUndefined, YGDirectionLTR);
+
+  YGSharedMeasureCacheClear();
+  const auto root = [self buildTreeWithConfig:config];
+  const auto copy = [self buildTreeWithConfig:config];
+  for (uint32_t i = 0; i < YGNodeGetChildCount(root); i++) {
+    YGNodeSetMeasureKeyFunc(YGNodeGetChild(YGNodeGetChild(root, i), 0), YGTestMeasureKey);
+    YGNodeSetMeasureKeyFunc(YGNodeGetChild(YGNodeGetChild(copy, i), 0), YGTestMeasureKey);
+  }
+  YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  const auto misses = YGSharedMeasureCacheGetStats().misses;
+  YGNodeCalculateLayout(copy, 320, YGUndefined, YGDirectionLTR);
+  const auto stats = YGSharedMeasureCacheGetStats();
+  XCTAssertEqual(stats.misses, misses);
+  XCTAssertGreaterThan(stats.hits, 0);
+  XCTAssertEqual(YGNodeLayoutGetHeight(copy), YGNodeLayoutGetHeight(reference));
+
+  YGSharedMeasureCacheClear();
+  YGNodeFreeRecursive(copy);
+  YGNodeFreeRecursive(root);
+  YGNodeFreeRecursive(reference);
+  YGConfigFree(config);
+}
+
+- (void)testStyleUpdateMarksDirtyOnceAndOnlyIfStyleChanged {
+  const auto root = YGNodeNew();
+  const auto child = YGNodeNew();
+  YGNodeInsertChild(root, child, 0);
+  YGNodeStyleSetPadding(child, YGEdgeAll, 4);
+  YGNodeCalculateLayout(root, 100, 100, YGDirectionLTR);
+
+  YGNodeStyleBeginUpdate(child);
+  YGNodeStyleSetPadding(child, YGEdgeAll, 0);
+  YGNodeStyleSetPadding(child, YGEdgeAll, 4);
+  XCTAssertFalse(YGNodeIsDirty(root));
+  XCTAssertFalse(YGNodeStyleEndUpdate(child));
+  XCTAssertFalse(YGNodeIsDirty(root));
+
+  YGNodeStyleBeginUpdate(child);
+  YGNodeStyleSetWidth(child, 10);
+  YGNodeStyleSetPadding(child, YGEdgeLeft, 2);
+  XCTAssertFalse(YGNodeIsDirty(root));
+  XCTAssertTrue(YGNodeStyleEndUpdate(child));
+  XCTAssertTrue(YGNodeIsDirty(root));
+  YGNodeCalculateLayout(root, 100, 100, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetWidth(child), 10);
+
+  YGNodeFreeRecursive(root);
+}
+
+- (void)testLayoutStatsCountCacheHitsAndMeasureCalls {
+  const auto config = YGConfigNew();
+  const auto root = [self buildTreeWithConfig:config];
+  const auto cold = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertGreaterThanOrEqual(cold.nodesVisited, 151);
+  XCTAssertEqual(cold.layoutCacheHits, 0);
+  XCTAssertGreaterThan(cold.measureCalls, 0);
+  XCTAssertEqual(cold.maxDepth, 3);
+
+  const auto resized = YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  XCTAssertGreaterThan(resized.measureCalls, 0);
+  const auto warm = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(warm.measureCalls, 0);
+  XCTAssertGreaterThan(warm.measurementCacheHits, 0);
+
+  const auto clean = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(clean.nodesVisited, 1);
+  XCTAssertEqual(clean.layoutCacheHits, 1);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testLeastRecentlyUsedCacheKeepsMeasurementsAcrossAResizeSweep {
+  const auto config = YGConfigNew();
+  YGConfigSetMeasurementCacheEviction(config, YGCacheEvictionLeastRecentlyUsed);
+  YGConfigSetMeasurementCacheCapacity(config, 32, 4);
+  const auto root = [self buildTreeWithConfig:config];
+  float heights[20];
+  for (int i = 0; i < 20; i++) {
+    YGNodeCalculateLayout(root, 300 + i * 10, YGUndefined, YGDirectionLTR);
+    heights[i] = YGNodeLayoutGetHeight(root);
+  }
+  for (int i = 0; i < 20; i++) {
+    const auto stats = YGNodeCalculateLayout(root, 300 + i * 10, YGUndefined, YGDirectionLTR);
+    XCTAssertEqual(stats.measureCalls, 0);
+    XCTAssertEqual(YGNodeLayoutGetHeight(root), heights[i]);
+  }
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testMeasurementCacheIsSearchedInTheOrderItWasFilled {
+  const auto config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 2);
+  const auto root = YGTestNewWordsRow(config, 8, 8);
+  YGNodeCalculateLayout(root, 160, YGUndefined, YGDirectionLTR);
+  const auto row = YGNodeGetChild(root, 0);
+  const auto otherText = YGNodeGetChild(row, 1);
+  YGNodeSetContext(otherText, (void *)(intptr_t)4);
+  YGNodeMarkDirty(otherText);
+  YGNodeCalculateLayout(root, 160, YGUndefined, YGDirectionLTR);
+
+  // Several measurements of the first text are compatible with the new constraints. The one
+  // measured first is used, as in a layout from scratch.
+  const auto fresh = YGTestNewWordsRow(config, 8, 4);
+  YGNodeCalculateLayout(fresh, 160, YGUndefined, YGDirectionLTR);
+  const auto freshRow = YGNodeGetChild(fresh, 0);
+  for (uint32_t i = 0; i < 2; i++) {
+    const auto text = YGNodeGetChild(row, i);
+    const auto freshText = YGNodeGetChild(freshRow, i);
+    XCTAssertEqual(YGNodeLayoutGetLeft(text), YGNodeLayoutGetLeft(freshText));
+    XCTAssertEqual(YGNodeLayoutGetWidth(text), YGNodeLayoutGetWidth(freshText));
+    XCTAssertEqual(YGNodeLayoutGetHeight(text), YGNodeLayoutGetHeight(freshText));
+  }
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), YGNodeLayoutGetHeight(fresh));
+
+  YGNodeFreeRecursive(root);
+  YGNodeFreeRecursive(fresh);
+  YGConfigFree(config);
+}
+
+- (void)testChildrenKeepTheirOrderWhenTheySpillOutOfTheNode {
+  const auto root = YGNodeNew();
+  YGNodeRef children[6];
+  for (uint32_t i = 0; i < 6; i++) {
+    children[i] = YGNodeNew();
+    YGNodeStyleSetHeight(children[i], i + 1);
+    YGNodeInsertChild(root, children[i], i / 2);
+  }
+  YGNodeRemoveChild(root, children[0]);
+  XCTAssertEqual(YGNodeGetChildCount(root), 5);
+  XCTAssertEqual(YGNodeGetChild(root, 0), children[1]);
+  XCTAssertEqual(YGNodeGetChild(root, 2), children[5]);
+  XCTAssertEqual(YGNodeGetChild(root, 4), children[2]);
+  XCTAssertTrue(YGNodeGetChild(root, 5) == NULL);
+
+  const auto clone = YGNodeClone(root);
+  YGNodeRemoveChild(root, children[5]);
+  XCTAssertEqual(YGNodeGetChildCount(clone), 5);
+  XCTAssertEqual(YGNodeGetChild(clone, 2), children[5]);
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), 2 + 4 + 5 + 3);
+
+  YGNodeRemoveAllChildren(clone);
+  YGNodeFree(clone);
+  YGNodeFreeRecursive(root);
+  YGNodeFree(children[0]);
+  YGNodeFree(children[5]);
+}
+
+- (void)testSnapshotIsLaidOutWhileTheTreeIsEditedAndSharesUneditedNodes {
+  const auto config = YGConfigNew();
+  const auto instanceCount = YGNodeGetInstanceCount();
+  const auto root = [self buildTreeWithConfig:config];
+  const auto text = YGNodeGetChild(YGNodeGetChild(root, 0), 0);
+  const auto snapshot = YGSnapshotNew(root);
+  const auto version = YGSnapshotCapture(snapshot);
+
+  const auto group = dispatch_group_create();
+  dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+    YGNodeCalculateLayout(version, 320, YGUndefined, YGDirectionLTR);
+  });
+  YGNodeSetContext(text, (void *)(intptr_t)200);
+  YGNodeMarkDirty(text);
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+  YGSnapshotCommit(snapshot);
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), YGNodeLayoutGetHeight(version));
+  XCTAssertTrue(YGNodeIsDirty(root));
+
+  const auto untouchedRow = YGNodeGetChild(version, 1);
+  const auto nodeCount = YGNodeGetInstanceCount();
+  const auto nextVersion = YGSnapshotCapture(snapshot);
+  XCTAssertEqual(YGNodeGetChild(nextVersion, 1), untouchedRow);
+  XCTAssertEqual(YGNodeGetInstanceCount(), nodeCount);
+  YGNodeCalculateLayout(nextVersion, 320, YGUndefined, YGDirectionLTR);
+  YGSnapshotCommit(snapshot);
+  XCTAssertFalse(YGNodeIsDirty(root));
+  XCTAssertEqual(YGNodeLayoutGetHeight(YGNodeGetChild(root, 0)), 17 * 5 + 16);
+
+  YGSnapshotFree(snapshot);
+  YGNodeFreeRecursive(root);
+  XCTAssertEqual(YGNodeGetInstanceCount(), instanceCount);
+  YGConfigFree(config);
+}
+
+- (void)testPersistedLayoutIsRestoredOnlyForTheSameTreeAndConstraints {
+  const auto config = YGConfigNew();
+  YGNodeRef roots[2];
+  for (int i = 0; i < 2; i++) {
+    roots[i] = [self buildTreeWithConfig:config];
+    for (uint32_t j = 0; j < YGNodeGetChildCount(roots[i]); j++) {
+      YGNodeSetMeasureKeyFunc(YGNodeGetChild(YGNodeGetChild(roots[i], j), 0), YGTestMeasureKey);
+    }
+  }
+  YGNodeCalculateLayout(roots[0], 320, YGUndefined, YGDirectionLTR);
+  const auto size = YGNodeWritePersistedLayout(roots[0], 320, YGUndefined, YGDirectionLTR, NULL, 0);
+  const auto data = [NSMutableData dataWithLength:size];
+  XCTAssertEqual(YGNodeWritePersistedLayout(roots[0], 320, YGUndefined, YGDirectionLTR,
+                                            data.mutableBytes, size),
+                 size);
+
+  XCTAssertFalse(YGNodeRestorePersistedLayout(roots[1], 375, YGUndefined, YGDirectionLTR,
+                                              data.bytes, size));
+  XCTAssertFalse(YGNodeRestorePersistedLayout(roots[1], 320, YGUndefined, YGDirectionLTR,
+                                              data.bytes, size - 1));
+  const auto text = YGNodeGetChild(YGNodeGetChild(roots[1], 0), 0);
+  YGNodeSetContext(text, (void *)(intptr_t)200);
+  XCTAssertFalse(YGNodeRestorePersistedLayout(roots[1], 320, YGUndefined, YGDirectionLTR,
+                                              data.bytes, size));
+  YGNodeSetContext(text, (void *)(intptr_t)10);
+
+  YGConfigSetPersistedLayout(config, data.bytes, size);
+  const auto stats = YGNodeCalculateLayout(roots[1], 320, YGUndefined, YGDirectionLTR);
+  YGConfigSetPersistedLayout(config, NULL, 0);
+  XCTAssertEqual(stats.measureCalls, 0);
+  XCTAssertFalse(YGNodeIsDirty(roots[1]));
+  XCTAssertEqual(YGNodeLayoutGetHeight(roots[1]), YGNodeLayoutGetHeight(roots[0]));
+  XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(roots[1], 49)),
+                 YGNodeLayoutGetTop(YGNodeGetChild(roots[0], 49)));
+
+  YGNodeFreeRecursive(roots[0]);
+  YGNodeFreeRecursive(roots[1]);
+  YGConfigFree(config);
+}
+
+- (void)testBaselinesAreOnlyAskedForAgainWhenTheirLayoutChanges {
+  const auto config = YGConfigNew();
+  const auto row = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+  YGNodeStyleSetAlignItems(row, YGAlignBaseline);
+  YGNodeStyleSetHeight(row, 100);
+  for (uint32_t i = 0; i < 3; i++) {
+    const auto text = YGNodeNewWithConfig(config);
+    YGNodeSetContext(text, (void *)(intptr_t)(4 + i * 4));
+    YGNodeSetMeasureFunc(text, YGTestMeasureText);
+    YGNodeSetBaselineFunc(text, YGTestMiddleBaseline);
+    YGNodeInsertChild(row, text, i);
+  }
+  gYGTestBaselineCalls = 0;
+  YGNodeCalculateLayout(row, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(gYGTestBaselineCalls, 3);
+
+  gYGTestBaselineCalls = 0;
+  const auto wrapped = YGNodeGetChild(row, 0);
+  YGNodeSetContext(wrapped, (void *)(intptr_t)60);
+  YGNodeMarkDirty(wrapped);
+  YGNodeCalculateLayout(row, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(gYGTestBaselineCalls, 1);
+  XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(row, 1)), 8);
+  XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(row, 2)), 8);
+
+  gYGTestBaselineCalls = 0;
+  YGNodeSetBaselineFunc(YGNodeGetChild(row, 2), YGTestBottomBaseline);
+  YGNodeMarkDirty(YGNodeGetChild(row, 1));
+  YGNodeCalculateLayout(row, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(gYGTestBaselineCalls, 2);
+  XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(row, 2)), 0);
+
+  YGNodeFreeRecursive(row);
+  YGConfigFree(config);
+}
+
+- (void)testTraceEventsNestLikeTheRequestsOfThePass {
+  const auto config = YGConfigNew();
+  const auto root = [self buildTreeWithConfig:config];
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+
+  YGTestTrace trace = {0, 0, 0, 0};
+  YGConfigSetTraceFunc(config, YGTestRecordTraceEvent, &trace);
+  const auto stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  YGConfigSetTraceFunc(config, NULL, NULL);
+  XCTAssertEqual(trace.begins, stats.nodesVisited);
+  XCTAssertEqual(trace.openRequests, 0);
+  XCTAssertEqual(trace.unbalancedEvents, 0);
+  XCTAssertEqual(trace.cacheHits, stats.layoutCacheHits + stats.measurementCacheHits);
+
+  const auto path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"yoga-trace.json"];
+  const auto file = fopen(path.fileSystemRepresentation, "w");
+  const auto writer = YGChromeTraceWriterNew(file);
+  YGConfigSetTraceFunc(config, YGChromeTraceWriterTrace, writer);
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  YGConfigSetTraceFunc(config, NULL, NULL);
+  YGChromeTraceWriterFree(writer);
+  fclose(file);
+  const auto json = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:path]
+                                                    options:0
+                                                      error:NULL];
+  const auto events = (NSArray<NSDictionary *> *)json[@"traceEvents"];
+  XCTAssertGreaterThan(events.count, 0);
+  XCTAssertEqual(events.count % 2, 0);
+  XCTAssertEqualObjects(events.firstObject[@"name"], @"initial");
+  XCTAssertEqualObjects(events.firstObject[@"ph"], @"B");
+  XCTAssertEqualObjects(events.lastObject[@"ph"], @"E");
+  [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testBatchLayoutSizesEveryRootLikeItsOwnPass {
+  const auto config = YGConfigNew();
+  const uint32_t count = 40;
+  YGNodeRef roots[count];
+  YGNodeRef references[count];
+  YGLayoutConstraints constraints[count];
+  for (uint32_t i = 0; i < count; i++) {
+    roots[i] = [self buildTreeWithConfig:config];
+    references[i] = [self buildTreeWithConfig:config];
+    constraints[i] = (YGLayoutConstraints){
+        .availableWidth = 200.0f + i * 10,
+        .availableHeight = YGUndefined,
+        .direction = YGDirectionLTR,
+    };
+  }
+  YGSize sizes[count];
+  const auto stats = YGNodeCalculateLayoutBatch(roots, constraints, sizes, count);
+
+  uint32_t nodesVisited = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    nodesVisited += YGNodeCalculateLayout(references[i], constraints[i].availableWidth,
+                                          YGUndefined, YGDirectionLTR)
+                        .nodesVisited;
+    XCTAssertEqual(sizes[i].width, YGNodeLayoutGetWidth(references[i]));
+    XCTAssertEqual(sizes[i].height, YGNodeLayoutGetHeight(references[i]));
+    XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(roots[i], 49)),
+                   YGNodeLayoutGetTop(YGNodeGetChild(references[i], 49)));
+    YGNodeFreeRecursive(roots[i]);
+    YGNodeFreeRecursive(references[i]);
+  }
+  XCTAssertEqual(stats.nodesVisited, nodesVisited);
+  YGConfigFree(config);
+}
+
+- (void)testLayoutJournalListsOnlyTheNodesWhoseFrameChanged {
+  const auto config = YGConfigNew();
+  const auto root = [self buildTreeWithConfig:config];
+  const auto context = YGLayoutContextNew();
+  const auto journal = YGLayoutJournalNew();
+  YGLayoutContextSetJournal(context, journal);
+  YGNodeCalculateLayoutWithContext(root, 320, YGUndefined, YGDirectionLTR, context);
+  XCTAssertEqual(YGLayoutJournalGetCount(journal), 101);
+  YGNodeCalculateLayoutWithContext(root, 320, YGUndefined, YGDirectionLTR, context);
+  XCTAssertEqual(YGLayoutJournalGetCount(journal), 0);
+
+  // The text wraps on more lines: its row grows and every row below it moves down.
+  const auto row = YGNodeGetChild(root, 10);
+  const auto text = YGNodeGetChild(row, 0);
+  YGNodeSetContext(text, (void *)(intptr_t)200);
+  YGNodeMarkDirty(text);
+  YGNodeCalculateLayoutWithContext(root, 320, YGUndefined, YGDirectionLTR, context);
+  XCTAssertEqual(YGLayoutJournalGetCount(journal), 3 + 39);
+  XCTAssertEqual(YGLayoutJournalGetNode(journal, 0), root);
+  XCTAssertEqual(YGLayoutJournalGetNode(journal, 1), row);
+  XCTAssertEqual(YGLayoutJournalGetNode(journal, 2), text);
+  XCTAssertEqual(YGLayoutJournalGetNode(journal, 3), YGNodeGetChild(root, 11));
+
+  // Passes without the journal are compared by the next one that has it.
+  YGNodeCalculateLayout(root, 375, YGUndefined, YGDirectionLTR);
+  YGNodeCalculateLayoutWithContext(root, 320, YGUndefined, YGDirectionLTR, context);
+  XCTAssertEqual(YGLayoutJournalGetCount(journal), 0);
+
+  YGLayoutJournalFree(journal);
+  YGLayoutContextFree(context);
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testUniformGridIsPlacedWithoutLayingOutEveryCell {
+  const auto config = YGConfigNew();
+  const auto grid = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(grid, YGFlexDirectionRow);
+  YGNodeStyleSetFlexWrap(grid, YGWrapWrap);
+  YGNodeStyleSetPadding(grid, YGEdgeAll, 2);
+  for (uint32_t i = 0; i < 10; i++) {
+    const auto cell = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(cell, 90);
+    YGNodeStyleSetHeight(cell, 90);
+    YGNodeStyleSetMargin(cell, YGEdgeAll, 1);
+    YGNodeInsertChild(grid, cell, i);
+  }
+
+  // Four cells of 92 points fit on each line: only the grid and its first cell are visited.
+  auto stats = YGNodeCalculateLayout(grid, 375, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.nodesVisited, 2);
+  XCTAssertEqual(YGNodeLayoutGetHeight(grid), 280);
+  const auto cell = YGNodeGetChild(grid, 5);
+  XCTAssertEqual(YGNodeLayoutGetLeft(cell), 95);
+  XCTAssertEqual(YGNodeLayoutGetTop(cell), 95);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(grid, 9)), 90);
+  XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(grid, 9)), 187);
+
+  // A cell styled apart from its siblings sends the grid through the general steps, which
+  // place every cell in the same spot.
+  YGNodeStyleSetAlignSelf(YGNodeGetChild(grid, 9), YGAlignStretch);
+  stats = YGNodeCalculateLayout(grid, 375, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.nodesVisited, 11);
+  XCTAssertEqual(YGNodeLayoutGetHeight(grid), 280);
+  XCTAssertEqual(YGNodeLayoutGetLeft(cell), 95);
+  XCTAssertEqual(YGNodeLayoutGetTop(cell), 95);
+  XCTAssertEqual(YGNodeLayoutGetTop(YGNodeGetChild(grid, 9)), 187);
+
+  YGNodeFreeRecursive(grid);
+  YGConfigFree(config);
+}
+
+- (void)testStackWithoutFlexibleItemsKeepsEveryItemAtItsFlexBasis {
+  const auto config = YGConfigNew();
+  const auto stack = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(stack, YGFlexDirectionRow);
+  YGNodeStyleSetWidth(stack, 100);
+  for (uint32_t i = 0; i < 3; i++) {
+    const auto item = YGNodeNewWithConfig(config);
+    YGNodeStyleSetWidth(item, 40 + 10 * i);
+    YGNodeInsertChild(stack, item, i);
+  }
+  YGNodeStyleSetMinWidth(YGNodeGetChild(stack, 0), 45);
+  const auto last = YGNodeGetChild(stack, 2);
+
+  // Nothing shrinks: the items overflow the stack, the first one clamped to its min width.
+  YGNodeCalculateLayout(stack, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(stack, 0)), 45);
+  XCTAssertEqual(YGNodeLayoutGetLeft(YGNodeGetChild(stack, 1)), 45);
+  XCTAssertEqual(YGNodeLayoutGetLeft(last), 95);
+  XCTAssertEqual(YGNodeLayoutGetWidth(last), 60);
+  XCTAssertTrue(YGNodeLayoutGetHadOverflow(stack));
+
+  // Once an item can shrink, the line goes through the flexible length resolution again.
+  YGNodeStyleSetFlexShrink(last, 1);
+  YGNodeCalculateLayout(stack, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetLeft(last), 95);
+  XCTAssertEqual(YGNodeLayoutGetWidth(last), 5);
+  XCTAssertFalse(YGNodeLayoutGetHadOverflow(stack));
+
+  YGNodeFreeRecursive(stack);
+  YGConfigFree(config);
+}
+
+- (void)testSpecFlexibleLengthsRefreezeItemsClampedByTheRedistributedSpace {
+  const auto legacyConfig = YGConfigNew();
+  const auto specConfig = YGConfigNew();
+  YGConfigSetExperimentalFeatureEnabled(specConfig, YGExperimentalFeatureSpecFlexibleLengths,
+                                        true);
+  const float maxWidths[] = {40, 120, YGUndefined};
+  YGNodeRef rows[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    rows[i] = YGNodeNewWithConfig(i == 0 ? legacyConfig : specConfig);
+    YGNodeStyleSetFlexDirection(rows[i], YGFlexDirectionRow);
+    YGNodeStyleSetWidth(rows[i], 300);
+    YGNodeStyleSetHeight(rows[i], 20);
+    for (uint32_t j = 0; j < 3; j++) {
+      const auto item = YGNodeNewWithConfig(i == 0 ? legacyConfig : specConfig);
+      YGNodeStyleSetFlexBasis(item, 0);
+      YGNodeStyleSetFlexGrow(item, 1);
+      YGNodeStyleSetMaxWidth(item, maxWidths[j]);
+      YGNodeInsertChild(rows[i], item, j);
+    }
+    YGNodeCalculateLayout(rows[i], YGUndefined, YGUndefined, YGDirectionLTR);
+  }
+
+  // The two-pass resolution only freezes the first item: the second one is clamped to its max
+  // width in the second pass, and the space it gives back is left unfilled.
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(rows[0], 0)), 40);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(rows[0], 1)), 120);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(rows[0], 2)), 130);
+
+  // The loop of the spec freezes the second item in a second round and gives its space to the
+  // last one.
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(rows[1], 0)), 40);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(rows[1], 1)), 120);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(rows[1], 2)), 140);
+  XCTAssertEqual(YGNodeLayoutGetLeft(YGNodeGetChild(rows[1], 2)), 160);
+
+  YGNodeFreeRecursive(rows[0]);
+  YGNodeFreeRecursive(rows[1]);
+  YGConfigFree(legacyConfig);
+  YGConfigFree(specConfig);
+}
+
+- (void)testStretchedChildrenAreLaidOutOnceAtTheirStretchedSize {
+  const auto config = YGConfigNew();
+  const auto stack = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(stack, 300);
+  YGNodeStyleSetHeight(stack, 200);
+  for (uint32_t i = 0; i < 3; i++) {
+    const auto row = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+    YGNodeStyleSetHeight(row, 20);
+    YGNodeStyleSetMargin(row, YGEdgeHorizontal, 10);
+    const auto label = YGNodeNewWithConfig(config);
+    YGNodeStyleSetFlexGrow(label, 1);
+    YGNodeInsertChild(row, label, 0);
+    YGNodeInsertChild(stack, row, i);
+  }
+
+  // Every row is stretched across the stack and every label across its row.
+  auto stats = YGNodeCalculateLayout(stack, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.stretchLayoutsAvoided, 6);
+  const auto row = YGNodeGetChild(stack, 2);
+  XCTAssertEqual(YGNodeLayoutGetLeft(row), 10);
+  XCTAssertEqual(YGNodeLayoutGetTop(row), 40);
+  XCTAssertEqual(YGNodeLayoutGetWidth(row), 280);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(row, 0)), 280);
+  XCTAssertEqual(YGNodeLayoutGetHeight(YGNodeGetChild(row, 0)), 20);
+
+  // The lines of a wrapping stack are only sized in STEP 8, so its rows are laid out again.
+  YGNodeStyleSetFlexWrap(stack, YGWrapWrap);
+  stats = YGNodeCalculateLayout(stack, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.stretchLayoutsAvoided, 0);
+  XCTAssertEqual(YGNodeLayoutGetWidth(YGNodeGetChild(row, 0)), 280);
+
+  YGNodeFreeRecursive(stack);
+  YGConfigFree(config);
+}
+
+- (void)testStretchedChildReportsItsOverflowToItsParent {
+  const auto config = YGConfigNew();
+  const auto stack = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(stack, 100);
+  YGNodeStyleSetHeight(stack, 100);
+  const auto row = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(row, YGFlexDirectionRow);
+  YGNodeStyleSetHeight(row, 20);
+  const auto wide = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(wide, 150);
+  YGNodeInsertChild(row, wide, 0);
+  YGNodeInsertChild(stack, row, 0);
+
+  // The row is laid out at the width of the stack, which its content overflows.
+  YGNodeCalculateLayout(stack, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetWidth(row), 100);
+  XCTAssertTrue(YGNodeLayoutGetHadOverflow(row));
+  XCTAssertTrue(YGNodeLayoutGetHadOverflow(stack));
+
+  YGNodeFreeRecursive(stack);
+  YGConfigFree(config);
+}
+
+- (void)testRootAnsweredByItsLayoutCacheKeepsItsRoundedSize {
+  const auto config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 2);
+  const auto root = YGNodeNewWithConfig(config);
+  const auto child = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(child, 10.3f);
+  YGNodeStyleSetHeight(child, 20.2f);
+  YGNodeInsertChild(root, child, 0);
+  YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetWidth(root), 10.5f);
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), 20);
+
+  const auto stats = YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.layoutCacheHits, 1);
+  XCTAssertEqual(YGNodeLayoutGetWidth(root), 10.5f);
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), 20);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testDirtyContentOfAFixedSizeNodeOnlyLaysOutThatNode {
+  const auto config = YGConfigNew();
+  const auto root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetPadding(root, YGEdgeAll, 10);
+  const auto header = YGNodeNewWithConfig(config);
+  YGNodeSetContext(header, (void *)(intptr_t)12);
+  YGNodeSetMeasureFunc(header, YGTestMeasureText);
+  YGNodeInsertChild(root, header, 0);
+  const auto card = YGNodeNewWithConfig(config);
+  YGNodeStyleSetFlexDirection(card, YGFlexDirectionRow);
+  YGNodeStyleSetWidth(card, 200);
+  YGNodeStyleSetHeight(card, 60);
+  YGNodeStyleSetPadding(card, YGEdgeAll, 8);
+  const auto text = YGNodeNewWithConfig(config);
+  YGNodeSetContext(text, (void *)(intptr_t)10);
+  YGNodeSetMeasureFunc(text, YGTestMeasureText);
+  YGNodeStyleSetFlexShrink(text, 1);
+  YGNodeInsertChild(card, text, 0);
+  YGNodeInsertChild(root, card, 1);
+  auto stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  const auto nodesVisited = stats.nodesVisited;
+  XCTAssertEqual(stats.relayoutBoundaries, 0);
+  XCTAssertEqual(YGNodeLayoutGetWidth(text), 75);
+
+  // The card keeps its size whatever its text, so the dirt stops there.
+  YGNodeSetContext(text, (void *)(intptr_t)40);
+  YGNodeMarkDirty(text);
+  XCTAssertTrue(YGNodeIsDirty(card));
+  XCTAssertFalse(YGNodeIsDirty(root));
+  stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.relayoutBoundaries, 1);
+  XCTAssertLessThan(stats.nodesVisited, nodesVisited);
+  XCTAssertEqual(YGNodeLayoutGetWidth(text), 184);
+  XCTAssertEqual(YGNodeLayoutGetTop(card), 27);
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), 97);
+  XCTAssertFalse(YGNodeIsDirty(card));
+
+  // Resizing the card still lays out the nodes above it.
+  YGNodeStyleSetHeight(card, 80);
+  XCTAssertTrue(YGNodeIsDirty(root));
+  stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.relayoutBoundaries, 0);
+  XCTAssertEqual(YGNodeLayoutGetHeight(root), 117);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testStyleEditBelowAHiddenNodeDirtiesItsAncestors {
+  const auto config = YGConfigNew();
+  const auto root = YGNodeNewWithConfig(config);
+  const auto hidden = YGNodeNewWithConfig(config);
+  YGNodeStyleSetDisplay(hidden, YGDisplayNone);
+  const auto text = YGNodeNewWithConfig(config);
+  YGNodeSetContext(text, (void *)(intptr_t)10);
+  YGNodeSetMeasureFunc(text, YGTestMeasureText);
+  YGNodeInsertChild(hidden, text, 0);
+  YGNodeInsertChild(root, hidden, 0);
+  YGNodeMarkDirty(text);
+
+  // The pass skips the subtree of the hidden node, so the text stays dirty.
+  YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertTrue(YGNodeIsDirty(text));
+  XCTAssertFalse(YGNodeIsDirty(root));
+
+  YGNodeStyleSetWidth(text, 50);
+  XCTAssertTrue(YGNodeIsDirty(hidden));
+  XCTAssertTrue(YGNodeIsDirty(root));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testRelayoutBoundaryIsRoundedLikeAFreshLayout {
+  const auto config = YGConfigNew();
+  YGConfigSetPointScaleFactor(config, 3);
+  const auto root = YGTestNewCardTree(config, 10);
+  YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  const auto card = YGNodeGetChild(root, 1);
+  const auto text = YGNodeGetChild(card, 0);
+  YGNodeSetContext(text, (void *)(intptr_t)40);
+  YGNodeMarkDirty(text);
+  const auto stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.relayoutBoundaries, 1);
+
+  // The card is rounded from where it was before rounding, not from its rounded frame.
+  const auto fresh = YGTestNewCardTree(config, 40);
+  YGNodeCalculateLayout(fresh, 320, YGUndefined, YGDirectionLTR);
+  const YGNodeRef nodes[] = {root, card, text};
+  const YGNodeRef freshNodes[] = {fresh, YGNodeGetChild(fresh, 1),
+                                  YGNodeGetChild(YGNodeGetChild(fresh, 1), 0)};
+  for (uint32_t i = 0; i < 3; i++) {
+    XCTAssertEqual(YGNodeLayoutGetLeft(nodes[i]), YGNodeLayoutGetLeft(freshNodes[i]));
+    XCTAssertEqual(YGNodeLayoutGetTop(nodes[i]), YGNodeLayoutGetTop(freshNodes[i]));
+    XCTAssertEqual(YGNodeLayoutGetWidth(nodes[i]), YGNodeLayoutGetWidth(freshNodes[i]));
+    XCTAssertEqual(YGNodeLayoutGetHeight(nodes[i]), YGNodeLayoutGetHeight(freshNodes[i]));
+  }
+  XCTAssertEqualWithAccuracy(YGNodeLayoutGetWidth(text), 183.667f, 0.001f);
+
+  YGNodeFreeRecursive(root);
+  YGNodeFreeRecursive(fresh);
+  YGConfigFree(config);
+}
+
+- (void)testFixedSizeNodeWhoseBaselineIsReadIsNotARelayoutBoundary {
+  const auto config = YGConfigNew();
+  const auto root = YGTestNewCardTree(config, 10);
+  YGNodeStyleSetFlexDirection(root, YGFlexDirectionRow);
+  YGNodeStyleSetAlignItems(root, YGAlignBaseline);
+  YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  const auto card = YGNodeGetChild(root, 1);
+  const auto text = YGNodeGetChild(card, 0);
+
+  // The root aligns the card by the baseline of its text, so the dirt goes up.
+  YGNodeSetContext(text, (void *)(intptr_t)40);
+  YGNodeMarkDirty(text);
+  XCTAssertTrue(YGNodeIsDirty(root));
+  auto stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.relayoutBoundaries, 0);
+
+  // With a baseline of its own the card no longer depends on its text.
+  YGNodeSetBaselineFunc(card, YGTestMiddleBaseline);
+  YGNodeSetContext(text, (void *)(intptr_t)20);
+  YGNodeMarkDirty(text);
+  XCTAssertFalse(YGNodeIsDirty(root));
+  stats = YGNodeCalculateLayout(root, 320, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(stats.relayoutBoundaries, 1);
+
+  YGNodeSetBaselineFunc(card, NULL);
+  YGNodeSetContext(text, (void *)(intptr_t)30);
+  YGNodeMarkDirty(text);
+  XCTAssertTrue(YGNodeIsDirty(root));
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+- (void)testRootAnsweredByItsLayoutCacheMovesWithTheSizeOfItsParent {
+  const auto config = YGConfigNew();
+  const auto root = YGNodeNewWithConfig(config);
+  YGNodeStyleSetMaxWidth(root, 50);
+  YGNodeStyleSetHeight(root, 50);
+  YGNodeStyleSetMarginPercent(root, YGEdgeLeft, 10);
+  const auto box = YGNodeNewWithConfig(config);
+  YGNodeStyleSetWidth(box, 20);
+  YGNodeStyleSetHeight(box, 20);
+  const auto leaf = YGNodeNewWithConfig(config);
+  YGNodeInsertChild(box, leaf, 0);
+  YGNodeInsertChild(root, box, 0);
+  YGNodeCalculateLayout(root, 100, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetLeft(root), 10);
+
+  // The edit stops at the box, so the root is answered by its cache but has to move.
+  YGNodeStyleSetFlexGrow(leaf, 1);
+  XCTAssertFalse(YGNodeIsDirty(root));
+  YGNodeCalculateLayout(root, 300, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetLeft(root), 30);
+  XCTAssertEqual(YGNodeLayoutGetWidth(root), 20);
+  XCTAssertEqual(YGNodeLayoutGetHeight(leaf), 20);
+
+  // A clean root moves as well.
+  YGNodeCalculateLayout(root, 200, YGUndefined, YGDirectionLTR);
+  XCTAssertEqual(YGNodeLayoutGetLeft(root), 20);
+
+  YGNodeFreeRecursive(root);
+  YGConfigFree(config);
+}
+
+@end
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Builds and runs the Yoga benchmarks in Benchmarks/ against Sources/CoreRender/Yoga.c.
+# They only need a C compiler and pthreads, so they also run on Linux.
+#
+# usage: ./bench_yoga.sh [benchmark name] [benchmark arguments...]
+set -e
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:-"-O2 -DNDEBUG"}
+BUILD_DIR=_bench_build
+
+mkdir -p $BUILD_DIR
+for SOURCE in Benchmarks/*.c; do
+  NAME=$(basename $SOURCE .c)
+  if [ -n "$1" ] && [ "$1" != "$NAME" ]; then
+    continue
+  fi
+  echo "Running $NAME..."
+  $CC $CFLAGS -std=gnu99 -I Sources/CoreRender -I Benchmarks \
+    Sources/CoreRender/Yoga.c $SOURCE -o $BUILD_DIR/$NAME -lm -lpthread
+  ./$BUILD_DIR/$NAME "${@:2}"
+done